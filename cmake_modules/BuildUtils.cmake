@@ -43,3 +43,33 @@ function(ADD_TEST_CASE TEST_NAME)
 
   add_test(NAME ${TEST_NAME} COMMAND $<TARGET_FILE:${TEST_NAME}>)
 endfunction()
+
+# Add a new benchmark executable linked against Google Benchmark.
+#
+# BENCHMARK_NAME is the name of the benchmark.
+#
+# SOURCES is the list of C++ source files to compile into the benchmark
+# executable.
+function(ADD_BENCHMARK_CASE BENCHMARK_NAME)
+  set(multi_value_args SOURCES EXTRA_LINK_LIBS)
+  cmake_parse_arguments(ARG "${options}" "${one_value_args}"
+                        "${multi_value_args}" ${ARGN})
+  if(ARG_UNPARSED_ARGUMENTS)
+    message(
+      SEND_ERROR "Error: unrecognized arguments: ${ARG_UNPARSED_ARGUMENTS}")
+  endif()
+
+  if(NOT ARG_SOURCES)
+    message(
+      SEND_ERROR "Error: SOURCES is a required argument to add_benchmark_case")
+  endif()
+
+  find_package(benchmark REQUIRED)
+
+  add_executable(${BENCHMARK_NAME} ${ARG_SOURCES})
+  set_target_properties(
+    ${BENCHMARK_NAME} PROPERTIES RUNTIME_OUTPUT_DIRECTORY
+                                 ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/benchmarks)
+  target_link_libraries(${BENCHMARK_NAME} PRIVATE ${ARG_EXTRA_LINK_LIBS}
+                                                  benchmark::benchmark_main)
+endfunction()
@@ -0,0 +1,24 @@
+# SPDX-License-Identifier: Apache-2.0
+
+# Convert a binary file into a C++ byte array, run as a script:
+#
+#   cmake -DINPUT=<file> -DOUTPUT=<file> -DVARIABLE=<name> -P EmbedFile.cmake
+#
+# The output defines `alignas(8) constexpr unsigned char <name>[]` holding the
+# bytes of the input file.
+
+if(NOT INPUT OR NOT OUTPUT OR NOT VARIABLE)
+  message(FATAL_ERROR "INPUT, OUTPUT and VARIABLE are required")
+endif()
+
+file(READ ${INPUT} CONTENT HEX)
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${CONTENT}")
+# Break the array into lines of 16 bytes.
+string(REGEX REPLACE "((0x[0-9a-f][0-9a-f],){16})" "\\1\n    " BYTES
+                     "${BYTES}")
+get_filename_component(INPUT_NAME ${INPUT} NAME)
+
+file(
+  WRITE ${OUTPUT}
+  "// Generated from ${INPUT_NAME} by EmbedFile.cmake, do not edit.\n"
+  "alignas(8) constexpr unsigned char ${VARIABLE}[] = {\n    ${BYTES}};\n")
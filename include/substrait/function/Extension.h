@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -13,6 +15,13 @@
 
 namespace io::substrait {
 
+/// Kinds of functions declared by an extension.
+enum class FunctionKind : uint8_t {
+  kScalar,
+  kAggregate,
+  kWindow,
+};
+
 struct TypeVariant {
   std::string name;
   std::string uri;
@@ -25,8 +34,38 @@ using FunctionImplMap =
 
 using TypeVariantMap = std::unordered_map<std::string, TypeVariantPtr>;
 
+/// Decodes the implementations of the functions of a lazily loaded
+/// extension, e.g. from a snapshot, on their first lookup.
+class FunctionImplSource {
+ public:
+  virtual ~FunctionImplSource() = default;
+
+  /// Decode the implementations of a function stored at the given location
+  /// of this source, appending them to impls in registration order.
+  virtual void decode(
+      FunctionKind kind,
+      const std::string& name,
+      uint64_t offset,
+      uint64_t size,
+      std::vector<FunctionImplementationPtr>& impls) const = 0;
+};
+
 class Extension {
  public:
+  /// Runs a task, either inline or on a thread of its own.
+  using Executor = std::function<void(std::function<void()>)>;
+
+  /// Names of the default substrait extension files.
+  static const std::vector<std::string>& defaultExtensionFiles();
+
+  /// The default substrait extension compiled into the library, which needs
+  /// no access to the extension files. The same lazily decoded extension is
+  /// returned by every call, the uris of its functions are relative paths
+  /// such as extensions/functions_arithmetic.yaml.
+  /// @throws SubstraitException if the library is built without
+  /// SUBSTRAIT_CPP_EMBED_DEFAULT_EXTENSIONS.
+  static std::shared_ptr<const Extension> loadDefault();
+
   /// Deserialize default substrait extension by given basePath
   /// @throws exception if file not found
   static std::shared_ptr<Extension> load(const std::string& basePath);
@@ -40,6 +79,36 @@ class Extension {
   static std::shared_ptr<Extension> load(
       const std::vector<std::string>& extensionFiles);
 
+  /// Deserialize substrait extension by given extensionFiles, parsing each
+  /// file as a task of the given executor. The partial extensions of the
+  /// files are merged in the order of extensionFiles, so the result is the
+  /// same as the one of the serial load. Blocks until all tasks are done.
+  /// @param executor runs the parse tasks, if empty they run on up to
+  /// std::thread::hardware_concurrency() threads owned by the call.
+  /// @throws the exception of the first file in extensionFiles which failed.
+  static std::shared_ptr<Extension> load(
+      const std::vector<std::string>& extensionFiles,
+      const Executor& executor);
+
+  /// Load extension files lazily: a pre-scan of each file indexes its
+  /// functions by name and the byte range of their declaration, the
+  /// implementations of a function are parsed on its first lookup. Type
+  /// variants are loaded right away. Files must be in the block style of the
+  /// substrait extensions, functions are looked up as by load.
+  /// @throws exception if a file is not found, or if its functions are not
+  /// declared in block style. Malformed declarations are reported by the
+  /// lookup of the function.
+  static std::shared_ptr<const Extension> loadLazy(
+      const std::vector<std::string>& extensionFiles);
+
+  /// Load the default substrait extension files lazily from the directory of
+  /// basePath.
+  static std::shared_ptr<const Extension> loadLazy(const std::string& basePath);
+
+  /// Append the function implementations and type variants of another
+  /// extension, keeping their registration order.
+  void merge(const Extension& other);
+
   /// Add a scalar function implementation.
   void addScalarFunctionImpl(const FunctionImplementationPtr& functionImpl);
 
@@ -52,23 +121,61 @@ class Extension {
   /// Add a type variant.
   void addTypeVariant(const TypeVariantPtr& typeVariant);
 
+  /// Add implementations of a function which are decoded from the given
+  /// source on the first lookup of the function. This makes the extension
+  /// lazy, its functions then only come from such sources. Locations of the
+  /// same function are decoded in the order they were added.
+  void addLazyFunctionImpls(
+      FunctionKind kind,
+      const std::string& name,
+      const std::shared_ptr<const FunctionImplSource>& source,
+      uint64_t offset,
+      uint64_t size);
+
+  /// Test whether the functions of this extension are decoded on demand.
+  [[nodiscard]] bool isLazy() const {
+    return lazy_ != nullptr;
+  }
+
   /// Lookup type variant by given type name.
   /// @return matched type variant
   TypeVariantPtr lookupType(const std::string& typeName) const;
 
+  /// Lookup the implementations of a function by kind and name, in
+  /// registration order. A lazy extension decodes them on the first lookup,
+  /// concurrent first lookups decode them once.
+  /// @return the implementations, nullptr if there is no such function.
+  [[nodiscard]] const std::vector<FunctionImplementationPtr>* findFunctionImpls(
+      FunctionKind kind,
+      const std::string& name) const;
+
+  /// Implementations of all functions of a kind. A lazy extension decodes
+  /// all of its functions on the first call, prefer findFunctionImpls.
+  [[nodiscard]] const FunctionImplMap& functionImplMap(FunctionKind kind) const;
+
   const FunctionImplMap& scalaFunctionImplMap() const {
-    return scalarFunctionImplMap_;
+    return functionImplMap(FunctionKind::kScalar);
   }
 
   const FunctionImplMap& windowFunctionImplMap() const {
-    return windowFunctionImplMap_;
+    return functionImplMap(FunctionKind::kWindow);
   }
 
   const FunctionImplMap& aggregateFunctionImplMap() const {
-    return aggregateFunctionImplMap_;
+    return functionImplMap(FunctionKind::kAggregate);
+  }
+
+  /// Type variants by name.
+  const TypeVariantMap& typeVariantMap() const {
+    return typeVariantMap_;
   }
 
  private:
+  /// Index and decoded functions of a lazy extension.
+  struct LazyFunctions;
+
+  FunctionImplMap& eagerFunctionImplMap(FunctionKind kind);
+
   FunctionImplMap scalarFunctionImplMap_;
 
   FunctionImplMap aggregateFunctionImplMap_;
@@ -76,6 +183,9 @@ class Extension {
   FunctionImplMap windowFunctionImplMap_;
 
   TypeVariantMap typeVariantMap_;
+
+  /// Shared by copies of the extension, its decoded functions are immutable.
+  std::shared_ptr<LazyFunctions> lazy_;
 };
 
 using ExtensionPtr = std::shared_ptr<const Extension>;
@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "substrait/function/Extension.h"
+
+namespace io::substrait {
+
+/// Versioned binary snapshot of a loaded Extension, which opens without
+/// parsing any YAML. The snapshot holds no pointers, only sizes and offsets
+/// relative to its start, so it can be mapped at any address:
+///
+///   header    8 byte magic "SUBXSNAP", 4 byte little endian version
+///   uris      varint count, each a varint size and the bytes
+///   types     varint count of type variants, each a name and a uri index
+///   index     varint count of functions, each a kind byte, a name and the
+///             varint size of the function record which follows it
+///
+/// A function record holds all implementations of the function: their uri
+/// index, arguments, return type and return type expression, variadic
+/// bounds and intermediate type. Types are encoded by TypeSerializer.
+///
+/// Opening a snapshot only reads the uris, type variants and index, the
+/// record of a function is decoded on the first lookup of the function.
+class ExtensionSnapshot final {
+ public:
+  /// Version of the written snapshots, snapshots of other versions are
+  /// rejected.
+  static constexpr uint32_t kVersion = 1;
+
+  /// Append the snapshot of an extension to out. Functions and type variants
+  /// are written ordered by name, so the snapshot of an extension is
+  /// reproducible.
+  static void write(const Extension& extension, std::string& out);
+
+  /// Write the snapshot of an extension to a file.
+  /// @throws SubstraitException if the file cannot be written.
+  static void writeFile(const Extension& extension, const std::string& path);
+
+  /// Open a snapshot file by mapping it into memory, the mapping lives as
+  /// long as the extension.
+  /// @throws SubstraitException if the file cannot be mapped, or if it is no
+  /// snapshot of this version. Corrupt function records are reported by the
+  /// lookup of the function.
+  static ExtensionPtr openFile(const std::string& path);
+
+  /// Open a snapshot held in memory, e.g. embedded into the binary. The
+  /// bytes must outlive the extension.
+  static ExtensionPtr openBuffer(std::string_view bytes);
+};
+
+} // namespace io::substrait
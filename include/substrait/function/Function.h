@@ -6,6 +6,8 @@
 
 #include "substrait/function/FunctionSignature.h"
 #include "substrait/type/Type.h"
+#include "substrait/type/TypeBindings.h"
+#include "substrait/type/TypeDerivation.h"
 
 namespace io::substrait {
 
@@ -14,7 +16,14 @@ struct FunctionArgument {
 
   /// Convert argument type to short type string based on
   /// https://substrait.io/extensions/#function-signature-compound-names
-  [[nodiscard]] virtual std::string toTypeString() const = 0;
+  [[nodiscard]] std::string toTypeString() const {
+    fmt::memory_buffer out;
+    appendTypeString(out);
+    return fmt::to_string(out);
+  }
+
+  /// Append the short type string to out, see toTypeString().
+  virtual void appendTypeString(fmt::memory_buffer& out) const = 0;
 
   [[nodiscard]] virtual bool isWildcardType() const {
     return false;
@@ -42,8 +51,9 @@ struct EnumArgument : public FunctionArgument {
     return required;
   }
 
-  [[nodiscard]] std::string toTypeString() const override {
-    return required ? "req" : "opt";
+  void appendTypeString(fmt::memory_buffer& out) const override {
+    const std::string_view typeString = required ? "req" : "opt";
+    out.append(typeString.data(), typeString.data() + typeString.size());
   }
 
   [[nodiscard]] bool isEnumArgument() const override {
@@ -52,8 +62,9 @@ struct EnumArgument : public FunctionArgument {
 };
 
 struct TypeArgument : public FunctionArgument {
-  [[nodiscard]] std::string toTypeString() const override {
-    return "type";
+  void appendTypeString(fmt::memory_buffer& out) const override {
+    const std::string_view typeString = "type";
+    out.append(typeString.data(), typeString.data() + typeString.size());
   }
 
   [[nodiscard]] bool isRequired() const override {
@@ -68,8 +79,8 @@ struct TypeArgument : public FunctionArgument {
 struct ValueArgument : public FunctionArgument {
   ParameterizedTypePtr type;
 
-  [[nodiscard]] std::string toTypeString() const override {
-    return type->signature();
+  void appendTypeString(fmt::memory_buffer& out) const override {
+    type->appendSignature(out);
   }
 
   [[nodiscard]] bool isRequired() const override {
@@ -95,13 +106,48 @@ struct FunctionImplementation {
   std::string uri;
   std::vector<FunctionArgumentPtr> arguments;
   ParameterizedTypePtr returnType;
+  /// Compiled return type expression, nullptr if it could not be compiled.
+  TypeDerivationPtr returnTypeDerivation;
   std::optional<FunctionVariadic> variadic;
 
   /// Test if the actual types matched with this function's implementation.
+  /// Placeholders must bind consistently, e.g. both arguments of
+  /// lt:any1_any1 need the same type. FunctionLookup::lookupFunction by
+  /// signature alone matches through here.
   virtual bool tryMatch(const FunctionSignature& signature);
 
+  /// Same as above, the placeholder bindings of a successful match are left
+  /// in the given bindings.
+  virtual bool tryMatch(
+      const FunctionSignature& signature,
+      TypeBindings& bindings) const;
+
+  /// Same as above on borrowed types, avoids touching any reference count.
+  virtual bool tryMatch(
+      const std::vector<TypeRef>& actualTypes,
+      TypeRef returnType,
+      TypeBindings& bindings) const;
+
+  /// Derive the concrete return type of a call from the placeholder bindings
+  /// of a successful match, e.g. decimal<13,4> for add(decimal<10,2>,
+  /// decimal<12,4>). Returns nullptr if the return type cannot be derived.
+  [[nodiscard]] TypePtr deriveReturnType(const TypeBindings& bindings) const;
+
+  /// Cost of the cheapest implicit casts of the actual types which make them
+  /// match this implementation, 0 for an exact match, see TypeCoercion. A
+  /// placeholder of several arguments, such as any1 of lt:any1_any1, binds
+  /// the common supertype of their types. The bindings of the casted types
+  /// are left in the given bindings. The return type is not considered.
+  /// @return std::nullopt if no implicit casts make the types match.
+  [[nodiscard]] std::optional<int> coercionCost(
+      const std::vector<TypeRef>& actualTypes,
+      TypeBindings& bindings) const;
+
   /// Create function signature by function name and arguments.
   [[nodiscard]] std::string signature() const;
+
+  /// Append the signature to out, see signature().
+  void appendSignature(fmt::memory_buffer& out) const;
 };
 
 using FunctionImplementationPtr = std::shared_ptr<FunctionImplementation>;
@@ -112,7 +158,15 @@ struct AggregateFunctionImplementation : public FunctionImplementation {
   ParameterizedTypePtr intermediate;
   bool deterministic;
 
-  bool tryMatch(const FunctionSignature& signature) override;
+  using FunctionImplementation::tryMatch;
+
+  bool tryMatch(const FunctionSignature& signature, TypeBindings& bindings)
+      const override;
+
+  bool tryMatch(
+      const std::vector<TypeRef>& actualTypes,
+      TypeRef returnType,
+      TypeBindings& bindings) const override;
 };
 
 } // namespace io::substrait
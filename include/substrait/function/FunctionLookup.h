@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <mutex>
+#include <optional>
+
 #include "substrait/function/Extension.h"
 #include "substrait/function/FunctionSignature.h"
 
@@ -15,12 +18,75 @@ class FunctionLookup {
   [[nodiscard]] virtual FunctionImplementationPtr lookupFunction(
       const FunctionSignature& signature) const;
 
+  /// Same as above, the placeholder bindings of the matched implementation
+  /// are returned in the given bindings, so callers need not derive them.
+  [[nodiscard]] virtual FunctionImplementationPtr lookupFunction(
+      const FunctionSignature& signature,
+      TypeBindings& bindings) const;
+
+  /// Lookup a function implementation by name and borrowed argument types.
+  /// The returned implementation is owned by the extension and stays valid as
+  /// long as this lookup, nullptr if none matched. Nothing on this path
+  /// touches a reference count, so it scales with concurrent callers.
+  [[nodiscard]] const FunctionImplementation* lookupFunction(
+      const std::string& name,
+      const std::vector<TypeRef>& arguments,
+      TypeRef returnType = {}) const {
+    TypeBindings bindings;
+    return lookupFunction(name, arguments, returnType, bindings);
+  }
+
+  /// Same as above, the placeholder bindings of the matched implementation,
+  /// such as any1 or P1, are returned in the given bindings.
+  [[nodiscard]] virtual const FunctionImplementation* lookupFunction(
+      const std::string& name,
+      const std::vector<TypeRef>& arguments,
+      TypeRef returnType,
+      TypeBindings& bindings) const;
+
+  [[nodiscard]] const FunctionImplementation* lookupCoercibleFunction(
+      const std::string& name,
+      const std::vector<TypeRef>& arguments) const {
+    TypeBindings bindings;
+    return lookupCoercibleFunction(name, arguments, bindings);
+  }
+
+  /// Lookup the implementation the arguments match with the cheapest
+  /// implicit casts in a single pass over the candidates, see
+  /// FunctionImplementation::coercionCost. An exact match wins right away.
+  /// The bindings of the casted arguments are returned in the given bindings.
+  [[nodiscard]] virtual const FunctionImplementation* lookupCoercibleFunction(
+      const std::string& name,
+      const std::vector<TypeRef>& arguments,
+      TypeBindings& bindings) const;
+
   virtual ~FunctionLookup() = default;
 
  protected:
+  /// Implementations of the function of the given name, nullptr if there is
+  /// none. All lookups go through here, override it to change the candidates
+  /// of a single lookup.
+  [[nodiscard]] virtual const std::vector<FunctionImplementationPtr>*
+  findFunctionImpls(const std::string& name) const;
+
+  /// Kind of the functions to lookup by name straight from the extension, a
+  /// lazy extension only decodes the functions looked up. Without a kind,
+  /// the functions of getFunctionImpls() are looked up.
+  [[nodiscard]] virtual std::optional<FunctionKind> functionKind() const {
+    return std::nullopt;
+  }
+
+  /// Implementations of all functions to lookup, for lookups without a
+  /// function kind. It is called once, on the first lookup, and its result is
+  /// kept for the life of the lookup, so later changes are not seen.
   [[nodiscard]] virtual FunctionImplMap getFunctionImpls() const = 0;
 
   ExtensionPtr extension_{};
+
+ private:
+  /// Result of getFunctionImpls(), for lookups without a function kind.
+  mutable std::once_flag functionImplsOnce_;
+  mutable FunctionImplMap functionImpls_;
 };
 
 using FunctionLookupPtr = std::shared_ptr<const FunctionLookup>;
@@ -31,7 +97,12 @@ class ScalarFunctionLookup : public FunctionLookup {
       : FunctionLookup(extension) {}
 
  protected:
-  [[nodiscard]] FunctionImplMap getFunctionImpls() const override {
+  [[nodiscard]] std::optional<FunctionKind> functionKind() const override {
+    return FunctionKind::kScalar;
+  }
+
+  /// Unused, functions are looked up by kind.
+  [[nodiscard]] FunctionImplMap getFunctionImpls() const final {
     return extension_->scalaFunctionImplMap();
   }
 };
@@ -42,7 +113,12 @@ class AggregateFunctionLookup : public FunctionLookup {
       : FunctionLookup(extension) {}
 
  protected:
-  [[nodiscard]] FunctionImplMap getFunctionImpls() const override {
+  [[nodiscard]] std::optional<FunctionKind> functionKind() const override {
+    return FunctionKind::kAggregate;
+  }
+
+  /// Unused, functions are looked up by kind.
+  [[nodiscard]] FunctionImplMap getFunctionImpls() const final {
     return extension_->aggregateFunctionImplMap();
   }
 };
@@ -53,7 +129,12 @@ class WindowFunctionLookup : public FunctionLookup {
       : FunctionLookup(extension) {}
 
  protected:
-  [[nodiscard]] FunctionImplMap getFunctionImpls() const override {
+  [[nodiscard]] std::optional<FunctionKind> functionKind() const override {
+    return FunctionKind::kWindow;
+  }
+
+  /// Unused, functions are looked up by kind.
+  [[nodiscard]] FunctionImplMap getFunctionImpls() const final {
     return extension_->windowFunctionImplMap();
   }
 };
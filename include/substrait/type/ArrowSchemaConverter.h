@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+
+#include "substrait/type/NamedStruct.h"
+#include "substrait/type/Type.h"
+
+// Structures of the Arrow C data interface, as defined by
+// https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace io::substrait {
+
+/// Converts between types and ArrowSchema structures of the Arrow C data
+/// interface, without depending on Arrow.
+///
+/// An exported schema tree, including its format and name strings, lives in a
+/// single allocation which is freed once the root and every child moved out
+/// of it are released.
+///
+/// Types without an exact Arrow counterpart map as follows: varchar and
+/// fixedchar to utf8 ("u"), timestamp to microseconds ("tsu:"), timestamp_tz
+/// to microseconds in UTC ("tsu:UTC"), interval_day to days and milliseconds
+/// ("tiD") and uuid to the arrow.uuid extension type over a 16 byte fixed size
+/// binary.
+class ArrowSchemaConverter final {
+ public:
+  /// Export a type to an ArrowSchema, which the caller must release. Fields
+  /// of structs are unnamed.
+  /// @throws SubstraitException if the type has no Arrow counterpart.
+  static void exportType(const Type& type, ArrowSchema* out);
+
+  /// Export a schema to an ArrowSchema of struct format, which the caller
+  /// must release.
+  static void exportSchema(const NamedStruct& schema, ArrowSchema* out);
+
+  /// Import the type an ArrowSchema describes, the schema is not released.
+  /// Dictionary encoded types import as the type of their values.
+  /// @throws SubstraitException if a format is not supported.
+  static TypePtr importType(const ArrowSchema& schema);
+
+  /// Import an ArrowSchema of struct format as a schema, the ArrowSchema is
+  /// not released.
+  static NamedStruct importSchema(const ArrowSchema& schema);
+};
+
+} // namespace io::substrait
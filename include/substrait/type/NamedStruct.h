@@ -0,0 +1,132 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// Struct type with field names, the schema of a relation. As in Substrait's
+/// NamedStruct the names are given in depth-first order, so the names of the
+/// fields of a nested struct follow the name of the field holding it. Structs
+/// nested in lists and maps have names too, but are not addressable by path.
+///
+/// All names are copied into one string arena and indexed on construction by
+/// open-addressing hash tables, so looking up a field by name, with or without
+/// regard to case, takes constant time and does not allocate.
+class NamedStruct {
+ public:
+  /// @throws SubstraitException if the number of names does not match the
+  /// number of fields including nested ones, or if a struct has two fields of
+  /// the same name.
+  NamedStruct(
+      const std::vector<std::string>& names,
+      std::shared_ptr<const Struct> type);
+
+  [[nodiscard]] const std::shared_ptr<const Struct>& type() const {
+    return type_;
+  }
+
+  /// Number of top-level fields.
+  [[nodiscard]] size_t size() const {
+    return type_->childArray().size();
+  }
+
+  /// Name of a top-level field.
+  [[nodiscard]] std::string_view nameAt(size_t index) const;
+
+  /// All names in depth-first order, as given on construction. The views
+  /// are valid as long as this NamedStruct is.
+  [[nodiscard]] std::vector<std::string_view> names() const;
+
+  /// Ordinal of the top-level field with the given name, std::nullopt if
+  /// there is none.
+  [[nodiscard]] std::optional<size_t> findField(std::string_view name) const {
+    return find(0, name, false);
+  }
+
+  /// Like findField, but ASCII letters match regardless of case. Names which
+  /// only differ in case are ambiguous and never found this way.
+  [[nodiscard]] std::optional<size_t> findFieldIgnoreCase(
+      std::string_view name) const {
+    return find(0, name, true);
+  }
+
+  /// Resolve a dotted path such as "address.city" to the ordinal of the field
+  /// at each step, descending into nested structs.
+  /// @return std::nullopt if a step is not found, or a step before the last
+  /// is not a struct.
+  [[nodiscard]] std::optional<std::vector<size_t>> resolvePath(
+      std::string_view path,
+      bool ignoreCase = false) const;
+
+ private:
+  static constexpr uint32_t kNoLevel = UINT32_MAX;
+
+  /// Fields of a struct are stored contiguously in fields_.
+  struct Level {
+    uint32_t firstField;
+    uint32_t numFields;
+  };
+
+  struct Field {
+    uint32_t nameOffset;
+    uint32_t nameSize;
+    uint32_t level;
+    /// Level of the fields of a struct typed field, kNoLevel otherwise.
+    uint32_t childLevel;
+    /// Another field of the same level has this name up to case.
+    bool ambiguousIgnoringCase;
+  };
+
+  /// Add the level of a struct and, recursively, of the structs nested in
+  /// its fields, consuming their names.
+  uint32_t addLevel(
+      const Struct& type,
+      const std::vector<std::string>& names,
+      size_t& nextName);
+
+  /// Add the levels of the structs nested in a field of the given type.
+  uint32_t addNested(
+      const TypePtr& type,
+      const std::vector<std::string>& names,
+      size_t& nextName);
+
+  void buildIndex();
+
+  /// Append the names of the fields of the structs nested in a type, whose
+  /// levels are numbered from nextLevel on.
+  void appendNames(
+      const TypePtr& type,
+      uint32_t& nextLevel,
+      std::vector<std::string_view>& names) const;
+
+  [[nodiscard]] std::string_view nameOf(const Field& field) const {
+    return {arena_.data() + field.nameOffset, field.nameSize};
+  }
+
+  /// Index into fields_ of the named field of a level.
+  [[nodiscard]] std::optional<uint32_t>
+  findIndex(uint32_t level, std::string_view name, bool ignoreCase) const;
+
+  [[nodiscard]] std::optional<size_t>
+  find(uint32_t level, std::string_view name, bool ignoreCase) const;
+
+  std::shared_ptr<const Struct> type_;
+  /// All field names back to back.
+  std::string arena_;
+  std::vector<Level> levels_;
+  std::vector<Field> fields_;
+  /// Hash tables of field index + 1 (0 is an empty slot) keyed by level and
+  /// name, the latter folded to lower case for caseless lookup.
+  std::vector<uint32_t> exactSlots_;
+  std::vector<uint32_t> caselessSlots_;
+  size_t slotMask_{0};
+};
+
+} // namespace io::substrait
@@ -0,0 +1,113 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// Borrowed Arrow style buffers of a column. Fixed width values are stored
+/// back to back in the NativeType of their kind, one byte per bool and
+/// length bytes per fixedbinary value. Variable width values are the bytes
+/// between consecutive offsets into values.
+struct ColumnView {
+  /// Bit i (least significant bit first) is set if value i is not null,
+  /// nullptr if all values are valid.
+  const uint8_t* validity{nullptr};
+  const uint8_t* values{nullptr};
+  /// numRows + 1 offsets of a variable width column, nullptr otherwise.
+  const int32_t* offsets{nullptr};
+};
+
+/// Owned buffers of a column in the format of ColumnView.
+struct ColumnBuffers {
+  std::vector<uint8_t> validity;
+  std::vector<uint8_t> values;
+  std::vector<int32_t> offsets;
+
+  [[nodiscard]] ColumnView view() const {
+    return {
+        validity.empty() ? nullptr : validity.data(),
+        values.data(),
+        offsets.empty() ? nullptr : offsets.data()};
+  }
+};
+
+/// Layout of rows of a struct type, as used to shuffle and spill rows. A row
+/// starts with a null bitmap, a set bit marks a null field, followed by the
+/// fixed width section in which every field has a precomputed offset aligned
+/// to its kind. Variable width fields hold a 32-bit offset and size of their
+/// bytes in the variable width section, which starts at fixedSize(). Rows
+/// are padded to rowAlignment() and padding is zeroed, so equal rows encode
+/// to equal bytes.
+///
+/// Encoding and decoding go column by column, the copy routine of a column is
+/// chosen once for all rows.
+class RowLayout {
+ public:
+  /// @throws SubstraitException if a field is of a nested type.
+  explicit RowLayout(const Struct& type);
+
+  [[nodiscard]] size_t numFields() const {
+    return fields_.size();
+  }
+
+  [[nodiscard]] size_t nullBitmapSize() const {
+    return nullBitmapSize_;
+  }
+
+  /// Offset of a field within a row.
+  [[nodiscard]] size_t fieldOffset(size_t field) const {
+    return fields_[field].offset;
+  }
+
+  /// Size of the null bitmap and fixed width section, the offset of the
+  /// variable width section.
+  [[nodiscard]] size_t fixedSize() const {
+    return fixedSize_;
+  }
+
+  [[nodiscard]] size_t rowAlignment() const {
+    return rowAlignment_;
+  }
+
+  /// Whether all rows have the same size, fixedSize().
+  [[nodiscard]] bool isFixedSize() const {
+    return variableFields_.empty();
+  }
+
+  /// Encode numRows rows of the columns, one per field, back to back into
+  /// rows. rowOffsets receives the offsets of the rows followed by the total
+  /// size.
+  void encode(
+      const std::vector<ColumnView>& columns,
+      size_t numRows,
+      std::vector<uint8_t>& rows,
+      std::vector<size_t>& rowOffsets) const;
+
+  /// Decode numRows rows into columns, one per field. A column gets a
+  /// validity bitmap only if it has nulls.
+  void decode(
+      const uint8_t* const* rows,
+      size_t numRows,
+      std::vector<ColumnBuffers>& columns) const;
+
+ private:
+  struct Field {
+    uint32_t offset;
+    /// Width of a fixed width field.
+    uint32_t width;
+  };
+
+  std::vector<Field> fields_;
+  std::vector<uint32_t> fixedFields_;
+  std::vector<uint32_t> variableFields_;
+  size_t nullBitmapSize_;
+  size_t fixedSize_;
+  size_t rowAlignment_;
+};
+
+} // namespace io::substrait
@@ -2,8 +2,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fmt/format.h>
 #include <iostream>
 #include <memory>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -37,6 +42,39 @@ enum class TypeKind : int8_t {
   KIND_NOT_SET = 0,
 };
 
+/// Number of TypeKind values including KIND_NOT_SET, the size of tables
+/// indexed by kind.
+constexpr size_t kNumTypeKinds = 24;
+
+#ifdef __SIZEOF_INT128__
+/// 128-bit integer storing decimals and uuids.
+__extension__ typedef __int128 Int128;
+#else
+/// 128-bit integer storing decimals and uuids, as two words where the
+/// compiler has no 128-bit integer type.
+struct alignas(16) Int128 {
+  uint64_t low;
+  int64_t high;
+};
+#endif
+
+/// How values of a type are laid out in memory.
+enum class PhysicalLayout : int8_t {
+  /// All values take byteWidth bytes.
+  kFixedWidth,
+  /// All values of a type take as many bytes as its length parameter, e.g. 16
+  /// for fixedbinary<16>.
+  kParameterWidth,
+  /// Values are byte sequences of varying length.
+  kVariableWidth,
+  /// Values are made up of child values.
+  kNested,
+};
+
+/// Static properties of a type kind. Besides its names, NativeType is the C++
+/// type holding a value and layout, byteWidth and alignment describe how
+/// values are stored. Width and alignment are 0 and 1 unless the layout is
+/// fixed width.
 template <TypeKind KIND>
 struct TypeTraits {};
 
@@ -44,147 +82,379 @@ template <>
 struct TypeTraits<TypeKind::kBool> {
   static constexpr const char* signature = "bool";
   static constexpr const char* typeString = "boolean";
+  using NativeType = bool;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kI8> {
   static constexpr const char* signature = "i8";
   static constexpr const char* typeString = "i8";
+  using NativeType = int8_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kI16> {
   static constexpr const char* signature = "i16";
   static constexpr const char* typeString = "i16";
+  using NativeType = int16_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kI32> {
   static constexpr const char* signature = "i32";
   static constexpr const char* typeString = "i32";
+  using NativeType = int32_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kI64> {
   static constexpr const char* signature = "i64";
   static constexpr const char* typeString = "i64";
+  using NativeType = int64_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kFp32> {
   static constexpr const char* signature = "fp32";
   static constexpr const char* typeString = "fp32";
+  using NativeType = float;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kFp64> {
   static constexpr const char* signature = "fp64";
   static constexpr const char* typeString = "fp64";
+  using NativeType = double;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kString> {
   static constexpr const char* signature = "str";
   static constexpr const char* typeString = "string";
+  using NativeType = std::string_view;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kVariableWidth;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
 };
 
 template <>
 struct TypeTraits<TypeKind::kBinary> {
   static constexpr const char* signature = "vbin";
   static constexpr const char* typeString = "binary";
+  using NativeType = std::string_view;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kVariableWidth;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
 };
 
 template <>
 struct TypeTraits<TypeKind::kTimestamp> {
   static constexpr const char* signature = "ts";
   static constexpr const char* typeString = "timestamp";
+  /// Microseconds since the epoch.
+  using NativeType = int64_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kTimestampTz> {
   static constexpr const char* signature = "tstz";
   static constexpr const char* typeString = "timestamp_tz";
+  /// Microseconds since the epoch in UTC.
+  using NativeType = int64_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kDate> {
   static constexpr const char* signature = "date";
   static constexpr const char* typeString = "date";
+  /// Days since the epoch.
+  using NativeType = int32_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kTime> {
   static constexpr const char* signature = "time";
   static constexpr const char* typeString = "time";
+  /// Microseconds since midnight.
+  using NativeType = int64_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kIntervalYear> {
   static constexpr const char* signature = "iyear";
   static constexpr const char* typeString = "interval_year";
+  /// Months.
+  using NativeType = int32_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kIntervalDay> {
   static constexpr const char* signature = "iday";
   static constexpr const char* typeString = "interval_day";
+  /// Microseconds.
+  using NativeType = int64_t;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kUuid> {
   static constexpr const char* signature = "uuid";
   static constexpr const char* typeString = "uuid";
+  using NativeType = Int128;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kFixedChar> {
   static constexpr const char* signature = "fchar";
   static constexpr const char* typeString = "fixedchar";
+  /// Characters may take more than one byte each.
+  using NativeType = std::string_view;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kVariableWidth;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
 };
 
 template <>
 struct TypeTraits<TypeKind::kVarchar> {
   static constexpr const char* signature = "vchar";
   static constexpr const char* typeString = "varchar";
+  using NativeType = std::string_view;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kVariableWidth;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
 };
 
 template <>
 struct TypeTraits<TypeKind::kFixedBinary> {
   static constexpr const char* signature = "fbin";
   static constexpr const char* typeString = "fixedbinary";
+  using NativeType = std::string_view;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kParameterWidth;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
 };
 
 template <>
 struct TypeTraits<TypeKind::kDecimal> {
   static constexpr const char* signature = "dec";
   static constexpr const char* typeString = "decimal";
+  /// Unscaled value.
+  using NativeType = Int128;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kFixedWidth;
+  static constexpr size_t byteWidth = sizeof(NativeType);
+  static constexpr size_t alignment = alignof(NativeType);
 };
 
 template <>
 struct TypeTraits<TypeKind::kStruct> {
   static constexpr const char* signature = "struct";
   static constexpr const char* typeString = "struct";
+  using NativeType = void;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kNested;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
 };
 
 template <>
 struct TypeTraits<TypeKind::kList> {
   static constexpr const char* signature = "list";
   static constexpr const char* typeString = "list";
+  using NativeType = void;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kNested;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
 };
 
 template <>
 struct TypeTraits<TypeKind::kMap> {
   static constexpr const char* signature = "map";
   static constexpr const char* typeString = "map";
+  using NativeType = void;
+  static constexpr PhysicalLayout layout = PhysicalLayout::kNested;
+  static constexpr size_t byteWidth = 0;
+  static constexpr size_t alignment = 1;
+};
+
+/// Physical layout of a type kind, the runtime counterpart of TypeTraits.
+struct TypeLayout {
+  PhysicalLayout layout;
+  uint8_t byteWidth;
+  uint8_t alignment;
+
+  [[nodiscard]] constexpr bool isFixedWidth() const {
+    return layout == PhysicalLayout::kFixedWidth;
+  }
+};
+
+namespace detail {
+
+template <TypeKind Kind>
+constexpr TypeLayout makeTypeLayout() {
+  using Traits = TypeTraits<Kind>;
+  return {Traits::layout, Traits::byteWidth, Traits::alignment};
+}
+
+} // namespace detail
+
+/// Layouts of all type kinds indexed by TypeKind, KIND_NOT_SET has none.
+inline constexpr std::array<TypeLayout, kNumTypeKinds> kTypeLayouts = {
+    TypeLayout{PhysicalLayout::kVariableWidth, 0, 1},
+    detail::makeTypeLayout<TypeKind::kBool>(),
+    detail::makeTypeLayout<TypeKind::kI8>(),
+    detail::makeTypeLayout<TypeKind::kI16>(),
+    detail::makeTypeLayout<TypeKind::kI32>(),
+    detail::makeTypeLayout<TypeKind::kI64>(),
+    detail::makeTypeLayout<TypeKind::kFp32>(),
+    detail::makeTypeLayout<TypeKind::kFp64>(),
+    detail::makeTypeLayout<TypeKind::kString>(),
+    detail::makeTypeLayout<TypeKind::kBinary>(),
+    detail::makeTypeLayout<TypeKind::kTimestamp>(),
+    detail::makeTypeLayout<TypeKind::kDate>(),
+    detail::makeTypeLayout<TypeKind::kTime>(),
+    detail::makeTypeLayout<TypeKind::kIntervalYear>(),
+    detail::makeTypeLayout<TypeKind::kIntervalDay>(),
+    detail::makeTypeLayout<TypeKind::kTimestampTz>(),
+    detail::makeTypeLayout<TypeKind::kUuid>(),
+    detail::makeTypeLayout<TypeKind::kFixedChar>(),
+    detail::makeTypeLayout<TypeKind::kVarchar>(),
+    detail::makeTypeLayout<TypeKind::kFixedBinary>(),
+    detail::makeTypeLayout<TypeKind::kDecimal>(),
+    detail::makeTypeLayout<TypeKind::kStruct>(),
+    detail::makeTypeLayout<TypeKind::kList>(),
+    detail::makeTypeLayout<TypeKind::kMap>(),
+};
+
+constexpr const TypeLayout& typeLayout(TypeKind kind) {
+  return kTypeLayouts[static_cast<size_t>(kind)];
+}
+
+class ParameterizedType;
+class TypeBindings;
+
+/// A borrowed handle to a type, copying it never touches a reference count.
+/// Types interned by TypeFactory are immortal and types owned by a loaded
+/// Extension live as long as the Extension, so handles to them can be passed
+/// between threads on hot matching paths. The referenced type must outlive
+/// the handle.
+class TypeRef {
+ public:
+  TypeRef() = default;
+
+  TypeRef(const ParameterizedType& type) : type_(&type) {}
+
+  TypeRef(const ParameterizedType* type) : type_(type) {}
+
+  template <typename T>
+  TypeRef(const std::shared_ptr<const T>& type) : type_(type.get()) {}
+
+  [[nodiscard]] const ParameterizedType* get() const {
+    return type_;
+  }
+
+  const ParameterizedType& operator*() const {
+    return *type_;
+  }
+
+  const ParameterizedType* operator->() const {
+    return type_;
+  }
+
+  explicit operator bool() const {
+    return type_ != nullptr;
+  }
+
+ private:
+  const ParameterizedType* type_{nullptr};
 };
 
 class ParameterizedType {
  public:
-  explicit ParameterizedType(bool nullable = false) : nullable_(nullable) {}
+  ParameterizedType(TypeKind kind, bool parameterized, bool nullable)
+      : kind_(kind), parameterized_(parameterized), nullable_(nullable) {}
+
+  virtual ~ParameterizedType();
+
+  /// Short type string based on
+  /// https://substrait.io/extensions/#function-signature-compound-names.
+  /// Built on first use and cached, it does not include nullability.
+  [[nodiscard]] const std::string& signature() const;
+
+  /// Append the signature to out. A cached signature is copied, otherwise
+  /// the signature is rendered straight into out, nested types included,
+  /// without allocating or populating the cache.
+  void appendSignature(fmt::memory_buffer& out) const;
+
+  /// 64-bit structural hash over kind, nullability, parameters and children.
+  /// Computed on first use and cached.
+  [[nodiscard]] uint64_t hash() const;
 
-  [[nodiscard]] virtual std::string signature() const = 0;
+  /// Test whether two types are structurally equal, including the
+  /// nullability of nested types. Unlike isMatch this is symmetric and treats
+  /// wildcards and placeholders as plain literals.
+  [[nodiscard]] bool isEqual(const ParameterizedType& other) const;
 
-  [[nodiscard]] virtual TypeKind kind() const = 0;
+  /// Same as isEqual, but ignores the nullability of this type itself. The
+  /// nullability of nested types still has to agree.
+  [[nodiscard]] bool isEqualIgnoringNullability(
+      const ParameterizedType& other) const;
+
+  [[nodiscard]] TypeKind kind() const {
+    return kind_;
+  }
+
+  /// Test whether a type belongs to the parameterized type hierarchy used in
+  /// function declarations (including StringLiteral), false for concrete
+  /// types. Together with kind() it identifies the dynamic class of a type.
+  [[nodiscard]] bool isParameterized() const {
+    return parameterized_;
+  }
+
+  /// Test whether this type is owned by the TypeFactory. Interned types are
+  /// immortal, the factory hands them out without reference counting.
+  [[nodiscard]] bool isInterned() const {
+    return interned_;
+  }
 
   /// Deserialize substrait raw type string into Substrait extension  type.
   /// @param rawType - substrait extension raw string type
@@ -201,10 +471,14 @@ class ParameterizedType {
     return nullable_;
   }
 
-  [[nodiscard]] bool nullMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const {
-    return nullable() || nullable() == type->nullable();
+  [[nodiscard]] bool nullMatch(const ParameterizedType& type) const {
+    return nullable() || nullable() == type.nullable();
+  }
+
+  [[nodiscard]] bool nullMatch(TypeRef type) const {
+    return nullMatch(*type);
   }
+
   /// Test whether a type is a Wildcard type or not, always false for non
   /// StringLiteral type.
   [[nodiscard]] virtual bool isWildcard() const {
@@ -217,39 +491,194 @@ class ParameterizedType {
     return false;
   }
 
-  [[nodiscard]] virtual bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const = 0;
+  /// Test whether the given actual type matches this type. Dispatches on the
+  /// kind tag, so no RTTI or reference counting is involved.
+  [[nodiscard]] bool isMatch(const ParameterizedType& type) const;
+
+  /// Borrowing overload, so passing a TypePtr where a ParameterizedTypePtr
+  /// would be expected does not create a temporary shared pointer.
+  [[nodiscard]] bool isMatch(TypeRef type) const {
+    return isMatch(*type);
+  }
+
+  /// Test whether the given actual type matches this type, binding the
+  /// placeholders of this type in the given bindings. Bound placeholders
+  /// only match their binding, e.g. struct<any1,any1> does not match
+  /// struct<i32,i64>.
+  [[nodiscard]] bool isMatch(
+      const ParameterizedType& type,
+      TypeBindings& bindings) const;
 
  private:
+  /// Build the signature string, see signature().
+  [[nodiscard]] std::string makeSignature() const;
+
+  [[nodiscard]] uint64_t makeHash() const;
+
+  friend class TypeFactory;
+
+  const TypeKind kind_;
+  const bool parameterized_;
   const bool nullable_;
+  /// Set by the TypeFactory before the type is published.
+  bool interned_{false};
+
+  /// Lazily built signature, published once with compare-and-swap.
+  mutable std::atomic<const std::string*> signature_{nullptr};
+
+  /// Lazily computed hash, 0 if not yet computed.
+  mutable std::atomic<uint64_t> hash_{0};
+};
+
+/// Hasher for using types as keys in unordered containers.
+struct TypeHasher {
+  size_t operator()(const ParameterizedType& type) const {
+    return type.hash();
+  }
+
+  size_t operator()(
+      const std::shared_ptr<const ParameterizedType>& type) const {
+    return type->hash();
+  }
 };
 
+/// Structural equality for using types as keys in unordered containers.
+struct TypeEqual {
+  bool operator()(const ParameterizedType& lhs, const ParameterizedType& rhs)
+      const {
+    return lhs.isEqual(rhs);
+  }
+
+  bool operator()(
+      const std::shared_ptr<const ParameterizedType>& lhs,
+      const std::shared_ptr<const ParameterizedType>& rhs) const {
+    return lhs->isEqual(*rhs);
+  }
+};
+
+/// LLVM-style casting helpers keyed on the kind tag, every class of the type
+/// hierarchy provides a static classof(const ParameterizedType&).
+template <typename T>
+bool isa(const ParameterizedType& type) {
+  return T::classof(type);
+}
+
+/// Cast to the given class, the caller must ensure that isa<T>(type) holds.
+template <typename T>
+const T& cast(const ParameterizedType& type) {
+  return static_cast<const T&>(type);
+}
+
+/// Cast to the given class, or nullptr if the type is not an instance of it.
+template <typename T>
+const T* dynCast(const ParameterizedType& type) {
+  return isa<T>(type) ? static_cast<const T*>(&type) : nullptr;
+}
+
 using ParameterizedTypePtr = std::shared_ptr<const ParameterizedType>;
 
 class Type : public ParameterizedType {
  public:
-  explicit Type(bool nullable = false) : ParameterizedType(nullable) {}
+  Type(TypeKind kind, bool nullable)
+      : ParameterizedType(kind, false, nullable) {}
+
+  static bool classof(const ParameterizedType& type) {
+    return !type.isParameterized();
+  }
+
+  /// Return this type with the given nullability, see
+  /// TypeFactory::withNullable.
+  [[nodiscard]] std::shared_ptr<const Type> withNullable(bool nullable) const;
+
+  [[nodiscard]] std::shared_ptr<const Type> asNullable() const {
+    return withNullable(true);
+  }
+
+  [[nodiscard]] std::shared_ptr<const Type> asNonNull() const {
+    return withNullable(false);
+  }
+
+ private:
+  friend class TypeFactory;
+
+  /// The interned type of the other nullability, linked on first use.
+  mutable std::atomic<const Type*> sibling_{nullptr};
 };
 
 using TypePtr = std::shared_ptr<const Type>;
 
-/// Types used in function argument declarations.
-template <TypeKind Kind>
-class TypeBase : public Type {
+/// An immutable contiguous array of types, e.g. the children of a struct.
+/// Up to kInlineCapacity types are stored inline, larger arrays use a single
+/// allocation. Interned types are held without reference counting, so
+/// copying or destroying an array of interned types touches no counters.
+class TypeArray {
  public:
-  explicit TypeBase(bool nullable = false) : Type(nullable) {}
+  using value_type = TypePtr;
+  using size_type = size_t;
+  using const_reference = const TypePtr&;
+  using const_iterator = const TypePtr*;
+  using iterator = const_iterator;
 
-  [[nodiscard]] std::string signature() const override {
-    return TypeTraits<Kind>::signature;
+  static constexpr size_t kInlineCapacity = 4;
+
+  TypeArray() = default;
+
+  explicit TypeArray(std::vector<TypePtr> types);
+
+  TypeArray(const TypeArray& other);
+
+  TypeArray(TypeArray&& other) noexcept;
+
+  TypeArray& operator=(const TypeArray&) = delete;
+
+  TypeArray& operator=(TypeArray&&) = delete;
+
+  [[nodiscard]] size_t size() const {
+    return size_;
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return Kind;
+  [[nodiscard]] bool empty() const {
+    return size_ == 0;
   }
 
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override {
-    return kind() == type->kind() && nullMatch(type);
+  [[nodiscard]] const TypePtr* data() const {
+    return data_;
+  }
+
+  [[nodiscard]] const_iterator begin() const {
+    return data_;
+  }
+
+  [[nodiscard]] const_iterator end() const {
+    return data_ + size_;
+  }
+
+  const TypePtr& operator[](size_t index) const {
+    return data_[index];
+  }
+
+  /// Bounds checked access.
+  /// @throws std::out_of_range if the index is out of range.
+  [[nodiscard]] const TypePtr& at(size_t index) const;
+
+ private:
+  TypePtr* data_{inline_};
+  size_t size_{0};
+  TypePtr inline_[kInlineCapacity];
+  /// Storage of arrays larger than kInlineCapacity.
+  std::vector<TypePtr> heap_;
+};
+
+/// Types used in function argument declarations.
+template <TypeKind Kind>
+class TypeBase : public Type {
+ public:
+  static constexpr TypeKind kKind = Kind;
+
+  explicit TypeBase(bool nullable = false) : Type(Kind, nullable) {}
+
+  static bool classof(const ParameterizedType& type) {
+    return type.kind() == Kind && !type.isParameterized();
   }
 };
 
@@ -266,8 +695,6 @@ class Decimal : public TypeBase<TypeKind::kDecimal> {
         precision_(precision),
         scale_(scale) {}
 
-  [[nodiscard]] std::string signature() const override;
-
   [[nodiscard]] const int& precision() const {
     return precision_;
   }
@@ -276,9 +703,6 @@ class Decimal : public TypeBase<TypeKind::kDecimal> {
     return scale_;
   }
 
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const int precision_;
   const int scale_;
@@ -293,11 +717,6 @@ class FixedBinary : public TypeBase<TypeKind::kFixedBinary> {
     return length_;
   }
 
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const int length_;
 };
@@ -311,11 +730,6 @@ class FixedChar : public TypeBase<TypeKind::kFixedChar> {
     return length_;
   }
 
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const int length_;
 };
@@ -329,11 +743,6 @@ class Varchar : public TypeBase<TypeKind::kVarchar> {
     return length_;
   }
 
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const int length_;
 };
@@ -348,11 +757,6 @@ class List : public TypeBase<TypeKind::kList> {
     return elementType_;
   }
 
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const TypePtr elementType_;
 };
@@ -362,17 +766,24 @@ class Struct : public TypeBase<TypeKind::kStruct> {
   explicit Struct(std::vector<TypePtr> types, bool nullable = false)
       : TypeBase<TypeKind::kStruct>(nullable), children_(std::move(types)) {}
 
-  [[nodiscard]] std::string signature() const override;
+  explicit Struct(TypeArray types, bool nullable = false)
+      : TypeBase<TypeKind::kStruct>(nullable), children_(std::move(types)) {}
+
+  ~Struct() override;
+
+  /// Children as a vector, copied from childArray() on the first call. Prefer
+  /// childArray(), which needs no copy.
+  [[nodiscard]] const std::vector<TypePtr>& children() const;
 
-  [[nodiscard]] const std::vector<TypePtr>& children() const {
+  /// Children laid out contiguously, small structs keep them inline.
+  [[nodiscard]] const TypeArray& childArray() const {
     return children_;
   }
 
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
-  const std::vector<TypePtr> children_;
+  const TypeArray children_;
+  /// Built by the first call of children().
+  mutable std::atomic<const std::vector<TypePtr>*> childVector_{nullptr};
 };
 
 class Map : public TypeBase<TypeKind::kMap> {
@@ -390,11 +801,6 @@ class Map : public TypeBase<TypeKind::kMap> {
     return valueType_;
   }
 
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const TypePtr keyType_;
   const TypePtr valueType_;
@@ -402,26 +808,42 @@ class Map : public TypeBase<TypeKind::kMap> {
 
 class ParameterizedTypeBase : public ParameterizedType {
  public:
-  explicit ParameterizedTypeBase(bool nullable = false)
-      : ParameterizedType(nullable) {}
+  ParameterizedTypeBase(TypeKind kind, bool nullable)
+      : ParameterizedType(kind, true, nullable) {}
+
+  static bool classof(const ParameterizedType& type) {
+    return type.isParameterized();
+  }
+};
+
+/// Base of the parameterized counterparts of concrete types, such as
+/// decimal<P,S> or list<any1>.
+template <TypeKind Kind>
+class ParameterizedKindBase : public ParameterizedTypeBase {
+ public:
+  static constexpr TypeKind kKind = Kind;
+
+  explicit ParameterizedKindBase(bool nullable = false)
+      : ParameterizedTypeBase(Kind, nullable) {}
+
+  static bool classof(const ParameterizedType& type) {
+    return type.kind() == Kind && type.isParameterized();
+  }
 };
 
 /// A string literal type can present the 'any1' or 'T','P1'.
 class StringLiteral : public ParameterizedTypeBase {
  public:
   StringLiteral(const std::string& value, bool wildcard, bool placeholder)
-      : ParameterizedTypeBase(false),
+      : ParameterizedTypeBase(TypeKind::KIND_NOT_SET, false),
         value_(std::move(value)),
         wildcard_(wildcard),
         placeholder_(placeholder) {}
 
-  [[nodiscard]] std::string signature() const override {
-    return value_;
+  static bool classof(const ParameterizedType& type) {
+    return type.kind() == TypeKind::KIND_NOT_SET && type.isParameterized();
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::KIND_NOT_SET;
-  }
 
   [[nodiscard]] const std::string& value() const {
     return value_;
@@ -438,9 +860,6 @@ class StringLiteral : public ParameterizedTypeBase {
   /// Return true if value is a integer, false otherwise.
   [[nodiscard]] bool isInteger() const;
 
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const std::string value_;
   const bool wildcard_;
@@ -449,187 +868,137 @@ class StringLiteral : public ParameterizedTypeBase {
 
 using StringLiteralPtr = std::shared_ptr<const StringLiteral>;
 
-class ParameterizedDecimal : public ParameterizedTypeBase {
+class ParameterizedDecimal : public ParameterizedKindBase<TypeKind::kDecimal> {
  public:
   ParameterizedDecimal(
       StringLiteralPtr precision,
       StringLiteralPtr scale,
       bool nullable = false)
-      : ParameterizedTypeBase(nullable),
+      : ParameterizedKindBase<TypeKind::kDecimal>(nullable),
         precision_(std::move(precision)),
         scale_(std::move(scale)) {}
 
-  [[nodiscard]] std::string signature() const override;
-
   [[nodiscard]] const StringLiteralPtr& precision() const {
     return precision_;
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::kDecimal;
-  }
-
   [[nodiscard]] const StringLiteralPtr& scale() const {
     return scale_;
   }
 
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   StringLiteralPtr precision_;
   StringLiteralPtr scale_;
 };
 
-class ParameterizedFixedBinary : public ParameterizedTypeBase {
+class ParameterizedFixedBinary
+    : public ParameterizedKindBase<TypeKind::kFixedBinary> {
  public:
   explicit ParameterizedFixedBinary(
       StringLiteralPtr length,
       bool nullable = false)
-      : ParameterizedTypeBase(nullable), length_(std::move(length)) {}
+      : ParameterizedKindBase<TypeKind::kFixedBinary>(nullable),
+        length_(std::move(length)) {}
 
   [[nodiscard]] const StringLiteralPtr& length() const {
     return length_;
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::kFixedBinary;
-  }
-
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const StringLiteralPtr length_;
 };
 
-class ParameterizedFixedChar : public ParameterizedTypeBase {
+class ParameterizedFixedChar
+    : public ParameterizedKindBase<TypeKind::kFixedChar> {
  public:
   explicit ParameterizedFixedChar(
       StringLiteralPtr length,
       bool nullable = false)
-      : ParameterizedTypeBase(nullable), length_(std::move(length)) {}
+      : ParameterizedKindBase<TypeKind::kFixedChar>(nullable),
+        length_(std::move(length)) {}
 
   [[nodiscard]] const StringLiteralPtr& length() const {
     return length_;
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::kFixedChar;
-  }
-
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const StringLiteralPtr length_;
 };
 
-class ParameterizedVarchar : public ParameterizedTypeBase {
+class ParameterizedVarchar : public ParameterizedKindBase<TypeKind::kVarchar> {
  public:
   explicit ParameterizedVarchar(StringLiteralPtr length, bool nullable = false)
-      : ParameterizedTypeBase(nullable), length_(std::move(length)) {}
+      : ParameterizedKindBase<TypeKind::kVarchar>(nullable),
+        length_(std::move(length)) {}
 
   [[nodiscard]] const StringLiteralPtr& length() const {
     return length_;
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::kVarchar;
-  }
-
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const StringLiteralPtr length_;
 };
 
-class ParameterizedList : public ParameterizedTypeBase {
+class ParameterizedList : public ParameterizedKindBase<TypeKind::kList> {
  public:
   explicit ParameterizedList(
       ParameterizedTypePtr elementType,
       bool nullable = false)
-      : ParameterizedTypeBase(nullable), elementType_(std::move(elementType)){};
+      : ParameterizedKindBase<TypeKind::kList>(nullable),
+        elementType_(std::move(elementType)){};
 
   [[nodiscard]] const ParameterizedTypePtr& elementType() const {
     return elementType_;
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::kList;
-  }
-
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const ParameterizedTypePtr elementType_;
 };
 
-class ParameterizedStruct : public ParameterizedTypeBase {
+class ParameterizedStruct : public ParameterizedKindBase<TypeKind::kStruct> {
  public:
   explicit ParameterizedStruct(
       std::vector<ParameterizedTypePtr> types,
       bool nullable = false)
-      : ParameterizedTypeBase(nullable), children_(std::move(types)) {}
-
-  [[nodiscard]] std::string signature() const override;
+      : ParameterizedKindBase<TypeKind::kStruct>(nullable),
+        children_(std::move(types)) {}
 
   [[nodiscard]] const std::vector<ParameterizedTypePtr>& children() const {
     return children_;
   }
 
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::kStruct;
-  }
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const std::vector<ParameterizedTypePtr> children_;
 };
 
-class ParameterizedMap : public ParameterizedTypeBase {
+class ParameterizedMap : public ParameterizedKindBase<TypeKind::kMap> {
  public:
   ParameterizedMap(
       ParameterizedTypePtr keyType,
       ParameterizedTypePtr valueType,
       bool nullable = false)
-      : ParameterizedTypeBase(nullable),
+      : ParameterizedKindBase<TypeKind::kMap>(nullable),
         keyType_(std::move(keyType)),
         valueType_(std::move(valueType)) {}
 
   [[nodiscard]] const ParameterizedTypePtr& keyType() const {
     return keyType_;
   }
-
-  [[nodiscard]] TypeKind kind() const override {
-    return TypeKind::kMap;
-  }
   [[nodiscard]] const ParameterizedTypePtr& valueType() const {
     return valueType_;
   }
 
-  [[nodiscard]] std::string signature() const override;
-
-  [[nodiscard]] bool isMatch(
-      const std::shared_ptr<const ParameterizedType>& type) const override;
-
  private:
   const ParameterizedTypePtr keyType_;
   const ParameterizedTypePtr valueType_;
 };
 
+// The types below are interned by TypeFactory: equal types share one object,
+// which is never freed. They are handed out without a control block, so
+// their use_count() is 0 and a weak_ptr to them is always expired. Every
+// distinct type built here stays in memory until the process exits, unless
+// TypeFactory::setCapacity bounds the pool.
+
 std::shared_ptr<const ScalarType<TypeKind::kBool>> BOOL();
 
 std::shared_ptr<const ScalarType<TypeKind::kI8>> TINYINT();
@@ -0,0 +1,76 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// Placeholder bindings recorded while matching actual types against a
+/// function declaration. Type placeholders such as any1 bind to a type,
+/// integer placeholders such as P1, S1 or L1 bind to a value. A placeholder
+/// which is already bound only matches the same binding again, so both
+/// arguments of lt:any1_any1 must have the same type.
+///
+/// Names and types are borrowed: the names from the declaration and the types
+/// from the actual arguments, both must outlive the bindings. Up to
+/// kInlineCapacity bindings are kept inline without allocating.
+class TypeBindings {
+ public:
+  static constexpr size_t kInlineCapacity = 8;
+
+  /// Bind a type placeholder, or test whether an existing binding agrees with
+  /// the type. Nullability is not part of a type binding, so any1 binds i32
+  /// and i32? alike. A trailing '?' of the name is ignored.
+  /// @return false if the placeholder is bound to a different type.
+  bool bindType(std::string_view name, const ParameterizedType& type);
+
+  /// Bind an integer placeholder, or test whether an existing binding agrees
+  /// with the value.
+  /// @return false if the placeholder is bound to a different value.
+  bool bindValue(std::string_view name, int64_t value);
+
+  /// Type bound to a placeholder, nullptr if it is unbound.
+  [[nodiscard]] const ParameterizedType* findType(std::string_view name) const;
+
+  /// Value bound to an integer placeholder, std::nullopt if it is unbound.
+  [[nodiscard]] std::optional<int64_t> findValue(std::string_view name) const;
+
+  [[nodiscard]] size_t size() const {
+    return size_;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return size_ == 0;
+  }
+
+  /// Drop all bindings, e.g. before matching the next candidate declaration.
+  void clear() {
+    size_ = 0;
+    overflow_.clear();
+  }
+
+ private:
+  struct Binding {
+    std::string_view name;
+    /// Bound type of a type placeholder, nullptr for an integer placeholder.
+    const ParameterizedType* type;
+    int64_t value;
+  };
+
+  [[nodiscard]] const Binding* find(std::string_view name) const;
+
+  void add(const Binding& binding);
+
+  std::array<Binding, kInlineCapacity> inline_{};
+  /// Bindings beyond the inline capacity, rarely used.
+  std::vector<Binding> overflow_;
+  size_t size_{0};
+};
+
+} // namespace io::substrait
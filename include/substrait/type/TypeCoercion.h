@@ -0,0 +1,114 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// Cost of an implicit cast between two kinds, kNoImplicitCast if there is
+/// none.
+using ImplicitCastCost = int8_t;
+
+constexpr ImplicitCastCost kNoImplicitCast = -1;
+
+namespace detail {
+
+/// The direct implicit casts, widening a kind without losing information.
+/// Cheaper casts are preferred: integers widen first to larger integers,
+/// then to decimals, and only then to floating point.
+struct ImplicitCast {
+  TypeKind from;
+  TypeKind to;
+  ImplicitCastCost cost;
+};
+
+inline constexpr ImplicitCast kImplicitCasts[] = {
+    {TypeKind::kI8, TypeKind::kI16, 1},
+    {TypeKind::kI16, TypeKind::kI32, 1},
+    {TypeKind::kI32, TypeKind::kI64, 1},
+    {TypeKind::kI64, TypeKind::kDecimal, 2},
+    {TypeKind::kI16, TypeKind::kFp32, 3},
+    {TypeKind::kI64, TypeKind::kFp64, 3},
+    {TypeKind::kFp32, TypeKind::kFp64, 1},
+    {TypeKind::kDate, TypeKind::kTimestamp, 1},
+    {TypeKind::kFixedChar, TypeKind::kVarchar, 1},
+    {TypeKind::kVarchar, TypeKind::kString, 1},
+    {TypeKind::kFixedBinary, TypeKind::kBinary, 1},
+};
+
+/// Close the direct casts transitively, keeping the cheapest path between
+/// every two kinds (Floyd-Warshall).
+constexpr auto makeImplicitCastCosts() {
+  std::array<std::array<ImplicitCastCost, kNumTypeKinds>, kNumTypeKinds>
+      costs{};
+  for (size_t from = 0; from < kNumTypeKinds; ++from) {
+    for (size_t to = 0; to < kNumTypeKinds; ++to) {
+      costs[from][to] = from == to ? 0 : kNoImplicitCast;
+    }
+  }
+  for (const auto& cast : kImplicitCasts) {
+    costs[static_cast<size_t>(cast.from)][static_cast<size_t>(cast.to)] =
+        cast.cost;
+  }
+  for (size_t via = 0; via < kNumTypeKinds; ++via) {
+    for (size_t from = 0; from < kNumTypeKinds; ++from) {
+      for (size_t to = 0; to < kNumTypeKinds; ++to) {
+        const auto first = costs[from][via];
+        const auto second = costs[via][to];
+        if (first == kNoImplicitCast || second == kNoImplicitCast) {
+          continue;
+        }
+        const auto cost = static_cast<ImplicitCastCost>(first + second);
+        if (costs[from][to] == kNoImplicitCast || cost < costs[from][to]) {
+          costs[from][to] = cost;
+        }
+      }
+    }
+  }
+  return costs;
+}
+
+} // namespace detail
+
+/// Costs of implicit casts between kinds, indexed by source and target kind.
+/// A kind casts to itself at no cost, the parameters of parameterized kinds
+/// are checked by TypeCoercion.
+inline constexpr auto kImplicitCastCosts = detail::makeImplicitCastCosts();
+
+constexpr ImplicitCastCost implicitCastCost(TypeKind from, TypeKind to) {
+  return kImplicitCastCosts[static_cast<size_t>(from)]
+                           [static_cast<size_t>(to)];
+}
+
+/// The lattice of implicit casts between types. On top of the kind casts of
+/// kImplicitCastCosts it widens parameters: a decimal to one with at least
+/// as many integral and fractional digits, a varchar or fixedchar to a
+/// varchar at least as long, and an integer to a decimal with room for all
+/// of its digits. Nested types cast element wise. A non-nullable type may be
+/// promoted to the nullable one at no cost, but never the other way round.
+class TypeCoercion final {
+ public:
+  /// Cost of implicitly casting a value of type from to type to, the sum of
+  /// the kind costs of all casts involved. std::nullopt if there is no
+  /// implicit cast.
+  static std::optional<int> cost(const Type& from, const Type& to);
+
+  /// The cheapest type both types implicitly cast to, their join in the
+  /// lattice, e.g. i64 for i32 and i64 or decimal<12,4> for decimal<10,2>
+  /// and decimal<6,4>. nullptr if there is none.
+  static TypePtr commonSupertype(const Type& left, const Type& right);
+
+  /// The interned types a type implicitly casts to, with the cost of the
+  /// casts in ascending order, starting with the type itself. Parameters are
+  /// kept as narrow as possible, e.g. i32 casts to decimal<10,0>; nested
+  /// types are returned as themselves only.
+  static std::vector<std::pair<TypePtr, int>> supertypes(const Type& type);
+};
+
+} // namespace io::substrait
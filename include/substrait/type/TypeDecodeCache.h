@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// A thread-safe memoizing cache in front of ParameterizedType::decode.
+/// Decoded types are immutable, so the same instance is handed out for every
+/// lookup of the same raw type string. The cache is split into shards, each
+/// guarded by its own mutex, to keep concurrent decoders from contending.
+class TypeDecodeCache {
+ public:
+  /// @param maxSize maximum number of cached types, 0 means unbounded. A
+  /// bounded cache evicts the least recently used type of a shard.
+  /// @param numShards number of independently locked shards.
+  explicit TypeDecodeCache(size_t maxSize = 0, size_t numShards = 16);
+
+  /// Decode the raw type string, or return the previously decoded type.
+  ParameterizedTypePtr decode(
+      const std::string& rawType,
+      bool isParameterized = true);
+
+  /// Number of lookups served from the cache.
+  [[nodiscard]] uint64_t hits() const;
+
+  /// Number of lookups which had to decode the raw type string.
+  [[nodiscard]] uint64_t misses() const;
+
+  /// Number of cached types.
+  [[nodiscard]] size_t size() const;
+
+  /// Drop all cached types and reset the counters.
+  void clear();
+
+ private:
+  struct LruEntry;
+
+  struct Entry {
+    ParameterizedTypePtr type;
+    /// Position in the recency list, only maintained if bounded.
+    std::list<LruEntry>::iterator lruPos;
+  };
+
+  /// Cached types keyed by raw string, one map per isParameterized flag.
+  using EntryMap = std::unordered_map<std::string, Entry>;
+
+  /// An entry in the recency list: the map holding it and its position. A
+  /// bounded map reserves room for all of its entries up front, so it never
+  /// rehashes, which would invalidate the positions.
+  struct LruEntry {
+    bool isParameterized;
+    EntryMap::iterator entry;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    EntryMap entries[2];
+    /// Most recently used entries first.
+    std::list<LruEntry> lru;
+    uint64_t hits{0};
+    uint64_t misses{0};
+  };
+
+  Shard& shardFor(const std::string& rawType);
+
+  const size_t maxSizePerShard_;
+  std::vector<Shard> shards_;
+};
+
+} // namespace io::substrait
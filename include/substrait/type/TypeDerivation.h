@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "substrait/type/Type.h"
+#include "substrait/type/TypeBindings.h"
+
+namespace io::substrait {
+
+/// A compiled return type derivation of an extension function, such as
+///
+///   init_scale = max(S1,S2)
+///   init_prec = init_scale + max(P1 - S1, P2 - S2) + 1
+///   prec = min(init_prec, 38)
+///   scale = init_prec > 38 ? max(init_scale - init_prec + 38, 6) : init_scale
+///   DECIMAL<prec, scale>
+///
+/// The program is parsed once into a small stack-based bytecode. Evaluating it
+/// against the placeholder bindings of a call only does integer arithmetic and
+/// a lookup of the resulting interned type.
+///
+/// Expressions support integer literals, placeholders and earlier assigned
+/// names, the operators + - * / < <= > >= == != && || ! and -, the ternary
+/// operator, parentheses, min(a, b) and max(a, b). The last line is a type:
+/// a decimal, varchar, fixedchar or fixedbinary whose parameters are
+/// expressions, a type placeholder such as any1, or a concrete type.
+class TypeDerivation {
+ public:
+  /// Compile a return type expression, either a single type or a program of
+  /// assignments followed by the resulting type on its last line.
+  /// @throws exception if the expression is malformed.
+  static std::shared_ptr<const TypeDerivation> compile(
+      std::string_view expression);
+
+  /// Derive the return type from the placeholder bindings of a call.
+  /// @throws exception if a placeholder is unbound, on division by zero, or
+  /// if the derived parameters are not valid for the resulting type.
+  [[nodiscard]] TypePtr evaluate(const TypeBindings& bindings) const;
+
+  /// The expression this derivation was compiled from.
+  [[nodiscard]] const std::string& expression() const {
+    return expression_;
+  }
+
+ private:
+  friend class TypeDerivationCompiler;
+
+  enum class OpCode : uint8_t {
+    kConstant,
+    kLoad,
+    kStore,
+    kAdd,
+    kSubtract,
+    kMultiply,
+    kDivide,
+    kMin,
+    kMax,
+    kLess,
+    kLessEqual,
+    kGreater,
+    kGreaterEqual,
+    kEqual,
+    kNotEqual,
+    kAnd,
+    kOr,
+    kNot,
+    kNegate,
+    /// Jump to the operand if the popped value is zero.
+    kJumpIfZero,
+    kJump,
+  };
+
+  struct Instruction {
+    OpCode op;
+    /// Constant value, slot or jump target.
+    int64_t operand;
+  };
+
+  static constexpr size_t kMaxSlots = 32;
+  static constexpr size_t kMaxStackDepth = 32;
+
+  TypeDerivation() = default;
+
+  /// Run the bytecode and store the parameters of the result in the result
+  /// slots.
+  void run(int64_t* slots) const;
+
+  std::vector<Instruction> code_;
+  struct Input {
+    std::string name;
+    size_t slot;
+  };
+
+  /// Integer placeholders read by the program, such as P1.
+  std::vector<Input> inputs_;
+  size_t numSlots_{0};
+
+  /// Kind of the resulting type, KIND_NOT_SET if it is a type placeholder
+  /// or constant.
+  TypeKind resultKind_{TypeKind::KIND_NOT_SET};
+  bool resultNullable_{false};
+  /// Slots holding the parameters of the resulting type.
+  std::vector<size_t> resultSlots_;
+  /// Type placeholder naming the resulting type, e.g. any1.
+  std::string resultPlaceholder_;
+  /// Resulting type if it does not depend on the bindings.
+  TypePtr resultType_;
+
+  std::string expression_;
+};
+
+using TypeDerivationPtr = std::shared_ptr<const TypeDerivation>;
+
+} // namespace io::substrait
@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <limits>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// A thread-safe pool of interned types. Types built through the factory are
+/// hash-consed: structurally equal types (including nullability and nested
+/// children) share one immutable object, so they can be compared by pointer
+/// and never freed while the process is running. As they are immortal, the
+/// factory hands them out as shared pointers without a control block, so
+/// copying them does not touch any reference count: their use_count() is 0
+/// and a weak_ptr to them expires right away.
+///
+/// Interned types cannot be freed, so the pool only grows, by one type per
+/// distinct type built. setCapacity bounds it for processes which see an
+/// unbounded variety of types, e.g. of user schemas.
+class TypeFactory {
+ public:
+  /// Return the process-wide type factory.
+  static TypeFactory& instance();
+
+  /// Return the interned scalar type of the given kind and nullability.
+  template <TypeKind Kind>
+  static std::shared_ptr<const ScalarType<Kind>> scalar(bool nullable = false) {
+    static const auto* const kNonNullable =
+        makeImmortal<ScalarType<Kind>>(false);
+    static const auto* const kNullable = makeImmortal<ScalarType<Kind>>(true);
+    return unowned(nullable ? kNullable : kNonNullable);
+  }
+
+  /// Return the interned scalar type of a kind only known at runtime,
+  /// nullptr if the kind is not a scalar kind.
+  static TypePtr scalarType(TypeKind kind, bool nullable = false);
+
+  std::shared_ptr<const Decimal>
+  decimal(int precision, int scale, bool nullable = false);
+
+  std::shared_ptr<const Varchar> varchar(int length, bool nullable = false);
+
+  std::shared_ptr<const FixedChar> fixedChar(int length, bool nullable = false);
+
+  std::shared_ptr<const FixedBinary> fixedBinary(
+      int length,
+      bool nullable = false);
+
+  std::shared_ptr<const List> list(
+      const TypePtr& elementType,
+      bool nullable = false);
+
+  std::shared_ptr<const Map> map(
+      const TypePtr& keyType,
+      const TypePtr& valueType,
+      bool nullable = false);
+
+  std::shared_ptr<const Struct> structType(
+      const std::vector<TypePtr>& children,
+      bool nullable = false);
+
+  std::shared_ptr<const Struct> structType(
+      const TypeArray& children,
+      bool nullable = false);
+
+  /// Return the interned type structurally equal to the given one, interning
+  /// it together with all of its children if it was not seen before.
+  TypePtr intern(const TypePtr& type);
+
+  /// Same as above for a type which is not owned by a shared pointer, e.g. a
+  /// borrowed one.
+  TypePtr intern(const Type& type);
+
+  /// Return the interned type equal to the given one except for its own
+  /// nullability. The parameters and children are shared with the given
+  /// type if it is interned. The two nullability variants of an interned
+  /// type are linked to each other on first use, so flipping nullability is
+  /// a single pointer load afterwards.
+  TypePtr withNullable(const Type& type, bool nullable);
+
+  /// Number of interned non-scalar types.
+  [[nodiscard]] size_t size() const;
+
+  /// Limit the number of interned non-scalar types, unlimited by default.
+  /// Once the pool is full, new types are built with a control block of
+  /// their own and freed once unused. They are not interned: equal ones are
+  /// distinct objects, compared structurally. Types interned before stay.
+  void setCapacity(size_t capacity);
+
+ private:
+  TypeFactory() = default;
+
+  /// Structural key of a type whose children are already interned.
+  struct Shape;
+
+  /// Create a type which is never freed.
+  template <typename T, typename... Args>
+  static const T* makeImmortal(Args&&... args) {
+    auto* type = new T(std::forward<Args>(args)...);
+    type->interned_ = true;
+    return type;
+  }
+
+  /// Shared pointer to an immortal type without a control block.
+  template <typename T>
+  static std::shared_ptr<const T> unowned(const T* type) {
+    return std::shared_ptr<const T>(std::shared_ptr<const T>(), type);
+  }
+
+  /// Find an interned type with the given shape, nullptr if there is none.
+  const Type* find(size_t hash, const Shape& shape) const;
+
+  /// Intern a type with the given nullability instead of its own.
+  TypePtr internAs(const Type& type, bool nullable);
+
+  template <typename Children>
+  std::shared_ptr<const Struct> makeStructType(
+      const Children& children,
+      bool nullable);
+
+  /// Return the interned type with the given shape, creating it if needed.
+  template <typename T, typename Creator>
+  std::shared_ptr<const T> getOrCreate(Shape shape, Creator creator);
+
+  mutable std::shared_mutex mutex_;
+
+  /// Maximum number of types_.
+  size_t capacity_{std::numeric_limits<size_t>::max()};
+
+  /// Interned types bucketed by structural hash.
+  std::unordered_multimap<size_t, TypePtr> types_;
+};
+
+} // namespace io::substrait
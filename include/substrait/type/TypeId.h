@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// A compact value representation of scalar, decimal, varchar, fixedchar and
+/// fixedbinary types packed into 64 bits:
+///
+///   bits  0-7   TypeKind
+///   bit   8     nullability
+///   bits 16-31  second parameter (decimal scale)
+///   bits 32-63  first parameter (decimal precision or length)
+///
+/// Matching, hashing and equality only look at the packed bits. Nested and
+/// parameterized types have no TypeId, use the Type hierarchy for them.
+class TypeId {
+ public:
+  /// A TypeId of kind KIND_NOT_SET.
+  constexpr TypeId() = default;
+
+  /// Recreate a TypeId from its packed representation, see value().
+  static constexpr TypeId fromValue(uint64_t value) {
+    return TypeId(value);
+  }
+
+  /// The TypeId of a scalar kind, i.e. a kind without parameters.
+  static constexpr TypeId scalar(TypeKind kind, bool nullable = false) {
+    return pack(kind, nullable, 0, 0);
+  }
+
+  static constexpr TypeId
+  decimal(uint32_t precision, uint16_t scale, bool nullable = false) {
+    return pack(TypeKind::kDecimal, nullable, precision, scale);
+  }
+
+  static constexpr TypeId varchar(uint32_t length, bool nullable = false) {
+    return pack(TypeKind::kVarchar, nullable, length, 0);
+  }
+
+  static constexpr TypeId fixedChar(uint32_t length, bool nullable = false) {
+    return pack(TypeKind::kFixedChar, nullable, length, 0);
+  }
+
+  static constexpr TypeId fixedBinary(uint32_t length, bool nullable = false) {
+    return pack(TypeKind::kFixedBinary, nullable, length, 0);
+  }
+
+  /// Pack the given type, std::nullopt if it is nested, parameterized or has
+  /// a negative or out of range parameter.
+  static std::optional<TypeId> tryFrom(const ParameterizedType& type);
+
+  /// Return the interned type equal to this TypeId.
+  /// @throws exception if the kind is not set.
+  [[nodiscard]] TypePtr toType() const;
+
+  [[nodiscard]] constexpr uint64_t value() const {
+    return value_;
+  }
+
+  [[nodiscard]] constexpr TypeKind kind() const {
+    return static_cast<TypeKind>(value_ & kKindMask);
+  }
+
+  [[nodiscard]] constexpr bool nullable() const {
+    return (value_ & kNullableMask) != 0;
+  }
+
+  /// Precision of a decimal or length of a varchar, fixedchar or fixedbinary.
+  [[nodiscard]] constexpr uint32_t first() const {
+    return static_cast<uint32_t>(value_ >> kFirstShift);
+  }
+
+  /// Scale of a decimal.
+  [[nodiscard]] constexpr uint16_t second() const {
+    return static_cast<uint16_t>(value_ >> kSecondShift);
+  }
+
+  /// Same as ParameterizedType::isMatch for the packed types: same kind and
+  /// parameters, and a non-nullable type does not match a nullable one.
+  [[nodiscard]] constexpr bool isMatch(TypeId type) const {
+    return ((value_ ^ type.value_) & ~kNullableMask) == 0 &&
+        ((value_ | ~type.value_) & kNullableMask) != 0;
+  }
+
+  /// 64-bit hash of the packed bits.
+  [[nodiscard]] constexpr uint64_t hash() const {
+    // Finalizer of MurmurHash3.
+    uint64_t hash = value_;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  constexpr bool operator==(TypeId other) const {
+    return value_ == other.value_;
+  }
+
+  constexpr bool operator!=(TypeId other) const {
+    return value_ != other.value_;
+  }
+
+ private:
+  static constexpr uint64_t kKindMask = 0xff;
+  static constexpr uint64_t kNullableMask = 1ULL << 8;
+  static constexpr int kSecondShift = 16;
+  static constexpr int kFirstShift = 32;
+
+  constexpr explicit TypeId(uint64_t value) : value_(value) {}
+
+  static constexpr TypeId
+  pack(TypeKind kind, bool nullable, uint32_t first, uint16_t second) {
+    return TypeId(
+        static_cast<uint64_t>(static_cast<uint8_t>(kind)) |
+        (nullable ? kNullableMask : 0) |
+        (static_cast<uint64_t>(second) << kSecondShift) |
+        (static_cast<uint64_t>(first) << kFirstShift));
+  }
+
+  uint64_t value_{0};
+};
+
+static_assert(sizeof(TypeId) == sizeof(uint64_t));
+
+} // namespace io::substrait
+
+template <>
+struct std::hash<io::substrait::TypeId> {
+  size_t operator()(io::substrait::TypeId typeId) const {
+    return typeId.hash();
+  }
+};
@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "substrait/type/Type.h"
+
+namespace google::protobuf {
+class Arena;
+} // namespace google::protobuf
+
+namespace substrait::proto {
+class Type;
+} // namespace substrait::proto
+
+namespace io::substrait {
+
+/// Converts between substrait::proto::Type messages and the Type hierarchy.
+/// Both directions walk the structure directly without going through type
+/// strings.
+class TypeProtoConverter final {
+ public:
+  /// Convert a proto type to the interned type of the TypeFactory.
+  /// @throws SubstraitException if the proto type is not set or is a user
+  /// defined type.
+  static TypePtr fromProto(const ::substrait::proto::Type& proto);
+
+  /// Convert a type to a proto type allocated on the given arena, which the
+  /// nested messages are allocated on too. A null arena allocates on the
+  /// heap and the caller owns the result.
+  /// @throws SubstraitException if the type kind has no proto counterpart.
+  static ::substrait::proto::Type* toProto(
+      const Type& type,
+      google::protobuf::Arena* arena);
+
+  /// Same as above filling in a caller supplied message, which is cleared
+  /// first.
+  static void toProto(const Type& type, ::substrait::proto::Type& proto);
+};
+
+} // namespace io::substrait
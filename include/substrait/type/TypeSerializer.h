@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// Compact binary encoding of types, concrete and parameterized ones, for
+/// plan caches and IPC. A type is encoded depth first, every node starts
+/// with a tag byte:
+///
+///   bits 0-4  TypeKind, KIND_NOT_SET for a string literal
+///   bit  5    nullability, for a string literal whether it is a wildcard
+///   bit  6    whether the type is parameterized
+///   bit  7    for a string literal whether it is a placeholder
+///
+/// followed by the parameters of the kind: unsigned LEB128 varints for the
+/// precision and scale of a decimal or the length of a varchar, fixedchar or
+/// fixedbinary, the varint size and bytes of a string literal, and the
+/// children of nested types, a struct prefixed by its varint child count.
+/// Parameters of parameterized types are encoded as string literal nodes.
+///
+/// The encoding is stable and independent of the platform.
+class TypeSerializer final {
+ public:
+  /// Append the encoding of a type to out.
+  static void serialize(const ParameterizedType& type, std::string& out);
+
+  static std::string serialize(const ParameterizedType& type) {
+    std::string out;
+    serialize(type, out);
+    return out;
+  }
+
+  /// Decode the type at the cursor, advancing the cursor past it, e.g. to
+  /// read consecutive types straight from a memory mapped buffer. Concrete
+  /// types are returned interned by the TypeFactory. Their encoding is
+  /// canonical, so an encoding decoded before is resolved by a single lookup
+  /// of its bytes. Parameterized types are decoded afresh.
+  /// @throws SubstraitException if the bytes are truncated or malformed.
+  static ParameterizedTypePtr deserialize(
+      const uint8_t*& cursor,
+      const uint8_t* end);
+
+  /// Decode a buffer holding exactly one encoded type.
+  /// @throws SubstraitException if the bytes are truncated or malformed, or
+  /// if bytes are left over.
+  static ParameterizedTypePtr deserialize(std::string_view bytes);
+};
+
+} // namespace io::substrait
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/Type.h"
+
+namespace io::substrait {
+
+/// Combine lambdas into a single visitor, e.g.
+///
+///   visit(type, Overloaded{
+///       [](const Decimal& decimal) { return decimal.precision(); },
+///       [](const auto&) { return 0; }});
+///
+/// Overloads taking a class win over a generic lambda, which in turn wins
+/// over an overload taking a base class such as `const Type&`.
+template <typename... Visitors>
+struct Overloaded : Visitors... {
+  using Visitors::operator()...;
+};
+
+template <typename... Visitors>
+Overloaded(Visitors...) -> Overloaded<Visitors...>;
+
+/// Call the visitor with a concrete type cast to its class, such as
+/// `const Decimal&` or `const ScalarType<TypeKind::kI32>&`. The class is
+/// chosen by a switch over the kind tag, which compiles to a jump table, so
+/// there is no RTTI or virtual call involved. Classes of the hierarchy expose
+/// their kind as T::kKind for generic visitors. All overloads of the visitor
+/// have to return the same type.
+template <typename Visitor>
+decltype(auto) visit(const Type& type, Visitor&& visitor) {
+  switch (type.kind()) {
+    case TypeKind::kBool:
+      return visitor(cast<ScalarType<TypeKind::kBool>>(type));
+    case TypeKind::kI8:
+      return visitor(cast<ScalarType<TypeKind::kI8>>(type));
+    case TypeKind::kI16:
+      return visitor(cast<ScalarType<TypeKind::kI16>>(type));
+    case TypeKind::kI32:
+      return visitor(cast<ScalarType<TypeKind::kI32>>(type));
+    case TypeKind::kI64:
+      return visitor(cast<ScalarType<TypeKind::kI64>>(type));
+    case TypeKind::kFp32:
+      return visitor(cast<ScalarType<TypeKind::kFp32>>(type));
+    case TypeKind::kFp64:
+      return visitor(cast<ScalarType<TypeKind::kFp64>>(type));
+    case TypeKind::kString:
+      return visitor(cast<ScalarType<TypeKind::kString>>(type));
+    case TypeKind::kBinary:
+      return visitor(cast<ScalarType<TypeKind::kBinary>>(type));
+    case TypeKind::kTimestamp:
+      return visitor(cast<ScalarType<TypeKind::kTimestamp>>(type));
+    case TypeKind::kDate:
+      return visitor(cast<ScalarType<TypeKind::kDate>>(type));
+    case TypeKind::kTime:
+      return visitor(cast<ScalarType<TypeKind::kTime>>(type));
+    case TypeKind::kIntervalYear:
+      return visitor(cast<ScalarType<TypeKind::kIntervalYear>>(type));
+    case TypeKind::kIntervalDay:
+      return visitor(cast<ScalarType<TypeKind::kIntervalDay>>(type));
+    case TypeKind::kTimestampTz:
+      return visitor(cast<ScalarType<TypeKind::kTimestampTz>>(type));
+    case TypeKind::kUuid:
+      return visitor(cast<ScalarType<TypeKind::kUuid>>(type));
+    case TypeKind::kFixedChar:
+      return visitor(cast<FixedChar>(type));
+    case TypeKind::kVarchar:
+      return visitor(cast<Varchar>(type));
+    case TypeKind::kFixedBinary:
+      return visitor(cast<FixedBinary>(type));
+    case TypeKind::kDecimal:
+      return visitor(cast<Decimal>(type));
+    case TypeKind::kStruct:
+      return visitor(cast<Struct>(type));
+    case TypeKind::kList:
+      return visitor(cast<List>(type));
+    case TypeKind::kMap:
+      return visitor(cast<Map>(type));
+    default:
+      SUBSTRAIT_UNREACHABLE("Concrete type without a kind");
+  }
+}
+
+/// Same as above for any type, parameterized types of function declarations
+/// are passed as their class too, e.g. `const ParameterizedDecimal&` or
+/// `const StringLiteral&`.
+template <typename Visitor>
+decltype(auto) visit(const ParameterizedType& type, Visitor&& visitor) {
+  if (!type.isParameterized()) {
+    return visit(cast<Type>(type), std::forward<Visitor>(visitor));
+  }
+  switch (type.kind()) {
+    case TypeKind::KIND_NOT_SET:
+      return visitor(cast<StringLiteral>(type));
+    case TypeKind::kFixedChar:
+      return visitor(cast<ParameterizedFixedChar>(type));
+    case TypeKind::kVarchar:
+      return visitor(cast<ParameterizedVarchar>(type));
+    case TypeKind::kFixedBinary:
+      return visitor(cast<ParameterizedFixedBinary>(type));
+    case TypeKind::kDecimal:
+      return visitor(cast<ParameterizedDecimal>(type));
+    case TypeKind::kStruct:
+      return visitor(cast<ParameterizedStruct>(type));
+    case TypeKind::kList:
+      return visitor(cast<ParameterizedList>(type));
+    case TypeKind::kMap:
+      return visitor(cast<ParameterizedMap>(type));
+    default:
+      SUBSTRAIT_UNREACHABLE("Parameterized type of a scalar kind");
+  }
+}
+
+} // namespace io::substrait
@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstdint>
+
+namespace io::substrait::common {
+
+class HashUtils final {
+ public:
+  /// Mix a value into a 64-bit hash seed, as in boost::hash_combine.
+  static uint64_t hashCombine(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+  }
+};
+
+} // namespace io::substrait::common
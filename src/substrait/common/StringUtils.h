@@ -3,6 +3,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cctype>
 #include <string_view>
 
 namespace io::substrait::common {
@@ -22,6 +23,15 @@ class StringUtils final {
     return rtrim(ltrim(s));
   }
 
+  /// Compare two ASCII strings ignoring case, without allocating.
+  static bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+    return lhs.size() == rhs.size() &&
+        std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char l, char r) {
+             return std::tolower(static_cast<unsigned char>(l)) ==
+                 std::tolower(static_cast<unsigned char>(r));
+           });
+  }
+
   static constexpr std::string_view kWhitespace = " \n\r\t\f\v";
 };
 
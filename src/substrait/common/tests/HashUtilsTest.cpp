@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include "substrait/common/HashUtils.h"
+
+using namespace io::substrait::common;
+
+class HashUtilsTest : public ::testing::Test {};
+
+TEST_F(HashUtilsTest, hashCombine) {
+  ASSERT_EQ(HashUtils::hashCombine(1, 2), HashUtils::hashCombine(1, 2));
+  ASSERT_NE(HashUtils::hashCombine(1, 2), HashUtils::hashCombine(2, 1));
+  ASSERT_NE(HashUtils::hashCombine(0, 0), 0);
+}
@@ -29,3 +29,11 @@ TEST_F(StringUtilsTest, trim) {
   ASSERT_EQ(StringUtils::trim(" 1 1 "), "1 1");
   ASSERT_EQ(StringUtils::trim(" "), "");
 }
+
+TEST_F(StringUtilsTest, equalsIgnoreCase) {
+  ASSERT_TRUE(StringUtils::equalsIgnoreCase("decimal", "DECIMAL"));
+  ASSERT_TRUE(StringUtils::equalsIgnoreCase("Timestamp_TZ", "timestamp_tz"));
+  ASSERT_TRUE(StringUtils::equalsIgnoreCase("", ""));
+  ASSERT_FALSE(StringUtils::equalsIgnoreCase("i32", "i64"));
+  ASSERT_FALSE(StringUtils::equalsIgnoreCase("list", "lists"));
+}
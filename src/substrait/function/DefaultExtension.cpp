@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/function/ExtensionSnapshot.h"
+
+#ifdef SUBSTRAIT_CPP_EMBED_DEFAULT_EXTENSIONS
+// Defines kDefaultExtensionSnapshot, the snapshot of the default extension
+// files generated at build time.
+#include "DefaultExtensionSnapshot.inc"
+#endif
+
+namespace io::substrait {
+
+ExtensionPtr Extension::loadDefault() {
+#ifdef SUBSTRAIT_CPP_EMBED_DEFAULT_EXTENSIONS
+  static const auto extension =
+      ExtensionSnapshot::openBuffer(std::string_view(
+          reinterpret_cast<const char*>(kDefaultExtensionSnapshot),
+          sizeof(kDefaultExtensionSnapshot)));
+  return extension;
+#else
+  SUBSTRAIT_UNSUPPORTED(
+      "The default extensions are not embedded, build with "
+      "SUBSTRAIT_CPP_EMBED_DEFAULT_EXTENSIONS");
+#endif
+}
+
+} // namespace io::substrait
@@ -1,144 +1,21 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 
 #include <yaml-cpp/yaml.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include "substrait/common/Exceptions.h"
 #include "substrait/function/Extension.h"
-
-bool decodeFunctionImpl(
-    const YAML::Node& node,
-    io::substrait::FunctionImplementation& function) {
-  const auto& returnType = node["return"];
-  if (returnType && returnType.IsScalar()) {
-    /// Return type can be an expression.
-    const auto& returnExpr = returnType.as<std::string>();
-    std::stringstream ss(returnExpr);
-
-    // TODO: currently we only parse the last sentence of type definition, use
-    // ANTLR in future.
-    std::string lastReturnType;
-    while (std::getline(ss, lastReturnType, '\n')) {
-    }
-    function.returnType = io::substrait::ParameterizedType::decode(lastReturnType);
-  }
-  const auto& args = node["args"];
-  if (args && args.IsSequence()) {
-    for (auto& arg : args) {
-      if (arg["options"]) { // enum argument
-        auto enumArgument = std::make_shared<io::substrait::EnumArgument>(
-            arg.as<io::substrait::EnumArgument>());
-        function.arguments.emplace_back(enumArgument);
-      } else if (arg["value"]) { // value argument
-        auto valueArgument = std::make_shared<io::substrait::ValueArgument>(
-            arg.as<io::substrait::ValueArgument>());
-        function.arguments.emplace_back(valueArgument);
-      } else { // type argument
-        auto typeArgument = std::make_shared<io::substrait::TypeArgument>(
-            arg.as<io::substrait::TypeArgument>());
-        function.arguments.emplace_back(typeArgument);
-      }
-    }
-  }
-
-  const auto& variadic = node["variadic"];
-  if (variadic) {
-    auto& min = variadic["min"];
-    auto& max = variadic["max"];
-    if (min) {
-      function.variadic = std::make_optional<io::substrait::FunctionVariadic>(
-          {min.as<int>(),
-           max ? std::make_optional<int>(max.as<int>()) : std::nullopt});
-    } else {
-      function.variadic = std::nullopt;
-    }
-  } else {
-    function.variadic = std::nullopt;
-  }
-
-  return true;
-}
-
-template <>
-struct YAML::convert<io::substrait::EnumArgument> {
-  static bool decode(const Node& node, io::substrait::EnumArgument& argument) {
-    // 'options' is required property
-    const auto& options = node["options"];
-    if (options && options.IsSequence()) {
-      auto& required = node["required"];
-      argument.required = required && required.as<bool>();
-      return true;
-    } else {
-      return false;
-    }
-  }
-};
-
-template <>
-struct YAML::convert<io::substrait::ValueArgument> {
-  static bool decode(const Node& node, io::substrait::ValueArgument& argument) {
-    const auto& value = node["value"];
-    if (value && value.IsScalar()) {
-      auto valueType = value.as<std::string>();
-      argument.type = io::substrait::ParameterizedType::decode(valueType);
-      return true;
-    }
-    return false;
-  }
-};
-
-template <>
-struct YAML::convert<io::substrait::TypeArgument> {
-  static bool decode(
-      const YAML::Node& node,
-      io::substrait::TypeArgument& argument) {
-    // no properties need to populate for type argument, just return true if
-    // 'type' element exists.
-    if (node["type"]) {
-      return true;
-    }
-    return false;
-  }
-};
-
-template <>
-struct YAML::convert<io::substrait::ScalarFunctionImplementation> {
-  static bool decode(
-      const Node& node,
-      io::substrait::ScalarFunctionImplementation& function) {
-    return decodeFunctionImpl(node, function);
-  };
-};
-
-template <>
-struct YAML::convert<io::substrait::AggregateFunctionImplementation> {
-  static bool decode(
-      const Node& node,
-      io::substrait::AggregateFunctionImplementation& function) {
-    const auto& res = decodeFunctionImpl(node, function);
-    if (res) {
-      const auto& intermediate = node["intermediate"];
-      if (intermediate) {
-        function.intermediate =
-            io::substrait::ParameterizedType::decode(intermediate.as<std::string>());
-      }
-    }
-    return res;
-  }
-};
-
-template <>
-struct YAML::convert<io::substrait::TypeVariant> {
-  static bool decode(const Node& node, io::substrait::TypeVariant& typeAnchor) {
-    const auto& name = node["name"];
-    if (name && name.IsScalar()) {
-      typeAnchor.name = name.as<std::string>();
-      return true;
-    }
-    return false;
-  }
-};
+#include "substrait/function/ExtensionDecoder.h"
 
 namespace io::substrait {
 
-std::shared_ptr<Extension> Extension::load(const std::string& basePath) {
+const std::vector<std::string>& Extension::defaultExtensionFiles() {
   static const std::vector<std::string> extensionFiles{
       "functions_aggregate_approx.yaml",
       "functions_aggregate_generic.yaml",
@@ -152,10 +29,12 @@ std::shared_ptr<Extension> Extension::load(const std::string& basePath) {
       "functions_string.yaml",
       "functions_set.yaml",
   };
-  return load(basePath, extensionFiles);
+  return extensionFiles;
 }
 
-std::shared_ptr<Extension> Extension::load(
+namespace {
+
+std::vector<std::string> resolveExtensionFiles(
     const std::string& basePath,
     const std::vector<std::string>& extensionFiles) {
   std::vector<std::string> yamlExtensionFiles;
@@ -165,61 +44,317 @@ std::shared_ptr<Extension> Extension::load(
     const auto& extensionUri = basePath.substr(0, pos) + "/" + extensionFile;
     yamlExtensionFiles.emplace_back(extensionUri);
   }
-  return load(yamlExtensionFiles);
+  return yamlExtensionFiles;
+}
+
+} // namespace
+
+std::shared_ptr<Extension> Extension::load(const std::string& basePath) {
+  return load(basePath, defaultExtensionFiles());
 }
 
+std::shared_ptr<Extension> Extension::load(
+    const std::string& basePath,
+    const std::vector<std::string>& extensionFiles) {
+  return load(resolveExtensionFiles(basePath, extensionFiles));
+}
+
+namespace {
+
+std::string readExtensionFile(const std::string& extensionUri) {
+  std::ifstream file(extensionUri, std::ios::binary);
+  if (!file) {
+    throw YAML::BadFile(extensionUri);
+  }
+  std::ostringstream content;
+  content << file.rdbuf();
+  return std::move(content).str();
+}
+
+/// Parse one extension file into the given extension.
+void loadExtensionFile(const std::string& extensionUri, Extension& extension) {
+  ExtensionDecoder::decodeFile(
+      readExtensionFile(extensionUri), extensionUri, extension);
+}
+
+/// Function implementations of an extension file, decoded from the byte
+/// ranges found by ExtensionDecoder::indexFile.
+class ExtensionFileSource final : public FunctionImplSource {
+ public:
+  ExtensionFileSource(std::string extensionUri, std::string content)
+      : extensionUri_(std::move(extensionUri)), content_(std::move(content)) {}
+
+  const std::string& content() const {
+    return content_;
+  }
+
+  void decode(
+      FunctionKind kind,
+      const std::string& /* name */,
+      uint64_t offset,
+      uint64_t size,
+      std::vector<FunctionImplementationPtr>& impls) const override {
+    // The range is a sequence of exactly the one function.
+    ExtensionDecoder::decodeFunctions(
+        std::string_view(content_).substr(offset, size),
+        kind,
+        extensionUri_,
+        impls);
+  }
+
+ private:
+  const std::string extensionUri_;
+  const std::string content_;
+};
+
+/// Run the tasks on up to hardware_concurrency threads.
+void runOnThreads(size_t numTasks, const std::function<void(size_t)>& task) {
+  if (numTasks == 0) {
+    return;
+  }
+  const size_t numThreads = std::min<size_t>(
+      numTasks, std::max(1U, std::thread::hardware_concurrency()));
+  std::atomic<size_t> next{0};
+  const auto worker = [&]() {
+    for (auto i = next++; i < numTasks; i = next++) {
+      task(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  // Join the started threads however this returns, e.g. if starting another
+  // thread throws, as destroying a joinable thread terminates the process.
+  struct JoinGuard {
+    std::vector<std::thread>& threads;
+    ~JoinGuard() {
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+  } joinGuard{threads};
+  threads.reserve(numThreads - 1);
+  for (size_t i = 1; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+}
+
+} // namespace
+
 std::shared_ptr<Extension> Extension::load(
     const std::vector<std::string>& extensionFiles) {
   auto extension = std::make_shared<Extension>();
   for (const auto& extensionUri : extensionFiles) {
-    const auto& node = YAML::LoadFile(extensionUri);
-
-    const auto& scalarFunctions = node["scalar_functions"];
-    if (scalarFunctions && scalarFunctions.IsSequence()) {
-      for (auto& scalarFunctionNode : scalarFunctions) {
-        const auto functionName = scalarFunctionNode["name"].as<std::string>();
-        for (auto& scalaFunctionImplNode : scalarFunctionNode["impls"]) {
-          auto scalarFunctionImpl =
-              scalaFunctionImplNode.as<ScalarFunctionImplementation>();
-          scalarFunctionImpl.name = functionName;
-          scalarFunctionImpl.uri = extensionUri;
-          extension->addScalarFunctionImpl(
-              std::make_shared<ScalarFunctionImplementation>(
-                  scalarFunctionImpl));
-        }
-      }
+    loadExtensionFile(extensionUri, *extension);
+  }
+  return extension;
+}
+
+std::shared_ptr<const Extension> Extension::loadLazy(
+    const std::vector<std::string>& extensionFiles) {
+  auto extension = std::make_shared<Extension>();
+  std::vector<ExtensionDecoder::FunctionDeclaration> functions;
+  for (const auto& extensionUri : extensionFiles) {
+    auto source = std::make_shared<ExtensionFileSource>(
+        extensionUri, readExtensionFile(extensionUri));
+    functions.clear();
+    ExtensionDecoder::indexFile(
+        source->content(), extensionUri, *extension, functions);
+    for (const auto& function : functions) {
+      extension->addLazyFunctionImpls(
+          function.kind,
+          function.name,
+          source,
+          function.offset,
+          function.size);
+    }
+  }
+  return extension;
+}
+
+std::shared_ptr<const Extension> Extension::loadLazy(
+    const std::string& basePath) {
+  return loadLazy(resolveExtensionFiles(basePath, defaultExtensionFiles()));
+}
+
+std::shared_ptr<Extension> Extension::load(
+    const std::vector<std::string>& extensionFiles,
+    const Executor& executor) {
+  const auto numFiles = extensionFiles.size();
+  std::vector<Extension> partials(numFiles);
+  std::vector<std::exception_ptr> errors(numFiles);
+  const auto parse = [&](size_t i) {
+    try {
+      loadExtensionFile(extensionFiles[i], partials[i]);
+    } catch (...) {
+      errors[i] = std::current_exception();
     }
+  };
 
-    const auto& aggregateFunctions = node["aggregate_functions"];
-    if (aggregateFunctions && aggregateFunctions.IsSequence()) {
-      for (auto& aggregateFunctionNode : aggregateFunctions) {
-        const auto functionName =
-            aggregateFunctionNode["name"].as<std::string>();
-        for (auto& aggregateFunctionImplNode :
-             aggregateFunctionNode["impls"]) {
-          auto aggregateFunctionImpl =
-              aggregateFunctionImplNode.as<AggregateFunctionImplementation>();
-          aggregateFunctionImpl.name = functionName;
-          aggregateFunctionImpl.uri = extensionUri;
-          extension->addAggregateFunctionImpl(
-              std::make_shared<AggregateFunctionImplementation>(
-                  aggregateFunctionImpl));
-        }
+  if (executor) {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t pending = numFiles;
+    const auto finish = [&](size_t count) {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending -= count;
+      if (pending == 0) {
+        done.notify_all();
+      }
+    };
+    std::exception_ptr submitError;
+    for (size_t i = 0; i < numFiles; ++i) {
+      try {
+        executor([&, i]() {
+          parse(i);
+          finish(1);
+        });
+      } catch (...) {
+        // Wait for the submitted tasks, they reference the partials.
+        submitError = std::current_exception();
+        finish(numFiles - i);
+        break;
       }
     }
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return pending == 0; });
+    if (submitError) {
+      std::rethrow_exception(submitError);
+    }
+  } else {
+    runOnThreads(numFiles, parse);
+  }
 
-    const auto& types = node["types"];
-    if (types && types.IsSequence()) {
-      for (auto& type : types) {
-        auto typeAnchor = type.as<TypeVariant>();
-        typeAnchor.uri = extensionUri;
-        extension->addTypeVariant(std::make_shared<TypeVariant>(typeAnchor));
-      }
+  auto extension = std::make_shared<Extension>();
+  for (size_t i = 0; i < numFiles; ++i) {
+    if (errors[i]) {
+      std::rethrow_exception(errors[i]);
     }
+    extension->merge(partials[i]);
   }
   return extension;
 }
 
+void Extension::merge(const Extension& other) {
+  for (const auto kind :
+       {FunctionKind::kScalar,
+        FunctionKind::kAggregate,
+        FunctionKind::kWindow}) {
+    auto& merged = eagerFunctionImplMap(kind);
+    for (const auto& [name, impls] : other.functionImplMap(kind)) {
+      auto& mergedImpls = merged[name];
+      mergedImpls.insert(mergedImpls.end(), impls.begin(), impls.end());
+    }
+  }
+  // Like addTypeVariant, a type variant added first is kept.
+  typeVariantMap_.insert(
+      other.typeVariantMap_.begin(), other.typeVariantMap_.end());
+}
+
+struct Extension::LazyFunctions {
+  static constexpr size_t kNumKinds = 3;
+
+  struct Location {
+    const FunctionImplSource* source;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  struct Function {
+    std::vector<Location> locations;
+    std::once_flag decoded;
+    std::vector<FunctionImplementationPtr> impls;
+  };
+
+  /// Owns the sources the locations point into.
+  std::vector<std::shared_ptr<const FunctionImplSource>> sources;
+  std::array<std::unordered_map<std::string, Function>, kNumKinds> functions;
+
+  /// All functions, decoded on the first request of a whole map.
+  std::once_flag allDecoded;
+  std::array<FunctionImplMap, kNumKinds> allFunctions;
+
+  const std::vector<FunctionImplementationPtr>&
+  decode(FunctionKind kind, const std::string& name, Function& function) {
+    std::call_once(function.decoded, [&]() {
+      // Decode into a local, so a failed decoding leaves nothing behind and
+      // is retried by the next lookup.
+      std::vector<FunctionImplementationPtr> impls;
+      for (const auto& location : function.locations) {
+        location.source->decode(
+            kind, name, location.offset, location.size, impls);
+      }
+      function.impls = std::move(impls);
+    });
+    return function.impls;
+  }
+};
+
+void Extension::addLazyFunctionImpls(
+    FunctionKind kind,
+    const std::string& name,
+    const std::shared_ptr<const FunctionImplSource>& source,
+    uint64_t offset,
+    uint64_t size) {
+  if (!lazy_) {
+    lazy_ = std::make_shared<LazyFunctions>();
+  }
+  if (lazy_->sources.empty() || lazy_->sources.back() != source) {
+    lazy_->sources.emplace_back(source);
+  }
+  auto& function = lazy_->functions[static_cast<size_t>(kind)][name];
+  function.locations.push_back({source.get(), offset, size});
+}
+
+const std::vector<FunctionImplementationPtr>* Extension::findFunctionImpls(
+    FunctionKind kind,
+    const std::string& name) const {
+  if (lazy_) {
+    auto& functions = lazy_->functions[static_cast<size_t>(kind)];
+    auto it = functions.find(name);
+    return it != functions.end() ? &lazy_->decode(kind, name, it->second)
+                                 : nullptr;
+  }
+  const auto& functionImpls = functionImplMap(kind);
+  auto it = functionImpls.find(name);
+  return it != functionImpls.end() ? &it->second : nullptr;
+}
+
+const FunctionImplMap& Extension::functionImplMap(FunctionKind kind) const {
+  if (lazy_) {
+    std::call_once(lazy_->allDecoded, [this]() {
+      for (size_t i = 0; i < LazyFunctions::kNumKinds; ++i) {
+        const auto functionKind = static_cast<FunctionKind>(i);
+        for (auto& [name, function] : lazy_->functions[i]) {
+          lazy_->allFunctions[i].emplace(
+              name, lazy_->decode(functionKind, name, function));
+        }
+      }
+    });
+    return lazy_->allFunctions[static_cast<size_t>(kind)];
+  }
+  switch (kind) {
+    case FunctionKind::kScalar:
+      return scalarFunctionImplMap_;
+    case FunctionKind::kAggregate:
+      return aggregateFunctionImplMap_;
+    case FunctionKind::kWindow:
+      return windowFunctionImplMap_;
+  }
+  SUBSTRAIT_UNREACHABLE("Unknown function kind");
+}
+
+FunctionImplMap& Extension::eagerFunctionImplMap(FunctionKind kind) {
+  switch (kind) {
+    case FunctionKind::kScalar:
+      return scalarFunctionImplMap_;
+    case FunctionKind::kAggregate:
+      return aggregateFunctionImplMap_;
+    case FunctionKind::kWindow:
+      return windowFunctionImplMap_;
+  }
+  SUBSTRAIT_UNREACHABLE("Unknown function kind");
+}
+
 void Extension::addWindowFunctionImpl(
     const FunctionImplementationPtr& functionImpl) {
   const auto& functionImpls =
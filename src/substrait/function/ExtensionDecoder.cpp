@@ -0,0 +1,562 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/function/ExtensionDecoder.h"
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+#include <istream>
+#include <optional>
+#include <streambuf>
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeDecodeCache.h"
+
+namespace io::substrait {
+
+namespace {
+
+/// The same type strings repeat across function implementations and extension
+/// files, so each of them is decoded once per process.
+ParameterizedTypePtr decodeType(const std::string& rawType) {
+  static TypeDecodeCache cache(4096);
+  return cache.decode(rawType);
+}
+
+/// Reads the parser input in place.
+class StringViewBuffer final : public std::streambuf {
+ public:
+  explicit StringViewBuffer(std::string_view yaml) {
+    auto* begin = const_cast<char*>(yaml.data());
+    setg(begin, begin, begin + yaml.size());
+  }
+};
+
+/// Scalars convert as they do in a node tree.
+template <typename T>
+T convertScalar(const std::string& value) {
+  return YAML::Node(value).as<T>();
+}
+
+/// Builds the functions of an extension file from the parser events. Each
+/// open yaml collection is a frame, which knows the part of the extension
+/// schema it holds, so the values are stored without a lookup by key.
+class ExtensionEventHandler final : public YAML::EventHandler {
+ public:
+  /// The yaml nodes of the extension schema.
+  enum class Node : uint8_t {
+    kDocument,
+    kExtension,
+    kFunctions,
+    kFunction,
+    kImpls,
+    kImpl,
+    kArguments,
+    kArgument,
+    kVariadic,
+    kTypes,
+    kType,
+    kSkipped,
+  };
+
+  /// Decode a document whose root is the given node, a whole extension file
+  /// or a sequence of functions of the given kind. Given declarations, the
+  /// functions are indexed instead of decoded.
+  ExtensionEventHandler(
+      Node root,
+      FunctionKind kind,
+      std::string_view yaml,
+      const std::string& extensionUri,
+      Extension* extension,
+      std::vector<FunctionImplementationPtr>* impls,
+      std::vector<ExtensionDecoder::FunctionDeclaration>* declarations)
+      : root_(root),
+        kind_(kind),
+        yaml_(yaml),
+        extensionUri_(extensionUri),
+        extension_(extension),
+        impls_(impls),
+        declarations_(declarations) {}
+
+  void OnDocumentStart(const YAML::Mark& /* mark */) override {
+    frames_.clear();
+    frames_.emplace_back(Node::kDocument, false);
+  }
+
+  void OnDocumentEnd() override {
+    endDeclaration(yaml_.size());
+  }
+
+  void OnNull(const YAML::Mark& mark, YAML::anchor_t /* anchor */) override {
+    endDeclaration(lineBegin(mark.pos));
+    auto& frame = frames_.back();
+    if (frame.isMap && !frame.hasKey) {
+      frame.key.clear();
+    } else {
+      onValue(frame, std::nullopt);
+    }
+    endEntry(frame);
+  }
+
+  void OnAlias(const YAML::Mark& mark, YAML::anchor_t /* anchor */) override {
+    SUBSTRAIT_UNSUPPORTED(
+        "Alias at line {} of {} is not supported",
+        mark.line + 1,
+        extensionUri_);
+  }
+
+  void OnScalar(
+      const YAML::Mark& mark,
+      const std::string& /* tag */,
+      YAML::anchor_t /* anchor */,
+      const std::string& value) override {
+    endDeclaration(lineBegin(mark.pos));
+    auto& frame = frames_.back();
+    if (frame.isMap && !frame.hasKey) {
+      frame.key = value;
+    } else {
+      onValue(frame, value);
+    }
+    endEntry(frame);
+  }
+
+  void OnSequenceStart(
+      const YAML::Mark& mark,
+      const std::string& /* tag */,
+      YAML::anchor_t /* anchor */,
+      YAML::EmitterStyle::value style) override {
+    beginCollection(mark, false, style);
+  }
+
+  void OnSequenceEnd() override {
+    endCollection();
+  }
+
+  void OnMapStart(
+      const YAML::Mark& mark,
+      const std::string& /* tag */,
+      YAML::anchor_t /* anchor */,
+      YAML::EmitterStyle::value style) override {
+    beginCollection(mark, true, style);
+  }
+
+  void OnMapEnd() override {
+    endCollection();
+  }
+
+ private:
+  struct Frame {
+    Frame(Node node, bool isMap) : node(node), isMap(isMap) {}
+
+    Node node;
+    bool isMap;
+    /// Whether the key of the current map entry was read, its value not.
+    bool hasKey{false};
+    std::string key;
+  };
+
+  /// Properties of an argument, which decide its kind once all are read.
+  struct Argument {
+    bool hasOptions{false};
+    bool optionsIsSequence{false};
+    bool hasValue{false};
+    std::optional<std::string> value;
+    bool hasType{false};
+    std::optional<std::string> required;
+  };
+
+  /// Move on to the next key of a map after its key or value was read.
+  static void endEntry(Frame& frame) {
+    if (frame.isMap) {
+      frame.hasKey = !frame.hasKey;
+    }
+  }
+
+  /// The node held by a collection which starts in the given frame.
+  Node childNode(const Frame& parent, bool isMap) {
+    if (parent.isMap && !parent.hasKey) {
+      return Node::kSkipped; // a complex key
+    }
+    const auto& key = parent.key;
+    switch (parent.node) {
+      case Node::kDocument:
+        if (root_ == Node::kExtension && isMap) {
+          return Node::kExtension;
+        }
+        return root_ == Node::kFunctions && !isMap ? Node::kFunctions
+                                                   : Node::kSkipped;
+      case Node::kExtension:
+        if (isMap) {
+          return Node::kSkipped;
+        }
+        if (key == "scalar_functions") {
+          kind_ = FunctionKind::kScalar;
+          return Node::kFunctions;
+        }
+        if (key == "aggregate_functions") {
+          kind_ = FunctionKind::kAggregate;
+          return Node::kFunctions;
+        }
+        return key == "types" ? Node::kTypes : Node::kSkipped;
+      case Node::kFunctions:
+        return itemNode(isMap, Node::kFunction);
+      case Node::kFunction:
+        // An index skips the implementations.
+        return key == "impls" && !isMap && declarations_ == nullptr
+            ? Node::kImpls
+            : Node::kSkipped;
+      case Node::kImpls:
+        return itemNode(isMap, Node::kImpl);
+      case Node::kImpl:
+        if (key == "args" && !isMap) {
+          return Node::kArguments;
+        }
+        return key == "variadic" && isMap ? Node::kVariadic : Node::kSkipped;
+      case Node::kArguments:
+        return itemNode(isMap, Node::kArgument);
+      case Node::kArgument:
+        // Only the presence of a collection matters.
+        onValue(parent, std::nullopt);
+        if (key == "options") {
+          argument_.optionsIsSequence = !isMap;
+        }
+        return Node::kSkipped;
+      case Node::kTypes:
+        return itemNode(isMap, Node::kType);
+      case Node::kVariadic:
+      case Node::kType:
+      case Node::kSkipped:
+        return Node::kSkipped;
+    }
+    SUBSTRAIT_UNREACHABLE("Unknown extension node");
+  }
+
+  Node itemNode(bool isMap, Node node) const {
+    if (!isMap) {
+      SUBSTRAIT_IVALID_ARGUMENT(
+          "Items of {} must be maps, found a sequence at line {}",
+          extensionUri_,
+          line_ + 1);
+    }
+    return node;
+  }
+
+  /// Start of the line holding the given position.
+  size_t lineBegin(size_t pos) const {
+    const auto newline = pos == 0 ? std::string_view::npos
+                                  : yaml_.rfind('\n', pos - 1);
+    return newline == std::string_view::npos ? 0 : newline + 1;
+  }
+
+  /// Start of the line of the dash of the block sequence item whose content
+  /// starts at the given position, the dash may be on a line of its own.
+  size_t itemBegin(size_t pos) const {
+    auto begin = lineBegin(pos);
+    while (begin > 0 && yaml_[yaml_.find_first_not_of(' ', begin)] != '-') {
+      begin = lineBegin(begin - 1);
+    }
+    return begin;
+  }
+
+  /// The last indexed function ends where the next event starts, blank lines
+  /// and comments in between included.
+  void endDeclaration(size_t end) {
+    if (declarationOpen_) {
+      auto& declaration = declarations_->back();
+      declaration.size = end - declaration.offset;
+      declarationOpen_ = false;
+    }
+  }
+
+  void beginCollection(
+      const YAML::Mark& mark,
+      bool isMap,
+      YAML::EmitterStyle::value style) {
+    line_ = mark.line;
+    const auto node = childNode(frames_.back(), isMap);
+    if (declarations_ != nullptr) {
+      if (node == Node::kFunctions && style == YAML::EmitterStyle::Flow) {
+        // The functions of a flow sequence share lines.
+        SUBSTRAIT_UNSUPPORTED(
+            "{} of {} is no block sequence",
+            frames_.back().key,
+            extensionUri_);
+      }
+      if (node == Node::kFunction) {
+        functionBegin_ = itemBegin(mark.pos);
+      }
+      endDeclaration(
+          node == Node::kFunction ? functionBegin_ : lineBegin(mark.pos));
+    }
+    switch (node) {
+      case Node::kFunction:
+        functionName_.reset();
+        functionImpls_.clear();
+        break;
+      case Node::kImpl:
+        if (kind_ == FunctionKind::kAggregate) {
+          impl_ = std::make_shared<AggregateFunctionImplementation>();
+        } else {
+          impl_ = std::make_shared<ScalarFunctionImplementation>();
+        }
+        break;
+      case Node::kArgument:
+        argument_ = Argument{};
+        break;
+      case Node::kVariadic:
+        variadicMin_.reset();
+        variadicMax_.reset();
+        break;
+      case Node::kType:
+        typeName_.reset();
+        break;
+      default:
+        break;
+    }
+    frames_.emplace_back(node, isMap);
+  }
+
+  void endCollection() {
+    switch (frames_.back().node) {
+      case Node::kFunction:
+        endFunction();
+        break;
+      case Node::kImpl:
+        functionImpls_.emplace_back(std::move(impl_));
+        break;
+      case Node::kArgument:
+        endArgument();
+        break;
+      case Node::kVariadic:
+        if (variadicMin_) {
+          impl_->variadic = FunctionVariadic{*variadicMin_, variadicMax_};
+        }
+        break;
+      case Node::kType:
+        endType();
+        break;
+      default:
+        break;
+    }
+    frames_.pop_back();
+    endEntry(frames_.back());
+  }
+
+  /// Store a scalar or null value of the current map entry.
+  void onValue(const Frame& frame, const std::optional<std::string>& value) {
+    const auto& key = frame.key;
+    switch (frame.node) {
+      case Node::kFunction:
+        if (key == "name" && value) {
+          functionName_ = *value;
+        }
+        break;
+      case Node::kImpl:
+        if (key == "return" && value) {
+          decodeReturnType(*value);
+        } else if (
+            key == "intermediate" && value &&
+            kind_ == FunctionKind::kAggregate) {
+          std::static_pointer_cast<AggregateFunctionImplementation>(impl_)
+              ->intermediate = decodeType(*value);
+        }
+        break;
+      case Node::kArgument:
+        if (key == "options") {
+          argument_.hasOptions = true;
+        } else if (key == "value") {
+          argument_.hasValue = true;
+          argument_.value = value;
+        } else if (key == "type") {
+          argument_.hasType = true;
+        } else if (key == "required") {
+          argument_.required = value;
+        }
+        break;
+      case Node::kFunctions:
+      case Node::kImpls:
+      case Node::kArguments:
+      case Node::kTypes:
+        SUBSTRAIT_IVALID_ARGUMENT(
+            "Items of {} must be maps, found a scalar after line {}",
+            extensionUri_,
+            line_ + 1);
+      case Node::kVariadic:
+        if (key == "min" && value) {
+          variadicMin_ = convertScalar<int>(*value);
+        } else if (key == "max" && value) {
+          variadicMax_ = convertScalar<int>(*value);
+        }
+        break;
+      case Node::kType:
+        if (key == "name" && value) {
+          typeName_ = *value;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  void decodeReturnType(const std::string& returnExpr) {
+    /// Return type can be an expression, whose last line is the type.
+    const auto lastLine = returnExpr.rfind('\n');
+    impl_->returnType = decodeType(
+        lastLine == std::string::npos ? returnExpr
+                                      : returnExpr.substr(lastLine + 1));
+    try {
+      impl_->returnTypeDerivation = TypeDerivation::compile(returnExpr);
+    } catch (const common::SubstraitException&) {
+      // Nested return types such as list<any1> are not derivable, callers
+      // can still use the declared return type.
+      impl_->returnTypeDerivation = nullptr;
+    }
+  }
+
+  void endArgument() {
+    if (argument_.hasOptions) {
+      if (!argument_.optionsIsSequence) {
+        SUBSTRAIT_IVALID_ARGUMENT(
+            "Options of an enum argument of {} must be a sequence",
+            extensionUri_);
+      }
+      auto enumArgument = std::make_shared<EnumArgument>();
+      enumArgument->required =
+          argument_.required && convertScalar<bool>(*argument_.required);
+      impl_->arguments.emplace_back(std::move(enumArgument));
+    } else if (argument_.hasValue) {
+      if (!argument_.value) {
+        SUBSTRAIT_IVALID_ARGUMENT(
+            "Value of an argument of {} must be a type", extensionUri_);
+      }
+      auto valueArgument = std::make_shared<ValueArgument>();
+      valueArgument->type = decodeType(*argument_.value);
+      impl_->arguments.emplace_back(std::move(valueArgument));
+    } else if (argument_.hasType) {
+      impl_->arguments.emplace_back(std::make_shared<TypeArgument>());
+    } else {
+      SUBSTRAIT_IVALID_ARGUMENT(
+          "Argument of {} has neither options, a value nor a type",
+          extensionUri_);
+    }
+  }
+
+  void endFunction() {
+    if (!functionName_) {
+      SUBSTRAIT_IVALID_ARGUMENT("Function of {} has no name", extensionUri_);
+    }
+    if (declarations_ != nullptr) {
+      declarations_->push_back({kind_, *functionName_, functionBegin_, 0});
+      declarationOpen_ = true;
+      return;
+    }
+    for (auto& functionImpl : functionImpls_) {
+      functionImpl->name = *functionName_;
+      functionImpl->uri = extensionUri_;
+      if (impls_ != nullptr) {
+        impls_->emplace_back(std::move(functionImpl));
+      } else if (kind_ == FunctionKind::kAggregate) {
+        extension_->addAggregateFunctionImpl(functionImpl);
+      } else {
+        extension_->addScalarFunctionImpl(functionImpl);
+      }
+    }
+  }
+
+  void endType() {
+    if (!typeName_) {
+      SUBSTRAIT_IVALID_ARGUMENT("Type of {} has no name", extensionUri_);
+    }
+    auto typeVariant = std::make_shared<TypeVariant>();
+    typeVariant->name = *typeName_;
+    typeVariant->uri = extensionUri_;
+    extension_->addTypeVariant(typeVariant);
+  }
+
+  const Node root_;
+  FunctionKind kind_;
+  const std::string_view yaml_;
+  const std::string& extensionUri_;
+  Extension* const extension_;
+  std::vector<FunctionImplementationPtr>* const impls_;
+  std::vector<ExtensionDecoder::FunctionDeclaration>* const declarations_;
+  /// Start of the function being indexed, and whether the range of the last
+  /// indexed function is still open.
+  size_t functionBegin_{0};
+  bool declarationOpen_{false};
+
+  std::vector<Frame> frames_;
+  /// Line of the last collection, for error messages.
+  int line_{0};
+
+  // The function, implementation, argument and type being decoded, the
+  // schema nests at most one of each.
+  std::optional<std::string> functionName_;
+  std::vector<FunctionImplementationPtr> functionImpls_;
+  FunctionImplementationPtr impl_;
+  Argument argument_;
+  std::optional<int> variadicMin_;
+  std::optional<int> variadicMax_;
+  std::optional<std::string> typeName_;
+};
+
+void parse(std::string_view yaml, ExtensionEventHandler& handler) {
+  StringViewBuffer buffer(yaml);
+  std::istream in(&buffer);
+  YAML::Parser parser(in);
+  // Like YAML::Load, only the first document is read.
+  parser.HandleNextDocument(handler);
+}
+
+} // namespace
+
+void ExtensionDecoder::decodeFile(
+    std::string_view yaml,
+    const std::string& extensionUri,
+    Extension& extension) {
+  ExtensionEventHandler handler(
+      ExtensionEventHandler::Node::kExtension,
+      FunctionKind::kScalar,
+      yaml,
+      extensionUri,
+      &extension,
+      nullptr,
+      nullptr);
+  parse(yaml, handler);
+}
+
+void ExtensionDecoder::indexFile(
+    std::string_view yaml,
+    const std::string& extensionUri,
+    Extension& extension,
+    std::vector<FunctionDeclaration>& functions) {
+  ExtensionEventHandler handler(
+      ExtensionEventHandler::Node::kExtension,
+      FunctionKind::kScalar,
+      yaml,
+      extensionUri,
+      &extension,
+      nullptr,
+      &functions);
+  parse(yaml, handler);
+}
+
+void ExtensionDecoder::decodeFunctions(
+    std::string_view yaml,
+    FunctionKind kind,
+    const std::string& extensionUri,
+    std::vector<FunctionImplementationPtr>& impls) {
+  if (kind == FunctionKind::kWindow) {
+    SUBSTRAIT_UNSUPPORTED(
+        "Window functions of extension files are not loaded");
+  }
+  ExtensionEventHandler handler(
+      ExtensionEventHandler::Node::kFunctions,
+      kind,
+      yaml,
+      extensionUri,
+      nullptr,
+      &impls,
+      nullptr);
+  parse(yaml, handler);
+}
+
+} // namespace io::substrait
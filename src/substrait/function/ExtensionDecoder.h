@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "substrait/function/Extension.h"
+
+namespace io::substrait {
+
+/// Decodes extension files straight from the events of the yaml-cpp parser,
+/// building the function implementations and type variants without a node
+/// tree in between. Keys other than the ones of the substrait extension
+/// schema are skipped, so is the content of window_functions. Aliases are
+/// not supported.
+class ExtensionDecoder final {
+ public:
+  /// A function of an extension file, indexed without decoding it.
+  struct FunctionDeclaration {
+    FunctionKind kind;
+    std::string name;
+    /// Byte range of the function in the file, a block sequence of just this
+    /// function for decodeFunctions.
+    size_t offset;
+    size_t size;
+  };
+
+  /// Decode the scalar functions, aggregate functions and type variants of
+  /// an extension file into extension, in the order of the file.
+  /// @throws YAML::Exception if the yaml is malformed, SubstraitException if
+  /// a function or type variant does not follow the extension schema.
+  static void decodeFile(
+      std::string_view yaml,
+      const std::string& extensionUri,
+      Extension& extension);
+
+  /// Decode the type variants of an extension file into extension and index
+  /// its scalar and aggregate functions, in the order of the file, without
+  /// decoding their implementations.
+  /// @throws YAML::Exception if the yaml is malformed, SubstraitException if
+  /// a function has no name or a function section is no block sequence.
+  static void indexFile(
+      std::string_view yaml,
+      const std::string& extensionUri,
+      Extension& extension,
+      std::vector<FunctionDeclaration>& functions);
+
+  /// Decode a yaml sequence of function declarations of the given kind,
+  /// such as a part of a function section of an extension file, appending
+  /// their implementations to impls.
+  static void decodeFunctions(
+      std::string_view yaml,
+      FunctionKind kind,
+      const std::string& extensionUri,
+      std::vector<FunctionImplementationPtr>& impls);
+};
+
+} // namespace io::substrait
@@ -0,0 +1,510 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/function/ExtensionSnapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeSerializer.h"
+
+namespace io::substrait {
+
+namespace {
+
+constexpr char kMagic[] = {'S', 'U', 'B', 'X', 'S', 'N', 'A', 'P'};
+constexpr size_t kHeaderSize = sizeof(kMagic) + sizeof(uint32_t);
+
+constexpr uint8_t kNumFunctionKinds = 3;
+
+enum class ArgumentTag : uint8_t {
+  kValue,
+  kEnum,
+  kType,
+};
+
+/// Flags of an implementation record.
+constexpr uint8_t kAggregateFlag = 0x01;
+constexpr uint8_t kReturnTypeFlag = 0x02;
+constexpr uint8_t kVariadicFlag = 0x04;
+constexpr uint8_t kVariadicMaxFlag = 0x08;
+constexpr uint8_t kIntermediateFlag = 0x10;
+
+void writeVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void writeString(std::string_view value, std::string& out) {
+  writeVarint(value.size(), out);
+  out.append(value);
+}
+
+/// Writes the function records, uris are written once and referenced by
+/// their index.
+class Writer {
+ public:
+  void writeFunction(
+      const std::vector<FunctionImplementationPtr>& impls,
+      std::string& out) {
+    writeVarint(impls.size(), out);
+    for (const auto& impl : impls) {
+      writeImplementation(*impl, out);
+    }
+  }
+
+  void writeTypeVariant(const TypeVariant& typeVariant, std::string& out) {
+    writeString(typeVariant.name, out);
+    writeVarint(uriIndex(typeVariant.uri), out);
+  }
+
+  [[nodiscard]] const std::vector<std::string>& uris() const {
+    return uris_;
+  }
+
+ private:
+  void writeImplementation(
+      const FunctionImplementation& impl,
+      std::string& out) {
+    writeVarint(uriIndex(impl.uri), out);
+
+    writeVarint(impl.arguments.size(), out);
+    for (const auto& argument : impl.arguments) {
+      if (argument->isValueArgument()) {
+        out.push_back(static_cast<char>(ArgumentTag::kValue));
+        TypeSerializer::serialize(
+            *static_cast<const ValueArgument&>(*argument).type, out);
+      } else if (argument->isEnumArgument()) {
+        out.push_back(static_cast<char>(ArgumentTag::kEnum));
+        out.push_back(static_cast<const EnumArgument&>(*argument).required);
+      } else {
+        out.push_back(static_cast<char>(ArgumentTag::kType));
+      }
+    }
+
+    const auto* aggregate =
+        dynamic_cast<const AggregateFunctionImplementation*>(&impl);
+    uint8_t flags = 0;
+    if (aggregate) {
+      flags |= kAggregateFlag;
+      if (aggregate->intermediate) {
+        flags |= kIntermediateFlag;
+      }
+    }
+    if (impl.returnType) {
+      flags |= kReturnTypeFlag;
+    }
+    if (impl.variadic.has_value()) {
+      flags |= kVariadicFlag;
+      if (impl.variadic->max.has_value()) {
+        flags |= kVariadicMaxFlag;
+      }
+    }
+    out.push_back(static_cast<char>(flags));
+
+    if (impl.returnType) {
+      TypeSerializer::serialize(*impl.returnType, out);
+    }
+    writeString(
+        impl.returnTypeDerivation ? impl.returnTypeDerivation->expression()
+                                  : std::string_view(),
+        out);
+    if (impl.variadic.has_value()) {
+      writeVarint(impl.variadic->min, out);
+      if (impl.variadic->max.has_value()) {
+        writeVarint(*impl.variadic->max, out);
+      }
+    }
+    if ((flags & kIntermediateFlag) != 0) {
+      TypeSerializer::serialize(*aggregate->intermediate, out);
+    }
+  }
+
+  size_t uriIndex(const std::string& uri) {
+    auto [it, inserted] = uriIndices_.emplace(uri, uris_.size());
+    if (inserted) {
+      uris_.emplace_back(uri);
+    }
+    return it->second;
+  }
+
+  std::vector<std::string> uris_;
+  std::unordered_map<std::string, size_t> uriIndices_;
+};
+
+/// Reads the bytes of a snapshot, every read is bounds checked.
+class Reader {
+ public:
+  Reader(const uint8_t* cursor, const uint8_t* end)
+      : cursor_(cursor), end_(end) {}
+
+  template <typename... Args>
+  [[noreturn]] static void fail(const char* reason, const Args&... args) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Fail to read extension snapshot: {}",
+        common::errorMessage(reason, args...));
+  }
+
+  [[nodiscard]] const uint8_t* cursor() const {
+    return cursor_;
+  }
+
+  [[nodiscard]] bool atEnd() const {
+    return cursor_ == end_;
+  }
+
+  uint8_t readByte() {
+    if (cursor_ == end_) {
+      fail("unexpected end of input");
+    }
+    return *cursor_++;
+  }
+
+  uint64_t readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const auto byte = readByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    fail("varint longer than 10 bytes");
+  }
+
+  int readInt() {
+    const auto value = readVarint();
+    if (value > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+      fail("integer {} out of range", value);
+    }
+    return static_cast<int>(value);
+  }
+
+  /// Read a count of items or bytes, which cannot exceed the remaining bytes.
+  size_t readCount() {
+    const auto count = readVarint();
+    if (count > static_cast<uint64_t>(end_ - cursor_)) {
+      fail("count {} exceeds the remaining input", count);
+    }
+    return static_cast<size_t>(count);
+  }
+
+  std::string_view readString() {
+    const auto size = readCount();
+    const std::string_view value(
+        reinterpret_cast<const char*>(cursor_), size);
+    cursor_ += size;
+    return value;
+  }
+
+  void skip(size_t size) {
+    cursor_ += size;
+  }
+
+  ParameterizedTypePtr readType() {
+    return TypeSerializer::deserialize(cursor_, end_);
+  }
+
+ private:
+  const uint8_t* cursor_;
+  const uint8_t* const end_;
+};
+
+/// A read-only memory mapping of a whole file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      SUBSTRAIT_USER_FAIL(
+          "Cannot open extension snapshot {}: {}", path, std::strerror(errno));
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+      const auto error = errno;
+      ::close(fd);
+      SUBSTRAIT_USER_FAIL(
+          "Cannot stat extension snapshot {}: {}", path, std::strerror(error));
+    }
+    size_ = static_cast<size_t>(status.st_size);
+    if (size_ > 0) {
+      data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    const auto error = errno;
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+      SUBSTRAIT_USER_FAIL(
+          "Cannot map extension snapshot {}: {}", path, std::strerror(error));
+    }
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr && data_ != MAP_FAILED) {
+      ::munmap(data_, size_);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] std::string_view bytes() const {
+    return {static_cast<const char*>(data_), size_};
+  }
+
+ private:
+  void* data_{nullptr};
+  size_t size_{0};
+};
+
+/// Decodes the function records of a snapshot.
+class SnapshotSource final : public FunctionImplSource {
+ public:
+  SnapshotSource(std::string_view bytes, std::unique_ptr<MappedFile> file)
+      : base_(reinterpret_cast<const uint8_t*>(bytes.data())),
+        file_(std::move(file)) {}
+
+  void decode(
+      FunctionKind /* kind */,
+      const std::string& name,
+      uint64_t offset,
+      uint64_t size,
+      std::vector<FunctionImplementationPtr>& impls) const override {
+    Reader reader(base_ + offset, base_ + offset + size);
+    for (auto count = reader.readCount(); count > 0; --count) {
+      impls.emplace_back(readImplementation(reader, name));
+    }
+    if (!reader.atEnd()) {
+      Reader::fail("trailing bytes in the record of {}", name);
+    }
+  }
+
+  /// Uris referenced by index, read when opening the snapshot.
+  std::vector<std::string> uris;
+
+  const std::string& readUri(Reader& reader) const {
+    const auto index = reader.readVarint();
+    if (index >= uris.size()) {
+      Reader::fail("uri index {} out of range", index);
+    }
+    return uris[index];
+  }
+
+ private:
+  FunctionImplementationPtr readImplementation(
+      Reader& reader,
+      const std::string& name) const {
+    const auto& uri = readUri(reader);
+
+    std::vector<FunctionArgumentPtr> arguments(reader.readCount());
+    for (auto& argument : arguments) {
+      switch (static_cast<ArgumentTag>(reader.readByte())) {
+        case ArgumentTag::kValue: {
+          auto valueArgument = std::make_shared<ValueArgument>();
+          valueArgument->type = reader.readType();
+          argument = std::move(valueArgument);
+          break;
+        }
+        case ArgumentTag::kEnum: {
+          auto enumArgument = std::make_shared<EnumArgument>();
+          enumArgument->required = reader.readByte() != 0;
+          argument = std::move(enumArgument);
+          break;
+        }
+        case ArgumentTag::kType:
+          argument = std::make_shared<TypeArgument>();
+          break;
+        default:
+          Reader::fail("invalid argument of {}", name);
+      }
+    }
+
+    const auto flags = reader.readByte();
+    std::shared_ptr<FunctionImplementation> impl;
+    std::shared_ptr<AggregateFunctionImplementation> aggregate;
+    if ((flags & kAggregateFlag) != 0) {
+      aggregate = std::make_shared<AggregateFunctionImplementation>();
+      impl = aggregate;
+    } else {
+      impl = std::make_shared<ScalarFunctionImplementation>();
+    }
+    impl->name = name;
+    impl->uri = uri;
+    impl->arguments = std::move(arguments);
+    if ((flags & kReturnTypeFlag) != 0) {
+      impl->returnType = reader.readType();
+    }
+    const auto expression = reader.readString();
+    if (!expression.empty()) {
+      impl->returnTypeDerivation = TypeDerivation::compile(expression);
+    }
+    if ((flags & kVariadicFlag) != 0) {
+      const auto min = reader.readInt();
+      std::optional<int> max;
+      if ((flags & kVariadicMaxFlag) != 0) {
+        max = reader.readInt();
+      }
+      impl->variadic = FunctionVariadic{min, max};
+    }
+    if ((flags & kIntermediateFlag) != 0) {
+      if (!aggregate) {
+        Reader::fail("intermediate type of scalar function {}", name);
+      }
+      aggregate->intermediate = reader.readType();
+    }
+    return impl;
+  }
+
+  const uint8_t* const base_;
+  /// Mapping the bytes point into, nullptr if they are owned by the caller.
+  const std::unique_ptr<MappedFile> file_;
+};
+
+/// Read the header, uris, type variants and the function index.
+ExtensionPtr openSnapshot(
+    std::string_view bytes,
+    std::unique_ptr<MappedFile> file) {
+  if (bytes.size() < kHeaderSize ||
+      std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+    Reader::fail("not an extension snapshot");
+  }
+  uint32_t version = 0;
+  for (size_t i = 0; i < sizeof(version); ++i) {
+    version |= static_cast<uint32_t>(
+                   static_cast<uint8_t>(bytes[sizeof(kMagic) + i]))
+        << (8 * i);
+  }
+  if (version != ExtensionSnapshot::kVersion) {
+    Reader::fail(
+        "version {} is not the supported version {}",
+        version,
+        ExtensionSnapshot::kVersion);
+  }
+
+  const auto* base = reinterpret_cast<const uint8_t*>(bytes.data());
+  Reader reader(base + kHeaderSize, base + bytes.size());
+  auto source = std::make_shared<SnapshotSource>(bytes, std::move(file));
+  for (auto count = reader.readCount(); count > 0; --count) {
+    source->uris.emplace_back(reader.readString());
+  }
+
+  auto extension = std::make_shared<Extension>();
+  for (auto count = reader.readCount(); count > 0; --count) {
+    auto typeVariant = std::make_shared<TypeVariant>();
+    typeVariant->name = reader.readString();
+    typeVariant->uri = source->readUri(reader);
+    extension->addTypeVariant(typeVariant);
+  }
+
+  for (auto count = reader.readCount(); count > 0; --count) {
+    const auto kind = reader.readByte();
+    if (kind >= kNumFunctionKinds) {
+      Reader::fail("invalid function kind {}", kind);
+    }
+    const std::string name(reader.readString());
+    const auto size = reader.readCount();
+    extension->addLazyFunctionImpls(
+        static_cast<FunctionKind>(kind),
+        name,
+        source,
+        reader.cursor() - base,
+        size);
+    reader.skip(size);
+  }
+  if (!reader.atEnd()) {
+    Reader::fail("trailing bytes");
+  }
+  return extension;
+}
+
+} // namespace
+
+void ExtensionSnapshot::write(const Extension& extension, std::string& out) {
+  Writer writer;
+
+  std::vector<const TypeVariant*> typeVariants;
+  for (const auto& [name, typeVariant] : extension.typeVariantMap()) {
+    typeVariants.emplace_back(typeVariant.get());
+  }
+  std::sort(
+      typeVariants.begin(),
+      typeVariants.end(),
+      [](const auto* left, const auto* right) {
+        return left->name < right->name;
+      });
+  std::string types;
+  writeVarint(typeVariants.size(), types);
+  for (const auto* typeVariant : typeVariants) {
+    writer.writeTypeVariant(*typeVariant, types);
+  }
+
+  std::string index;
+  std::string record;
+  size_t numFunctions = 0;
+  for (uint8_t kind = 0; kind < kNumFunctionKinds; ++kind) {
+    const auto& functionImpls =
+        extension.functionImplMap(static_cast<FunctionKind>(kind));
+    std::vector<const std::string*> names;
+    for (const auto& [name, impls] : functionImpls) {
+      names.emplace_back(&name);
+    }
+    std::sort(
+        names.begin(), names.end(), [](const auto* left, const auto* right) {
+          return *left < *right;
+        });
+    for (const auto* name : names) {
+      record.clear();
+      writer.writeFunction(functionImpls.at(*name), record);
+      index.push_back(static_cast<char>(kind));
+      writeString(*name, index);
+      writeString(record, index);
+    }
+    numFunctions += names.size();
+  }
+
+  out.append(kMagic, sizeof(kMagic));
+  for (size_t i = 0; i < sizeof(kVersion); ++i) {
+    out.push_back(static_cast<char>((kVersion >> (8 * i)) & 0xff));
+  }
+  writeVarint(writer.uris().size(), out);
+  for (const auto& uri : writer.uris()) {
+    writeString(uri, out);
+  }
+  out.append(types);
+  writeVarint(numFunctions, out);
+  out.append(index);
+}
+
+void ExtensionSnapshot::writeFile(
+    const Extension& extension,
+    const std::string& path) {
+  std::string bytes;
+  write(extension, bytes);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  file.close();
+  if (!file) {
+    SUBSTRAIT_USER_FAIL("Cannot write extension snapshot {}", path);
+  }
+}
+
+ExtensionPtr ExtensionSnapshot::openFile(const std::string& path) {
+  auto file = std::make_unique<MappedFile>(path);
+  const auto bytes = file->bytes();
+  return openSnapshot(bytes, std::move(file));
+}
+
+ExtensionPtr ExtensionSnapshot::openBuffer(std::string_view bytes) {
+  return openSnapshot(bytes, nullptr);
+}
+
+} // namespace io::substrait
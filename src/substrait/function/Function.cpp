@@ -1,83 +1,286 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 
-#include <sstream>
 #include "substrait/function/Function.h"
+#include "substrait/type/TypeCoercion.h"
+#include "substrait/type/TypeFactory.h"
 
 namespace io::substrait {
 
-bool FunctionImplementation::tryMatch(const FunctionSignature& signature) {
-  const auto& actualTypes = signature.arguments;
-  if (variadic.has_value()) {
+namespace {
+
+/// Match the actual types against the value arguments of a function
+/// implementation. Arguments and types are only ever borrowed, so concurrent
+/// lookups do not contend on the reference counts of shared declarations.
+template <typename Types>
+bool isArgumentsMatch(
+    const FunctionImplementation& impl,
+    const Types& actualTypes,
+    TypeBindings& bindings) {
+  if (impl.variadic.has_value()) {
     // return false if actual types length less than min of variadic
-    const auto max = variadic->max;
-    if ((actualTypes.size() < variadic->min) ||
+    const auto max = impl.variadic->max;
+    if ((actualTypes.size() < impl.variadic->min) ||
         (max.has_value() && actualTypes.size() > max.value())) {
       return false;
     }
 
-    const auto& variadicArgument = arguments[0];
+    const auto& variadicArgument = *impl.arguments[0];
     // actual type must same as the variadicArgument
-    if (const auto& variadicValueArgument =
-            std::dynamic_pointer_cast<const ValueArgument>(variadicArgument)) {
-      for (auto& actualType : actualTypes) {
-        if (!variadicValueArgument->type->isMatch(actualType)) {
+    if (variadicArgument.isValueArgument()) {
+      const auto& variadicType =
+          *static_cast<const ValueArgument&>(variadicArgument).type;
+      for (const auto& actualType : actualTypes) {
+        if (!variadicType.isMatch(*actualType, bindings)) {
           return false;
         }
       }
     }
-  } else {
-    std::vector<std::shared_ptr<const ValueArgument>> valueArguments;
-    for (const auto& argument : arguments) {
-      if (const auto& variadicValueArgument =
-              std::dynamic_pointer_cast<const ValueArgument>(argument)) {
-        valueArguments.emplace_back(variadicValueArgument);
-      }
+    return true;
+  }
+
+  // return false if size of actual types not equal to size of value
+  // arguments.
+  size_t i = 0;
+  for (const auto& argument : impl.arguments) {
+    if (!argument->isValueArgument()) {
+      continue;
     }
-    // return false if size of actual types not equal to size of value
-    // arguments.
-    if (valueArguments.size() != actualTypes.size()) {
+    if (i == actualTypes.size() ||
+        !static_cast<const ValueArgument&>(*argument).type->isMatch(
+            *actualTypes[i], bindings)) {
       return false;
     }
+    ++i;
+  }
+  return i == actualTypes.size();
+}
 
-    for (auto i = 0; i < actualTypes.size(); i++) {
-      const auto& valueArgument = valueArguments[i];
-      if (!valueArgument->type->isMatch(actualTypes[i])) {
-        return false;
-      }
+/// Collect the declared type each actual argument matches against, a null
+/// entry if it matches any type.
+/// @return false if the number of arguments does not fit.
+bool declaredTypes(
+    const FunctionImplementation& impl,
+    size_t numArguments,
+    std::vector<const ParameterizedType*>& types) {
+  if (impl.variadic.has_value()) {
+    const auto max = impl.variadic->max;
+    if (numArguments < static_cast<size_t>(impl.variadic->min) ||
+        (max.has_value() && numArguments > static_cast<size_t>(*max))) {
+      return false;
+    }
+    const auto& variadicArgument = *impl.arguments[0];
+    types.assign(
+        numArguments,
+        variadicArgument.isValueArgument()
+            ? static_cast<const ValueArgument&>(variadicArgument).type.get()
+            : nullptr);
+    return true;
+  }
+  for (const auto& argument : impl.arguments) {
+    if (argument->isValueArgument()) {
+      types.push_back(static_cast<const ValueArgument&>(*argument).type.get());
     }
   }
+  return types.size() == numArguments;
+}
+
+/// Name of a placeholder binding a type, such as any1, empty for other
+/// declared types including the plain any wildcard.
+std::string_view bindingName(const ParameterizedType* type) {
+  const auto* literal = type ? dynCast<StringLiteral>(*type) : nullptr;
+  if (literal == nullptr || !literal->isWildcard()) {
+    return {};
+  }
+  std::string_view name = literal->value();
+  if (!name.empty() && name.back() == '?') {
+    name.remove_suffix(1);
+  }
+  return name == "any" ? std::string_view() : name;
+}
+
+/// Match a type leaving the bindings untouched unless it matches.
+bool isMatchBinding(
+    const ParameterizedType& declared,
+    const ParameterizedType& type,
+    TypeBindings& bindings) {
+  auto attempt = bindings;
+  if (!declared.isMatch(type, attempt)) {
+    return false;
+  }
+  bindings = attempt;
+  return true;
+}
+
+} // namespace
+
+bool FunctionImplementation::tryMatch(const FunctionSignature& signature) {
+  TypeBindings bindings;
+  return tryMatch(signature, bindings);
+}
+
+bool FunctionImplementation::tryMatch(
+    const FunctionSignature& signature,
+    TypeBindings& bindings) const {
+  bindings.clear();
+  if (!isArgumentsMatch(*this, signature.arguments, bindings)) {
+    return false;
+  }
   const auto& sigReturnType = signature.returnType;
   if (this->returnType && sigReturnType) {
-    return returnType->isMatch(sigReturnType);
+    return returnType->isMatch(*sigReturnType, bindings);
   } else {
     return true;
   }
 }
 
-std::string FunctionImplementation::signature() const {
-  std::stringstream ss;
-  ss << name;
-  if (!arguments.empty()) {
-    ss << ":";
-    for (auto it = arguments.begin(); it != arguments.end(); ++it) {
-      const auto& typeSign = (*it)->toTypeString();
-      if (it == arguments.end() - 1) {
-        ss << typeSign;
-      } else {
-        ss << typeSign << "_";
+bool FunctionImplementation::tryMatch(
+    const std::vector<TypeRef>& actualTypes,
+    TypeRef sigReturnType,
+    TypeBindings& bindings) const {
+  bindings.clear();
+  if (!isArgumentsMatch(*this, actualTypes, bindings)) {
+    return false;
+  }
+  if (this->returnType && sigReturnType) {
+    return returnType->isMatch(*sigReturnType, bindings);
+  } else {
+    return true;
+  }
+}
+
+TypePtr FunctionImplementation::deriveReturnType(
+    const TypeBindings& bindings) const {
+  if (returnTypeDerivation) {
+    return returnTypeDerivation->evaluate(bindings);
+  }
+  if (returnType && isa<Type>(*returnType)) {
+    return std::static_pointer_cast<const Type>(returnType);
+  }
+  return nullptr;
+}
+
+std::optional<int> FunctionImplementation::coercionCost(
+    const std::vector<TypeRef>& actualTypes,
+    TypeBindings& bindings) const {
+  if (tryMatch(actualTypes, {}, bindings)) {
+    return 0;
+  }
+  bindings.clear();
+  std::vector<const ParameterizedType*> declared;
+  if (!declaredTypes(*this, actualTypes.size(), declared)) {
+    return std::nullopt;
+  }
+  std::vector<const Type*> actual(actualTypes.size());
+  for (size_t i = 0; i < actualTypes.size(); ++i) {
+    actual[i] = dynCast<Type>(*actualTypes[i]);
+    if (actual[i] == nullptr) {
+      return std::nullopt;
+    }
+  }
+
+  // Arguments of the same placeholder are cast to their common supertype.
+  std::vector<TypePtr> targets(actualTypes.size());
+  for (size_t i = 0; i < actualTypes.size(); ++i) {
+    const auto name = bindingName(declared[i]);
+    if (name.empty() || targets[i]) {
+      continue;
+    }
+    auto target = TypeFactory::instance().intern(*actual[i]);
+    for (size_t j = i + 1; j < actualTypes.size() && target; ++j) {
+      if (bindingName(declared[j]) == name) {
+        target = TypeCoercion::commonSupertype(*target, *actual[j]);
+      }
+    }
+    if (!target) {
+      return std::nullopt;
+    }
+    for (size_t j = i; j < actualTypes.size(); ++j) {
+      if (bindingName(declared[j]) == name) {
+        targets[j] = target;
+      }
+    }
+  }
+
+  int total = 0;
+  for (size_t i = 0; i < actualTypes.size(); ++i) {
+    if (declared[i] == nullptr) {
+      continue;
+    }
+    const auto& from = *actual[i];
+    if (targets[i]) {
+      const auto cost = TypeCoercion::cost(from, *targets[i]);
+      if (!cost.has_value() ||
+          !isMatchBinding(*declared[i], *targets[i], bindings)) {
+        return std::nullopt;
       }
+      total += *cost;
+      continue;
+    }
+    if (isMatchBinding(*declared[i], from, bindings)) {
+      continue;
+    }
+    if (const auto* type = dynCast<Type>(*declared[i])) {
+      const auto cost = TypeCoercion::cost(from, *type);
+      if (!cost.has_value()) {
+        return std::nullopt;
+      }
+      total += *cost;
+      continue;
+    }
+    // Try the supertypes from the cheapest on against a parameterized type.
+    bool matched = false;
+    for (const auto& [supertype, cost] : TypeCoercion::supertypes(from)) {
+      if (isMatchBinding(*declared[i], *supertype, bindings)) {
+        total += cost;
+        matched = true;
+        break;
+      }
+    }
+    if (!matched) {
+      return std::nullopt;
     }
   }
+  return total;
+}
+
+std::string FunctionImplementation::signature() const {
+  fmt::memory_buffer out;
+  appendSignature(out);
+  return fmt::to_string(out);
+}
 
-  return ss.str();
+void FunctionImplementation::appendSignature(fmt::memory_buffer& out) const {
+  out.append(name.data(), name.data() + name.size());
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    out.push_back(i == 0 ? ':' : '_');
+    arguments[i]->appendTypeString(out);
+  }
 }
 
-bool AggregateFunctionImplementation::tryMatch(const FunctionSignature& signature) {
-  bool matched = FunctionImplementation::tryMatch(signature);
+bool AggregateFunctionImplementation::tryMatch(
+    const FunctionSignature& signature,
+    TypeBindings& bindings) const {
+  bool matched = FunctionImplementation::tryMatch(signature, bindings);
   if (!matched && intermediate) {
     const auto& actualTypes = signature.arguments;
     if (actualTypes.size() == 1) {
-      return intermediate->isMatch(actualTypes[0]);
+      bindings.clear();
+      return intermediate->isMatch(*actualTypes[0], bindings);
+    }
+  }
+  return matched;
+}
+
+bool AggregateFunctionImplementation::tryMatch(
+    const std::vector<TypeRef>& actualTypes,
+    TypeRef sigReturnType,
+    TypeBindings& bindings) const {
+  bool matched =
+      FunctionImplementation::tryMatch(actualTypes, sigReturnType, bindings);
+  if (!matched && intermediate) {
+    if (actualTypes.size() == 1) {
+      bindings.clear();
+      return intermediate->isMatch(*actualTypes[0], bindings);
     }
   }
   return matched;
@@ -4,13 +4,21 @@
 
 namespace io::substrait {
 
+const std::vector<FunctionImplementationPtr>* FunctionLookup::findFunctionImpls(
+    const std::string& name) const {
+  if (const auto kind = functionKind()) {
+    return extension_->findFunctionImpls(*kind, name);
+  }
+  std::call_once(
+      functionImplsOnce_, [this]() { functionImpls_ = getFunctionImpls(); });
+  const auto it = functionImpls_.find(name);
+  return it != functionImpls_.end() ? &it->second : nullptr;
+}
+
 FunctionImplementationPtr FunctionLookup::lookupFunction(
     const FunctionSignature& signature) const {
-
-  const auto& functionImpls = getFunctionImpls();
-  auto functionImplsIter = functionImpls.find(signature.name);
-  if (functionImplsIter != functionImpls.end()) {
-    for (const auto& candidateFunctionImpl : functionImplsIter->second) {
+  if (const auto* functionImpls = findFunctionImpls(signature.name)) {
+    for (const auto& candidateFunctionImpl : *functionImpls) {
       if (candidateFunctionImpl->tryMatch(signature)) {
         return candidateFunctionImpl;
       }
@@ -19,4 +27,63 @@ FunctionImplementationPtr FunctionLookup::lookupFunction(
   return nullptr;
 }
 
+FunctionImplementationPtr FunctionLookup::lookupFunction(
+    const FunctionSignature& signature,
+    TypeBindings& bindings) const {
+  if (const auto* functionImpls = findFunctionImpls(signature.name)) {
+    for (const auto& candidateFunctionImpl : *functionImpls) {
+      if (candidateFunctionImpl->tryMatch(signature, bindings)) {
+        return candidateFunctionImpl;
+      }
+    }
+  }
+  bindings.clear();
+  return nullptr;
+}
+
+const FunctionImplementation* FunctionLookup::lookupFunction(
+    const std::string& name,
+    const std::vector<TypeRef>& arguments,
+    TypeRef returnType,
+    TypeBindings& bindings) const {
+  if (const auto* functionImpls = findFunctionImpls(name)) {
+    for (const auto& candidateFunctionImpl : *functionImpls) {
+      if (candidateFunctionImpl->tryMatch(arguments, returnType, bindings)) {
+        return candidateFunctionImpl.get();
+      }
+    }
+  }
+  bindings.clear();
+  return nullptr;
+}
+
+const FunctionImplementation* FunctionLookup::lookupCoercibleFunction(
+    const std::string& name,
+    const std::vector<TypeRef>& arguments,
+    TypeBindings& bindings) const {
+  const auto* functionImpls = findFunctionImpls(name);
+  const FunctionImplementation* best = nullptr;
+  int bestCost = 0;
+  if (functionImpls != nullptr) {
+    TypeBindings candidateBindings;
+    for (const auto& candidateFunctionImpl : *functionImpls) {
+      const auto cost =
+          candidateFunctionImpl->coercionCost(arguments, candidateBindings);
+      if (!cost.has_value() || (best != nullptr && *cost >= bestCost)) {
+        continue;
+      }
+      best = candidateFunctionImpl.get();
+      bestCost = *cost;
+      bindings = candidateBindings;
+      if (bestCost == 0) {
+        break;
+      }
+    }
+  }
+  if (best == nullptr) {
+    bindings.clear();
+  }
+  return best;
+}
+
 } // namespace io::substrait
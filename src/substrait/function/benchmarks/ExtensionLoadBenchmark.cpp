@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include <yaml-cpp/yaml.h>
+#include <filesystem>
+#include "substrait/function/ExtensionSnapshot.h"
+
+using namespace io::substrait;
+
+namespace {
+
+/// Paths of the full default extension set.
+std::vector<std::string> defaultExtensionPaths() {
+  const std::string absolutePath = __FILE__;
+  const auto basePath = absolutePath.substr(0, absolutePath.find_last_of('/')) +
+      "/../../../../third_party/substrait/extensions/";
+  std::vector<std::string> paths;
+  for (const auto& file : Extension::defaultExtensionFiles()) {
+    paths.emplace_back(basePath + file);
+  }
+  return paths;
+}
+
+void BM_LoadExtensionSerial(benchmark::State& state) {
+  const auto paths = defaultExtensionPaths();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Extension::load(paths));
+  }
+}
+BENCHMARK(BM_LoadExtensionSerial)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Build the yaml-cpp node tree of each file of the default extension set,
+/// the work of a loader decoding functions from the tree before it decodes
+/// any of them. Compare to BM_LoadExtensionSerial, which decodes the parser
+/// events.
+void BM_ParseExtensionNodeTree(benchmark::State& state) {
+  const auto paths = defaultExtensionPaths();
+  for (auto _ : state) {
+    for (const auto& path : paths) {
+      benchmark::DoNotOptimize(YAML::LoadFile(path));
+    }
+  }
+}
+BENCHMARK(BM_ParseExtensionNodeTree)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+void BM_LoadExtensionParallel(benchmark::State& state) {
+  const auto paths = defaultExtensionPaths();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Extension::load(paths, nullptr));
+  }
+}
+BENCHMARK(BM_LoadExtensionParallel)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/// Load the default extension set lazily and look up a function, which
+/// indexes all files but decodes only the declaration of the function.
+void BM_LoadExtensionLazy(benchmark::State& state) {
+  const auto paths = defaultExtensionPaths();
+  for (auto _ : state) {
+    const auto extension = Extension::loadLazy(paths);
+    benchmark::DoNotOptimize(
+        extension->findFunctionImpls(FunctionKind::kScalar, "add"));
+  }
+}
+BENCHMARK(BM_LoadExtensionLazy)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/// Open a snapshot of the default extension set and look up a function, as
+/// a short-lived process would.
+void BM_OpenExtensionSnapshot(benchmark::State& state) {
+  const auto path =
+      std::filesystem::temp_directory_path() / "substrait_extension.snapshot";
+  ExtensionSnapshot::writeFile(*Extension::load(defaultExtensionPaths()), path);
+  for (auto _ : state) {
+    const auto extension = ExtensionSnapshot::openFile(path);
+    benchmark::DoNotOptimize(
+        extension->findFunctionImpls(FunctionKind::kScalar, "add"));
+  }
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_OpenExtensionSnapshot)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
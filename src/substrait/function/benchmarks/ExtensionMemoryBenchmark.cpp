@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "substrait/function/Extension.h"
+
+// Peak heap memory of loading the default extension set. All allocations of
+// this executable are counted by the replaced global operator new, which
+// slows them down, so timings are measured by substrait_function_benchmark.
+
+using namespace io::substrait;
+
+namespace {
+
+std::atomic<int64_t> allocatedBytes{0};
+std::atomic<int64_t> peakBytes{0};
+
+/// Allocations are prefixed by their size, so deletes can account for them.
+constexpr size_t kSizePrefix = alignof(std::max_align_t);
+
+/// Report the peak heap bytes allocated by an iteration, the maximum over
+/// all iterations.
+class PeakMemory {
+ public:
+  explicit PeakMemory(benchmark::State& state) : state_(state) {}
+
+  ~PeakMemory() {
+    state_.counters["peak_bytes"] = benchmark::Counter(
+        static_cast<double>(max_),
+        benchmark::Counter::kDefaults,
+        benchmark::Counter::kIs1024);
+  }
+
+  void beginIteration() {
+    begin_ = allocatedBytes.load();
+    peakBytes.store(begin_);
+  }
+
+  void endIteration() {
+    max_ = std::max(max_, peakBytes.load() - begin_);
+  }
+
+ private:
+  benchmark::State& state_;
+  int64_t begin_{0};
+  int64_t max_{0};
+};
+
+/// Paths of the full default extension set.
+std::vector<std::string> defaultExtensionPaths() {
+  const std::string absolutePath = __FILE__;
+  const auto basePath = absolutePath.substr(0, absolutePath.find_last_of('/')) +
+      "/../../../../third_party/substrait/extensions/";
+  std::vector<std::string> paths;
+  for (const auto& file : Extension::defaultExtensionFiles()) {
+    paths.emplace_back(basePath + file);
+  }
+  return paths;
+}
+
+void BM_LoadExtensionSerial(benchmark::State& state) {
+  const auto paths = defaultExtensionPaths();
+  PeakMemory memory(state);
+  for (auto _ : state) {
+    memory.beginIteration();
+    benchmark::DoNotOptimize(Extension::load(paths));
+    memory.endIteration();
+  }
+}
+BENCHMARK(BM_LoadExtensionSerial)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Build the yaml-cpp node tree of each file of the default extension set,
+/// the work of a loader decoding functions from the tree before it decodes
+/// any of them. Compare to BM_LoadExtensionSerial, which decodes the parser
+/// events.
+void BM_ParseExtensionNodeTree(benchmark::State& state) {
+  const auto paths = defaultExtensionPaths();
+  PeakMemory memory(state);
+  for (auto _ : state) {
+    memory.beginIteration();
+    for (const auto& path : paths) {
+      benchmark::DoNotOptimize(YAML::LoadFile(path));
+    }
+    memory.endIteration();
+  }
+}
+BENCHMARK(BM_ParseExtensionNodeTree)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/// Load the default extension set lazily and look up a function, which
+/// indexes all files but decodes only the declaration of the function.
+void BM_LoadExtensionLazy(benchmark::State& state) {
+  const auto paths = defaultExtensionPaths();
+  PeakMemory memory(state);
+  for (auto _ : state) {
+    memory.beginIteration();
+    const auto extension = Extension::loadLazy(paths);
+    benchmark::DoNotOptimize(
+        extension->findFunctionImpls(FunctionKind::kScalar, "add"));
+    memory.endIteration();
+  }
+}
+BENCHMARK(BM_LoadExtensionLazy)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
+
+void* operator new(std::size_t size) {
+  const auto bytes = static_cast<int64_t>(size);
+  const auto allocated = allocatedBytes.fetch_add(bytes) + bytes;
+  auto peak = peakBytes.load(std::memory_order_relaxed);
+  while (allocated > peak &&
+         !peakBytes.compare_exchange_weak(peak, allocated)) {
+  }
+  if (auto* memory = static_cast<char*>(std::malloc(kSizePrefix + size))) {
+    *reinterpret_cast<std::size_t*>(memory) = size;
+    return memory + kSizePrefix;
+  }
+  allocatedBytes.fetch_sub(bytes);
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr != nullptr) {
+    auto* memory = static_cast<char*>(ptr) - kSizePrefix;
+    allocatedBytes.fetch_sub(
+        static_cast<int64_t>(*reinterpret_cast<std::size_t*>(memory)));
+    std::free(memory);
+  }
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  operator delete(ptr);
+}
@@ -0,0 +1,63 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include "substrait/function/FunctionLookup.h"
+
+using namespace io::substrait;
+
+namespace {
+
+FunctionImplementationPtr makeScalarFunction(
+    const std::string& name,
+    const std::vector<std::string>& argumentTypes,
+    const std::string& returnType) {
+  auto functionImpl = std::make_shared<ScalarFunctionImplementation>();
+  functionImpl->name = name;
+  for (const auto& argumentType : argumentTypes) {
+    auto argument = std::make_shared<ValueArgument>();
+    argument->type = ParameterizedType::decode(argumentType);
+    functionImpl->arguments.emplace_back(argument);
+  }
+  functionImpl->returnType = ParameterizedType::decode(returnType);
+  return functionImpl;
+}
+
+/// A small arithmetic extension, the matched overload of "add" is the last
+/// one so that every lookup walks all candidates.
+const FunctionLookup& scalarFunctionLookup() {
+  static const ScalarFunctionLookup lookup([]() {
+    auto extension = std::make_shared<Extension>();
+    for (const auto* type : {"i8", "i16", "i32", "fp32", "fp64", "i64"}) {
+      extension->addScalarFunctionImpl(
+          makeScalarFunction("add", {type, type}, type));
+    }
+    for (int i = 0; i < 64; ++i) {
+      extension->addScalarFunctionImpl(makeScalarFunction(
+          "f" + std::to_string(i), {"any1", "any1"}, "boolean"));
+    }
+    return extension;
+  }());
+  return lookup;
+}
+
+void BM_LookupFunctionSignature(benchmark::State& state) {
+  const auto& lookup = scalarFunctionLookup();
+  const FunctionSignature signature{"add", {BIGINT(), BIGINT()}, BIGINT()};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lookup.lookupFunction(signature));
+  }
+}
+BENCHMARK(BM_LookupFunctionSignature)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_LookupFunctionBorrowed(benchmark::State& state) {
+  const auto& lookup = scalarFunctionLookup();
+  const std::vector<TypeRef> arguments{BIGINT(), BIGINT()};
+  const TypeRef returnType = BIGINT();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        lookup.lookupFunction("add", arguments, returnType));
+  }
+}
+BENCHMARK(BM_LookupFunctionBorrowed)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,167 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include <yaml-cpp/exceptions.h>
+#include "substrait/common/Exceptions.h"
+#include "substrait/function/ExtensionDecoder.h"
+
+using namespace io::substrait;
+using io::substrait::common::SubstraitException;
+
+class ExtensionDecoderTest : public ::testing::Test {
+ protected:
+  static const std::vector<FunctionImplementationPtr>& findFunctionImpls(
+      const Extension& extension,
+      FunctionKind kind,
+      const std::string& name) {
+    const auto* impls = extension.findFunctionImpls(kind, name);
+    EXPECT_NE(impls, nullptr) << name;
+    static const std::vector<FunctionImplementationPtr> kNone;
+    return impls != nullptr ? *impls : kNone;
+  }
+
+  static void testMalformed(const std::string& yaml) {
+    Extension extension;
+    ASSERT_THROW(
+        ExtensionDecoder::decodeFile(yaml, "test.yaml", extension),
+        SubstraitException)
+        << yaml;
+  }
+};
+
+TEST_F(ExtensionDecoderTest, decodeFile) {
+  Extension extension;
+  ExtensionDecoder::decodeFile(
+      R"(%YAML 1.2
+---
+types:
+  - name: point
+    structure:
+      latitude: i32
+scalar_functions:
+  - name: "concat"
+    description: concatenate strings
+    impls:
+      - args:
+          - value: "varchar<L1>"
+          - name: mode
+            options: [ A, B ]
+            required: true
+          - type: any
+        variadic:
+          min: 1
+          max: 3
+        nullability: DECLARED_OUTPUT
+        return: |-
+          L2 = L1 * 2
+          varchar<L2>
+      - args: []
+        return: string
+window_functions:
+  - name: rank
+    impls:
+      - return: i64
+aggregate_functions:
+  - impls:
+      - args:
+          - value: i32
+        intermediate: i64
+        return: i64?
+    name: count_ints
+)",
+      "test.yaml",
+      extension);
+
+  const auto& concat =
+      findFunctionImpls(extension, FunctionKind::kScalar, "concat");
+  ASSERT_EQ(concat.size(), 2);
+  const auto& impl = *concat[0];
+  ASSERT_EQ(impl.name, "concat");
+  ASSERT_EQ(impl.uri, "test.yaml");
+  ASSERT_EQ(impl.arguments.size(), 3);
+  const auto* value =
+      dynamic_cast<const ValueArgument*>(impl.arguments[0].get());
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(value->type->signature(), "vchar<L1>");
+  const auto* option =
+      dynamic_cast<const EnumArgument*>(impl.arguments[1].get());
+  ASSERT_NE(option, nullptr);
+  ASSERT_TRUE(option->required);
+  ASSERT_NE(
+      dynamic_cast<const TypeArgument*>(impl.arguments[2].get()), nullptr);
+  ASSERT_EQ(impl.variadic->min, 1);
+  ASSERT_EQ(impl.variadic->max, 3);
+  ASSERT_EQ(impl.returnType->signature(), "vchar<L2>");
+  ASSERT_NE(impl.returnTypeDerivation, nullptr);
+  ASSERT_TRUE(concat[1]->arguments.empty());
+  ASSERT_FALSE(concat[1]->variadic.has_value());
+
+  const auto& countInts =
+      findFunctionImpls(extension, FunctionKind::kAggregate, "count_ints");
+  ASSERT_EQ(countInts.size(), 1);
+  const auto& aggregate =
+      dynamic_cast<const AggregateFunctionImplementation&>(*countInts[0]);
+  ASSERT_EQ(aggregate.intermediate->signature(), "i64");
+  ASSERT_EQ(aggregate.returnType->signature(), "i64");
+  ASSERT_TRUE(aggregate.returnType->nullable());
+
+  // window functions are not loaded.
+  ASSERT_TRUE(extension.windowFunctionImplMap().empty());
+  ASSERT_NE(extension.lookupType("point"), nullptr);
+  ASSERT_EQ(extension.lookupType("point")->uri, "test.yaml");
+}
+
+TEST_F(ExtensionDecoderTest, decodeFunctions) {
+  std::vector<FunctionImplementationPtr> impls;
+  ExtensionDecoder::decodeFunctions(
+      "- name: sum\n"
+      "  impls:\n"
+      "    - {args: [{value: i32}], return: i64}\n"
+      "- name: sum\n"
+      "  impls:\n"
+      "    - {args: [{value: i64}], return: i64}\n",
+      FunctionKind::kAggregate,
+      "test.yaml",
+      impls);
+  ASSERT_EQ(impls.size(), 2);
+  ASSERT_EQ(impls[0]->signature(), "sum:i32");
+  ASSERT_EQ(impls[1]->signature(), "sum:i64");
+  ASSERT_NE(
+      dynamic_cast<const AggregateFunctionImplementation*>(impls[0].get()),
+      nullptr);
+}
+
+TEST_F(ExtensionDecoderTest, malformed) {
+  // a function without a name.
+  testMalformed("scalar_functions:\n  - impls: []\n");
+  // an argument without options, value or type.
+  testMalformed(
+      "scalar_functions:\n"
+      "  - name: f\n"
+      "    impls:\n"
+      "      - args: [{name: x}]\n");
+  // enum options which are no sequence.
+  testMalformed(
+      "scalar_functions:\n"
+      "  - name: f\n"
+      "    impls:\n"
+      "      - args: [{options: A}]\n");
+  // functions which are no maps.
+  testMalformed("scalar_functions:\n  - f\n");
+  testMalformed("aggregate_functions: [[f]]\n");
+  // a type variant without a name.
+  testMalformed("types:\n  - structure: i32\n");
+  // aliases.
+  testMalformed(
+      "scalar_functions:\n"
+      "  - name: &name f\n"
+      "    impls: []\n"
+      "  - name: *name\n"
+      "    impls: []\n");
+
+  Extension extension;
+  ASSERT_THROW(
+      ExtensionDecoder::decodeFile(
+          "scalar_functions: [", "test.yaml", extension),
+      YAML::Exception);
+}
@@ -0,0 +1,362 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include "substrait/common/Exceptions.h"
+#include "substrait/function/ExtensionSnapshot.h"
+#include "substrait/function/FunctionLookup.h"
+
+using namespace io::substrait;
+using io::substrait::common::SubstraitException;
+
+class ExtensionTest : public ::testing::Test {
+ protected:
+  static std::string getExtensionAbsolutePath() {
+    const std::string absolute_path = __FILE__;
+    auto const pos = absolute_path.find_last_of('/');
+    return absolute_path.substr(0, pos) +
+        "/../../../../third_party/substrait/extensions/";
+  }
+
+  static std::vector<std::string> defaultExtensionPaths() {
+    std::vector<std::string> paths;
+    for (const auto& file : Extension::defaultExtensionFiles()) {
+      paths.emplace_back(getExtensionAbsolutePath() + file);
+    }
+    return paths;
+  }
+
+  /// Signatures and extension file names of the implementations in
+  /// registration order.
+  static std::vector<std::string> describe(const FunctionImplMap& impls) {
+    std::vector<std::string> descriptions;
+    for (const auto& [name, functionImpls] : impls) {
+      for (const auto& functionImpl : functionImpls) {
+        const auto& uri = functionImpl->uri;
+        descriptions.emplace_back(
+            functionImpl->signature() + "@" +
+            uri.substr(uri.find_last_of('/') + 1));
+      }
+    }
+    std::stable_sort(descriptions.begin(), descriptions.end(), byName);
+    return descriptions;
+  }
+
+  static void assertSameExtension(
+      const Extension& expected,
+      const Extension& actual) {
+    ASSERT_EQ(
+        describe(actual.scalaFunctionImplMap()),
+        describe(expected.scalaFunctionImplMap()));
+    ASSERT_EQ(
+        describe(actual.aggregateFunctionImplMap()),
+        describe(expected.aggregateFunctionImplMap()));
+    ASSERT_EQ(
+        describe(actual.windowFunctionImplMap()),
+        describe(expected.windowFunctionImplMap()));
+  }
+
+  /// Compare the implementations field by field, looking them up by name.
+  static void assertSameImplementations(
+      const Extension& expected,
+      const Extension& actual,
+      FunctionKind kind) {
+    for (const auto& [name, expectedImpls] : expected.functionImplMap(kind)) {
+      const auto* actualImpls = actual.findFunctionImpls(kind, name);
+      ASSERT_NE(actualImpls, nullptr) << name;
+      ASSERT_EQ(actualImpls->size(), expectedImpls.size()) << name;
+      for (size_t i = 0; i < expectedImpls.size(); ++i) {
+        const auto& expectedImpl = *expectedImpls[i];
+        const auto& actualImpl = *(*actualImpls)[i];
+        ASSERT_EQ(actualImpl.signature(), expectedImpl.signature());
+        ASSERT_EQ(actualImpl.uri, expectedImpl.uri);
+        ASSERT_TRUE(actualImpl.returnType->isEqual(*expectedImpl.returnType))
+            << expectedImpl.signature();
+        ASSERT_EQ(
+            actualImpl.returnTypeDerivation == nullptr,
+            expectedImpl.returnTypeDerivation == nullptr);
+        ASSERT_EQ(
+            actualImpl.variadic.has_value(), expectedImpl.variadic.has_value());
+        if (expectedImpl.variadic.has_value()) {
+          ASSERT_EQ(actualImpl.variadic->min, expectedImpl.variadic->min);
+          ASSERT_EQ(actualImpl.variadic->max, expectedImpl.variadic->max);
+        }
+        if (const auto* aggregate =
+                dynamic_cast<const AggregateFunctionImplementation*>(
+                    &expectedImpl)) {
+          const auto& actualAggregate =
+              dynamic_cast<const AggregateFunctionImplementation&>(actualImpl);
+          ASSERT_EQ(
+              actualAggregate.intermediate == nullptr,
+              aggregate->intermediate == nullptr);
+          if (aggregate->intermediate) {
+            ASSERT_TRUE(actualAggregate.intermediate->isEqual(
+                *aggregate->intermediate));
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  /// Order by function name only, so the order of overloads is kept.
+  static bool byName(const std::string& left, const std::string& right) {
+    return left.substr(0, left.find(':')) < right.substr(0, right.find(':'));
+  }
+};
+
+TEST_F(ExtensionTest, parallelLoad) {
+  const auto paths = defaultExtensionPaths();
+  const auto serial = Extension::load(paths);
+  ASSERT_FALSE(serial->scalaFunctionImplMap().empty());
+
+  // the calling thread runs the tasks.
+  const auto inlineExecutor = [](std::function<void()> task) { task(); };
+  assertSameExtension(*serial, *Extension::load(paths, inlineExecutor));
+
+  // a thread per task.
+  const auto threadExecutor = [](std::function<void()> task) {
+    std::thread(std::move(task)).detach();
+  };
+  assertSameExtension(*serial, *Extension::load(paths, threadExecutor));
+
+  // threads owned by the call.
+  assertSameExtension(*serial, *Extension::load(paths, nullptr));
+}
+
+TEST_F(ExtensionTest, parallelLoadError) {
+  auto paths = defaultExtensionPaths();
+  paths.insert(paths.begin() + 2, getExtensionAbsolutePath() + "missing.yaml");
+  ASSERT_ANY_THROW(Extension::load(paths, nullptr));
+
+  // tasks submitted before the executor failed are waited for.
+  int submitted = 0;
+  const auto failingExecutor = [&](std::function<void()> task) {
+    if (++submitted > 3) {
+      throw std::runtime_error("executor is shut down");
+    }
+    std::thread(std::move(task)).detach();
+  };
+  ASSERT_THROW(
+      Extension::load(defaultExtensionPaths(), failingExecutor),
+      std::runtime_error);
+}
+
+TEST_F(ExtensionTest, snapshot) {
+  const auto extension = Extension::load(defaultExtensionPaths());
+  std::string bytes;
+  ExtensionSnapshot::write(*extension, bytes);
+  const auto snapshot = ExtensionSnapshot::openBuffer(bytes);
+  ASSERT_TRUE(snapshot->isLazy());
+
+  for (const auto kind : {FunctionKind::kScalar, FunctionKind::kAggregate}) {
+    assertSameImplementations(*extension, *snapshot, kind);
+  }
+  assertSameExtension(*extension, *snapshot);
+  ASSERT_EQ(
+      snapshot->typeVariantMap().size(), extension->typeVariantMap().size());
+  ASSERT_EQ(
+      snapshot->findFunctionImpls(FunctionKind::kScalar, "none"), nullptr);
+
+  // decoded implementations are kept.
+  ASSERT_EQ(
+      snapshot->findFunctionImpls(FunctionKind::kScalar, "add"),
+      snapshot->findFunctionImpls(FunctionKind::kScalar, "add"));
+
+  // snapshots are reproducible.
+  std::string rewritten;
+  ExtensionSnapshot::write(*snapshot, rewritten);
+  ASSERT_EQ(rewritten, bytes);
+}
+
+TEST_F(ExtensionTest, snapshotFile) {
+  const auto path = testing::TempDir() + "extension.snapshot";
+  ExtensionSnapshot::writeFile(
+      *Extension::load(defaultExtensionPaths()), path);
+  const auto snapshot = ExtensionSnapshot::openFile(path);
+  std::remove(path.c_str());
+
+  ScalarFunctionLookup lookup(snapshot);
+  const auto* functionImpl =
+      lookup.lookupFunction("add", {DECIMAL(10, 2), DECIMAL(12, 4)});
+  ASSERT_NE(functionImpl, nullptr);
+  ASSERT_EQ(functionImpl->signature(), "add:dec<P1,S1>_dec<P2,S2>");
+  TypeBindings bindings;
+  ASSERT_TRUE(
+      functionImpl->tryMatch({DECIMAL(10, 2), DECIMAL(12, 4)}, {}, bindings));
+  ASSERT_EQ(
+      functionImpl->deriveReturnType(bindings)->signature(),
+      DECIMAL(13, 4)->signature());
+
+  ASSERT_THROW(ExtensionSnapshot::openFile(path), SubstraitException);
+}
+
+TEST_F(ExtensionTest, malformedSnapshot) {
+  std::string bytes;
+  ExtensionSnapshot::write(*Extension::load(defaultExtensionPaths()), bytes);
+
+  ASSERT_THROW(ExtensionSnapshot::openBuffer(""), SubstraitException);
+  ASSERT_THROW(
+      ExtensionSnapshot::openBuffer(bytes.substr(0, bytes.size() / 2)),
+      SubstraitException);
+  auto otherVersion = bytes;
+  otherVersion[8] = 2;
+  ASSERT_THROW(ExtensionSnapshot::openBuffer(otherVersion), SubstraitException);
+
+  // corrupt records are only read on lookup.
+  auto functionImpl = std::make_shared<ScalarFunctionImplementation>();
+  functionImpl->name = "f";
+  auto argument = std::make_shared<ValueArgument>();
+  argument->type = INTEGER();
+  functionImpl->arguments.emplace_back(argument);
+  functionImpl->returnType = INTEGER();
+  Extension extension;
+  extension.addScalarFunctionImpl(functionImpl);
+  std::string corrupt;
+  ExtensionSnapshot::write(extension, corrupt);
+  // the record ends in the argument tag, argument type, flags, return type
+  // and the empty return type expression.
+  corrupt[corrupt.size() - 5] = 9;
+  const auto snapshot = ExtensionSnapshot::openBuffer(corrupt);
+  ASSERT_THROW(
+      (void)snapshot->findFunctionImpls(FunctionKind::kScalar, "f"),
+      SubstraitException);
+}
+
+TEST_F(ExtensionTest, loadDefault) {
+#ifdef SUBSTRAIT_CPP_EMBED_DEFAULT_EXTENSIONS
+  const auto extension = Extension::loadDefault();
+  ASSERT_EQ(Extension::loadDefault(), extension);
+  assertSameExtension(
+      *Extension::load(getExtensionAbsolutePath()), *extension);
+
+  ScalarFunctionLookup lookup(extension);
+  const auto* functionImpl = lookup.lookupFunction("add", {BIGINT(), BIGINT()});
+  ASSERT_NE(functionImpl, nullptr);
+  ASSERT_EQ(functionImpl->uri, "extensions/functions_arithmetic.yaml");
+#else
+  ASSERT_THROW(Extension::loadDefault(), SubstraitException);
+#endif
+}
+
+TEST_F(ExtensionTest, lazyLoad) {
+  const auto extension = Extension::load(defaultExtensionPaths());
+  const auto lazy = Extension::loadLazy(defaultExtensionPaths());
+  ASSERT_TRUE(lazy->isLazy());
+
+  for (const auto kind : {FunctionKind::kScalar, FunctionKind::kAggregate}) {
+    assertSameImplementations(*extension, *lazy, kind);
+  }
+  assertSameExtension(*extension, *lazy);
+  ASSERT_EQ(lazy->typeVariantMap().size(), extension->typeVariantMap().size());
+  ASSERT_EQ(lazy->findFunctionImpls(FunctionKind::kScalar, "none"), nullptr);
+  assertSameExtension(
+      *extension, *Extension::loadLazy(getExtensionAbsolutePath()));
+
+  const std::vector<std::string> missing{
+      getExtensionAbsolutePath() + "missing.yaml"};
+  ASSERT_ANY_THROW(Extension::loadLazy(missing));
+}
+
+TEST_F(ExtensionTest, lazyFirstTouch) {
+  const auto lazy = Extension::loadLazy(defaultExtensionPaths());
+  const std::vector<std::string> names = {"add", "divide", "equal", "sum"};
+
+  // concurrent first lookups decode each function once.
+  constexpr int kNumThreads = 8;
+  std::vector<std::vector<const std::vector<FunctionImplementationPtr>*>>
+      found(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      ScalarFunctionLookup lookup(lazy);
+      ASSERT_NE(lookup.lookupFunction("add", {BIGINT(), BIGINT()}), nullptr);
+      for (const auto& name : names) {
+        const auto kind =
+            name == "sum" ? FunctionKind::kAggregate : FunctionKind::kScalar;
+        found[i].push_back(lazy->findFunctionImpls(kind, name));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    ASSERT_EQ(found[i], found[0]);
+    for (const auto* impls : found[i]) {
+      ASSERT_NE(impls, nullptr);
+      ASSERT_FALSE(impls->empty());
+    }
+  }
+}
+
+TEST_F(ExtensionTest, lazyLoadBlockStyles) {
+  const auto path = testing::TempDir() + "lazy_extension.yaml";
+  std::ofstream(path) << R"(%YAML 1.2
+---
+# a comment
+types:
+  - name: point
+scalar_functions:
+  - name: 'f' # the first
+    impls:
+      - args:
+          - name: x
+            value: i32
+        return: i32
+  -
+    # unquoted, not the first key
+    description: "g"
+    name: g
+    impls:
+      - args:
+          - value: i64
+        return: i64
+aggregate_functions:
+  - name: "h\x31"
+    impls:
+      - args:
+          - value: i32
+        return: i64
+)";
+  const auto lazy = Extension::loadLazy(std::vector<std::string>{path});
+  const auto extension = Extension::load(std::vector<std::string>{path});
+  for (const auto kind : {FunctionKind::kScalar, FunctionKind::kAggregate}) {
+    assertSameImplementations(*extension, *lazy, kind);
+  }
+  assertSameExtension(*extension, *lazy);
+  ASSERT_NE(lazy->findFunctionImpls(FunctionKind::kAggregate, "h1"), nullptr);
+  ASSERT_NE(lazy->lookupType("point"), nullptr);
+
+  // Sequences need not be indented below their key.
+  std::ofstream(path) << R"(scalar_functions:
+- name: f
+  impls:
+  - args:
+    - value: i32
+    return: i32
+-
+  name: g
+  impls:
+  - {args: [{value: i64}], return: i64}
+# a comment
+aggregate_functions:
+- {name: h, impls: [{args: [{value: i32}], return: i64}]}
+)";
+  const auto indentless = Extension::loadLazy(std::vector<std::string>{path});
+  const auto indentlessExtension =
+      Extension::load(std::vector<std::string>{path});
+  for (const auto kind : {FunctionKind::kScalar, FunctionKind::kAggregate}) {
+    assertSameImplementations(*indentlessExtension, *indentless, kind);
+  }
+  ASSERT_NE(indentless->findFunctionImpls(FunctionKind::kScalar, "g"), nullptr);
+  ASSERT_NE(
+      indentless->findFunctionImpls(FunctionKind::kAggregate, "h"), nullptr);
+
+  std::ofstream(path) << "scalar_functions: [{name: f, impls: []}]\n";
+  ASSERT_THROW(
+      Extension::loadLazy(std::vector<std::string>{path}), SubstraitException);
+  std::remove(path.c_str());
+}
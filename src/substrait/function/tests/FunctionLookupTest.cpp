@@ -3,9 +3,63 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include "substrait/function/FunctionLookup.h"
+#include "substrait/type/TypeFactory.h"
 
 using namespace io::substrait;
 
+namespace {
+
+/// Resolves the alias "plus" of add by overriding the signature lookup.
+class AliasFunctionLookup : public ScalarFunctionLookup {
+ public:
+  using ScalarFunctionLookup::lookupFunction;
+  using ScalarFunctionLookup::ScalarFunctionLookup;
+
+  [[nodiscard]] FunctionImplementationPtr lookupFunction(
+      const FunctionSignature& signature) const override {
+    auto aliased = signature;
+    if (aliased.name == "plus") {
+      aliased.name = "add";
+    }
+    return ScalarFunctionLookup::lookupFunction(aliased);
+  }
+};
+
+/// Matches any call by its name, whatever the argument types.
+struct AnyArgumentsImplementation : public ScalarFunctionImplementation {
+  using ScalarFunctionImplementation::tryMatch;
+
+  bool tryMatch(const FunctionSignature& signature) override {
+    return signature.name == name;
+  }
+};
+
+/// Looks up the scalar functions of the given names only.
+class FilteredFunctionLookup : public FunctionLookup {
+ public:
+  FilteredFunctionLookup(
+      const ExtensionPtr& extension,
+      std::vector<std::string> names)
+      : FunctionLookup(extension), names_(std::move(names)) {}
+
+ protected:
+  [[nodiscard]] FunctionImplMap getFunctionImpls() const override {
+    FunctionImplMap functionImpls;
+    for (const auto& name : names_) {
+      if (const auto* impls =
+              extension_->findFunctionImpls(FunctionKind::kScalar, name)) {
+        functionImpls.emplace(name, *impls);
+      }
+    }
+    return functionImpls;
+  }
+
+ private:
+  const std::vector<std::string> names_;
+};
+
+} // namespace
+
 class FunctionLookupTest : public ::testing::Test {
  protected:
   static std::string getExtensionAbsolutePath() {
@@ -42,6 +96,56 @@ class FunctionLookupTest : public ::testing::Test {
     ASSERT_EQ(functionImpl->signature(), outputSignature);
   }
 
+  void testScalarFunctionBindings(
+      const FunctionSignature& inputSignature,
+      const std::string& outputSignature,
+      const std::vector<std::pair<std::string, int64_t>>& values) {
+    TypeBindings bindings;
+    const auto& functionImpl =
+        scalarFunctionLookup_->lookupFunction(inputSignature, bindings);
+
+    ASSERT_TRUE(functionImpl != nullptr);
+    ASSERT_EQ(functionImpl->signature(), outputSignature);
+    for (const auto& [name, value] : values) {
+      ASSERT_EQ(bindings.findValue(name), value) << name;
+    }
+  }
+
+  void testScalarFunctionReturnType(
+      const FunctionSignature& inputSignature,
+      const TypePtr& returnType) {
+    TypeBindings bindings;
+    const auto& functionImpl =
+        scalarFunctionLookup_->lookupFunction(inputSignature, bindings);
+
+    ASSERT_TRUE(functionImpl != nullptr);
+    ASSERT_EQ(functionImpl->deriveReturnType(bindings), returnType);
+  }
+
+  void testNoScalarFunction(const FunctionSignature& inputSignature) {
+    ASSERT_EQ(scalarFunctionLookup_->lookupFunction(inputSignature), nullptr);
+  }
+
+  void testBorrowedScalarFunctionLookup(
+      const std::string& name,
+      const std::vector<TypeRef>& arguments,
+      TypeRef returnType,
+      const std::string& outputSignature) {
+    const auto* functionImpl =
+        scalarFunctionLookup_->lookupFunction(name, arguments, returnType);
+
+    ASSERT_TRUE(functionImpl != nullptr);
+    ASSERT_EQ(functionImpl->signature(), outputSignature);
+  }
+
+  const FunctionImplementation* lookupCoercibleScalarFunction(
+      const std::string& name,
+      const std::vector<TypeRef>& arguments,
+      TypeBindings& bindings) {
+    return scalarFunctionLookup_->lookupCoercibleFunction(
+        name, arguments, bindings);
+  }
+
  private:
   FunctionLookupPtr scalarFunctionLookup_;
   FunctionLookupPtr aggregateFunctionLookup_;
@@ -108,3 +212,127 @@ TEST_F(FunctionLookupTest, string_function) {
       {"substring", {STRING(), INTEGER(), INTEGER()}, STRING()},
       "substring:str_i32_i32");
 }
+
+TEST_F(FunctionLookupTest, borrowed_types) {
+  // interned types are immortal, so borrowing from temporaries is fine.
+  testBorrowedScalarFunctionLookup(
+      "lt", {INTEGER(), INTEGER()}, BOOL(), "lt:any1_any1");
+  testBorrowedScalarFunctionLookup(
+      "add", {TINYINT(), TINYINT()}, TINYINT(), "add:i8_i8");
+  testBorrowedScalarFunctionLookup(
+      "and", {BOOL(), BOOL(), BOOL()}, {}, "and:bool");
+
+  const auto varchar = VARCHAR(10);
+  testBorrowedScalarFunctionLookup(
+      "lt", {*varchar, *varchar}, {}, "lt:any1_any1");
+}
+
+TEST_F(FunctionLookupTest, placeholder_bindings) {
+  // both any1 arguments have to bind to the same type.
+  testNoScalarFunction({"lt", {INTEGER(), BIGINT()}, BOOL()});
+  testNoScalarFunction({"lt", {DECIMAL(10, 2), DECIMAL(10, 3)}, BOOL()});
+  testScalarFunctionLookup(
+      {"lt", {INTEGER(), TypeFactory::scalar<TypeKind::kI32>(true)}, BOOL()},
+      "lt:any1_any1");
+
+  testScalarFunctionBindings(
+      {"add", {DECIMAL(10, 2), DECIMAL(12, 4)}, nullptr},
+      "add:dec<P1,S1>_dec<P2,S2>",
+      {{"P1", 10}, {"S1", 2}, {"P2", 12}, {"S2", 4}});
+}
+
+TEST_F(FunctionLookupTest, derive_return_type) {
+  testScalarFunctionReturnType(
+      {"add", {DECIMAL(10, 2), DECIMAL(12, 4)}, nullptr}, DECIMAL(13, 4));
+  testScalarFunctionReturnType(
+      {"multiply", {DECIMAL(20, 5), DECIMAL(20, 5)}, nullptr},
+      DECIMAL(38, 7));
+  testScalarFunctionReturnType(
+      {"add", {INTEGER(), INTEGER()}, nullptr}, INTEGER());
+  testScalarFunctionReturnType({"lt", {INTEGER(), INTEGER()}, nullptr}, BOOL());
+}
+
+TEST_F(FunctionLookupTest, append_signature) {
+  TypeBindings bindings;
+  const auto* add = lookupCoercibleScalarFunction(
+      "add", {DECIMAL(10, 2), DECIMAL(12, 4)}, bindings);
+  ASSERT_NE(add, nullptr);
+  fmt::memory_buffer out;
+  add->appendSignature(out);
+  out.push_back(' ');
+  add->arguments[0]->appendTypeString(out);
+  ASSERT_EQ(fmt::to_string(out), add->signature() + " dec<P1,S1>");
+  ASSERT_EQ(add->arguments[1]->toTypeString(), "dec<P2,S2>");
+}
+
+TEST_F(FunctionLookupTest, coercible_function) {
+  const auto signatureOf = [this](const std::vector<TypeRef>& arguments) {
+    TypeBindings bindings;
+    const auto* functionImpl =
+        lookupCoercibleScalarFunction("add", arguments, bindings);
+    return functionImpl ? functionImpl->signature() : "";
+  };
+  // exact matches are preferred.
+  ASSERT_EQ(signatureOf({INTEGER(), INTEGER()}), "add:i32_i32");
+  // i32 widens to i64 more cheaply than both widen to a decimal or fp64.
+  ASSERT_EQ(signatureOf({INTEGER(), BIGINT()}), "add:i64_i64");
+  ASSERT_EQ(signatureOf({TINYINT(), SMALLINT()}), "add:i16_i16");
+  ASSERT_EQ(signatureOf({FLOAT(), BIGINT()}), "add:fp64_fp64");
+  ASSERT_EQ(signatureOf({BOOL(), INTEGER()}), "");
+
+  TypeBindings bindings;
+  const auto* functionImpl = lookupCoercibleScalarFunction(
+      "add", {DECIMAL(10, 2), INTEGER()}, bindings);
+  ASSERT_NE(functionImpl, nullptr);
+  ASSERT_EQ(functionImpl->signature(), "add:dec<P1,S1>_dec<P2,S2>");
+  ASSERT_EQ(bindings.findValue("P2"), 10);
+  ASSERT_EQ(bindings.findValue("S2"), 0);
+
+  // both any1 arguments bind to their common supertype.
+  functionImpl = lookupCoercibleScalarFunction(
+      "lt", {INTEGER(), BIGINT()}, bindings);
+  ASSERT_NE(functionImpl, nullptr);
+  ASSERT_EQ(functionImpl->signature(), "lt:any1_any1");
+  ASSERT_EQ(bindings.findType("any1")->signature(), "i64");
+  ASSERT_EQ(
+      functionImpl->deriveReturnType(bindings)->signature(),
+      BOOL()->signature());
+
+  ASSERT_EQ(
+      lookupCoercibleScalarFunction("lt", {BOOL(), INTEGER()}, bindings),
+      nullptr);
+  ASSERT_TRUE(bindings.empty());
+}
+
+TEST_F(FunctionLookupTest, override_signature_lookup) {
+  const FunctionLookupPtr lookup = std::make_shared<AliasFunctionLookup>(
+      Extension::load(getExtensionAbsolutePath()));
+  const auto functionImpl =
+      lookup->lookupFunction({"plus", {TINYINT(), TINYINT()}, TINYINT()});
+  ASSERT_NE(functionImpl, nullptr);
+  ASSERT_EQ(functionImpl->signature(), "add:i8_i8");
+}
+
+TEST_F(FunctionLookupTest, override_function_impls) {
+  const FunctionLookupPtr lookup = std::make_shared<FilteredFunctionLookup>(
+      Extension::load(getExtensionAbsolutePath()),
+      std::vector<std::string>{"add"});
+  const auto functionImpl =
+      lookup->lookupFunction({"add", {TINYINT(), TINYINT()}, TINYINT()});
+  ASSERT_NE(functionImpl, nullptr);
+  ASSERT_EQ(functionImpl->signature(), "add:i8_i8");
+  ASSERT_EQ(
+      lookup->lookupFunction({"subtract", {TINYINT(), TINYINT()}, TINYINT()}),
+      nullptr);
+}
+
+TEST_F(FunctionLookupTest, override_implementation_match) {
+  auto extension = std::make_shared<Extension>();
+  auto functionImpl = std::make_shared<AnyArgumentsImplementation>();
+  functionImpl->name = "any";
+  extension->addScalarFunctionImpl(functionImpl);
+  const ScalarFunctionLookup lookup(extension);
+  ASSERT_EQ(
+      lookup.lookupFunction({"any", {BOOL(), DOUBLE()}, nullptr}),
+      functionImpl);
+}
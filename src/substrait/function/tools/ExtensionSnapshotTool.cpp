@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <exception>
+#include <iostream>
+
+#include "substrait/function/ExtensionSnapshot.h"
+
+using namespace io::substrait;
+
+/// Compile extension YAML files into a snapshot for
+/// ExtensionSnapshot::openFile:
+///
+///   substrait_extension_snapshot <snapshot> [<extension.yaml>...]
+///
+/// Without extension files, Extension::defaultExtensionFiles() are compiled
+/// from the extensions directory of the working directory.
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <snapshot> [<extension.yaml>...]"
+              << std::endl;
+    return 2;
+  }
+  try {
+    const auto extension = argc > 2
+        ? Extension::load(std::vector<std::string>(argv + 2, argv + argc))
+        : Extension::load("extensions/", Extension::defaultExtensionFiles());
+    ExtensionSnapshot::writeFile(*extension, argv[1]);
+  } catch (const std::exception& e) {
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
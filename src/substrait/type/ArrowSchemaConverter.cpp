@@ -0,0 +1,462 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/ArrowSchemaConverter.h"
+
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <new>
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeFactory.h"
+
+namespace io::substrait {
+
+namespace {
+
+constexpr std::string_view kExtensionNameKey = "ARROW:extension:name";
+constexpr std::string_view kUuidExtensionName = "arrow.uuid";
+
+/// Longest format string of a type, e.g. "d:38,10,256".
+constexpr size_t kMaxFormatSize = 32;
+
+/// Arrow metadata is the number of key value pairs followed by the length
+/// prefixed keys and values, all lengths in native byte order.
+const std::string& uuidMetadata() {
+  static const std::string metadata = []() {
+    std::string result;
+    const auto appendInt32 = [&result](size_t value) {
+      const auto int32 = static_cast<int32_t>(value);
+      result.append(reinterpret_cast<const char*>(&int32), sizeof(int32));
+    };
+    appendInt32(1);
+    appendInt32(kExtensionNameKey.size());
+    result.append(kExtensionNameKey);
+    appendInt32(kUuidExtensionName.size());
+    result.append(kUuidExtensionName);
+    return result;
+  }();
+  return metadata;
+}
+
+bool isUuidExtension(const char* metadata) {
+  if (metadata == nullptr) {
+    return false;
+  }
+  const auto readInt32 = [&metadata]() {
+    int32_t value;
+    std::memcpy(&value, metadata, sizeof(value));
+    metadata += sizeof(value);
+    return value;
+  };
+  const auto readString = [&metadata, &readInt32]() {
+    const auto size = readInt32();
+    std::string_view value(metadata, size);
+    metadata += size;
+    return value;
+  };
+  for (auto numPairs = readInt32(); numPairs > 0; --numPairs) {
+    const auto key = readString();
+    const auto value = readString();
+    if (key == kExtensionNameKey) {
+      return value == kUuidExtensionName;
+    }
+  }
+  return false;
+}
+
+/// Format string of a type, formatted into the buffer if it has parameters.
+std::string_view formatOf(const Type& type, char* buffer) {
+  const auto formatTo = [buffer](const char* format, auto... args) {
+    const auto result = fmt::format_to_n(
+        buffer, kMaxFormatSize, fmt::runtime(format), args...);
+    return std::string_view(buffer, result.size);
+  };
+  switch (type.kind()) {
+    case TypeKind::kBool:
+      return "b";
+    case TypeKind::kI8:
+      return "c";
+    case TypeKind::kI16:
+      return "s";
+    case TypeKind::kI32:
+      return "i";
+    case TypeKind::kI64:
+      return "l";
+    case TypeKind::kFp32:
+      return "f";
+    case TypeKind::kFp64:
+      return "g";
+    case TypeKind::kString:
+    case TypeKind::kVarchar:
+    case TypeKind::kFixedChar:
+      return "u";
+    case TypeKind::kBinary:
+      return "z";
+    case TypeKind::kTimestamp:
+      return "tsu:";
+    case TypeKind::kTimestampTz:
+      return "tsu:UTC";
+    case TypeKind::kDate:
+      return "tdD";
+    case TypeKind::kTime:
+      return "ttu";
+    case TypeKind::kIntervalYear:
+      return "tiM";
+    case TypeKind::kIntervalDay:
+      return "tiD";
+    case TypeKind::kUuid:
+      return "w:16";
+    case TypeKind::kFixedBinary:
+      return formatTo("w:{}", cast<FixedBinary>(type).length());
+    case TypeKind::kDecimal: {
+      const auto& decimal = cast<Decimal>(type);
+      if (decimal.precision() > 38) {
+        return formatTo(
+            "d:{},{},256", decimal.precision(), decimal.scale());
+      }
+      return formatTo("d:{},{}", decimal.precision(), decimal.scale());
+    }
+    case TypeKind::kStruct:
+      return "+s";
+    case TypeKind::kList:
+      return "+l";
+    case TypeKind::kMap:
+      return "+m";
+    default:
+      SUBSTRAIT_UNSUPPORTED(
+          "Type {} has no Arrow counterpart", type.signature());
+  }
+}
+
+/// Header of the single allocation holding an exported schema tree, followed
+/// by the child nodes, the children arrays and the strings.
+struct ExportedBlock {
+  explicit ExportedBlock(int64_t numNodes) : liveNodes(numNodes) {}
+
+  /// Nodes not released yet, including children moved out of the tree.
+  std::atomic<int64_t> liveNodes;
+};
+
+void releaseExported(ArrowSchema* schema) {
+  for (int64_t i = 0; i < schema->n_children; ++i) {
+    auto* child = schema->children[i];
+    // Children moved out of the tree have been marked released.
+    if (child->release != nullptr) {
+      child->release(child);
+    }
+  }
+  auto* block = static_cast<ExportedBlock*>(schema->private_data);
+  schema->release = nullptr;
+  if (block->liveNodes.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    block->~ExportedBlock();
+    ::operator delete(block);
+  }
+}
+
+/// Exports a type in two passes: the first one measures the tree so the
+/// second one can lay it out in a single allocation.
+class Exporter {
+ public:
+  explicit Exporter(const std::vector<std::string_view>& names)
+      : names_(names) {}
+
+  void run(const Type& type, ArrowSchema* out) {
+    visit<false>(type, "", nullptr);
+
+    // The root node is the caller's.
+    const auto numChildNodes = static_cast<size_t>(numNodes_ - 1);
+    const auto nodesOffset = sizeof(ExportedBlock);
+    const auto childrenOffset =
+        nodesOffset + numChildNodes * sizeof(ArrowSchema);
+    const auto charsOffset =
+        childrenOffset + numChildNodes * sizeof(ArrowSchema*);
+    auto* memory = static_cast<char*>(::operator new(charsOffset + numChars_));
+    block_ = new (memory) ExportedBlock(numNodes_);
+    nextNode_ = reinterpret_cast<ArrowSchema*>(memory + nodesOffset);
+    nextChild_ = reinterpret_cast<ArrowSchema**>(memory + childrenOffset);
+    nextChar_ = memory + charsOffset;
+    nextName_ = 0;
+
+    visit<true>(type, "", out);
+  }
+
+ private:
+  std::string_view nextName() {
+    return nextName_ < names_.size() ? names_[nextName_++] : "";
+  }
+
+  const char* copy(std::string_view text) {
+    auto* result = nextChar_;
+    std::memcpy(nextChar_, text.data(), text.size());
+    nextChar_[text.size()] = '\0';
+    nextChar_ += text.size() + 1;
+    return result;
+  }
+
+  /// Add a node, and let visitChildren add its children given the array of
+  /// their nodes, which is null while measuring.
+  template <bool kWrite, typename VisitChildren>
+  void addNode(
+      std::string_view format,
+      std::string_view name,
+      int64_t flags,
+      const char* metadata,
+      int64_t numChildren,
+      ArrowSchema* node,
+      VisitChildren visitChildren) {
+    if constexpr (kWrite) {
+      node->format = copy(format);
+      node->name = copy(name);
+      node->metadata = metadata;
+      node->flags = flags;
+      node->n_children = numChildren;
+      node->children = numChildren == 0 ? nullptr : nextChild_;
+      node->dictionary = nullptr;
+      node->release = &releaseExported;
+      node->private_data = block_;
+      for (int64_t i = 0; i < numChildren; ++i) {
+        *nextChild_++ = nextNode_++;
+      }
+      visitChildren(node->children);
+    } else {
+      ++numNodes_;
+      numChars_ += format.size() + name.size() + 2;
+      visitChildren(nullptr);
+    }
+  }
+
+  template <bool kWrite>
+  static ArrowSchema* child(ArrowSchema** children, size_t index) {
+    if constexpr (kWrite) {
+      return children[index];
+    } else {
+      return nullptr;
+    }
+  }
+
+  template <bool kWrite>
+  void visit(const Type& type, std::string_view name, ArrowSchema* node) {
+    char buffer[kMaxFormatSize];
+    const auto format = formatOf(type, buffer);
+    const int64_t flags = type.nullable() ? ARROW_FLAG_NULLABLE : 0;
+    switch (type.kind()) {
+      case TypeKind::kStruct: {
+        const auto& children = cast<Struct>(type).childArray();
+        addNode<kWrite>(
+            format,
+            name,
+            flags,
+            nullptr,
+            static_cast<int64_t>(children.size()),
+            node,
+            [&](ArrowSchema** nodes) {
+              for (size_t i = 0; i < children.size(); ++i) {
+                visit<kWrite>(
+                    *children[i], nextName(), child<kWrite>(nodes, i));
+              }
+            });
+        return;
+      }
+      case TypeKind::kList:
+        addNode<kWrite>(
+            format, name, flags, nullptr, 1, node, [&](ArrowSchema** nodes) {
+              visit<kWrite>(
+                  *cast<List>(type).elementType(),
+                  "item",
+                  child<kWrite>(nodes, 0));
+            });
+        return;
+      case TypeKind::kMap: {
+        const auto& map = cast<Map>(type);
+        addNode<kWrite>(
+            format, name, flags, nullptr, 1, node, [&](ArrowSchema** nodes) {
+              addNode<kWrite>(
+                  "+s",
+                  "entries",
+                  0,
+                  nullptr,
+                  2,
+                  child<kWrite>(nodes, 0),
+                  [&](ArrowSchema** entries) {
+                    visit<kWrite>(
+                        *map.keyType(), "key", child<kWrite>(entries, 0));
+                    visit<kWrite>(
+                        *map.valueType(), "value", child<kWrite>(entries, 1));
+                  });
+            });
+        return;
+      }
+      default: {
+        const char* metadata = type.kind() == TypeKind::kUuid
+            ? uuidMetadata().c_str()
+            : nullptr;
+        addNode<kWrite>(
+            format, name, flags, metadata, 0, node, [](ArrowSchema**) {});
+        return;
+      }
+    }
+  }
+
+  const std::vector<std::string_view>& names_;
+  size_t nextName_{0};
+
+  int64_t numNodes_{0};
+  size_t numChars_{0};
+
+  ExportedBlock* block_{nullptr};
+  ArrowSchema* nextNode_{nullptr};
+  ArrowSchema** nextChild_{nullptr};
+  char* nextChar_{nullptr};
+};
+
+int parseInt(std::string_view& text, std::string_view format) {
+  int value = 0;
+  const auto* end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, value);
+  if (result.ec != std::errc()) {
+    SUBSTRAIT_IVALID_ARGUMENT("Invalid Arrow format '{}'", format);
+  }
+  text.remove_prefix(result.ptr - text.data());
+  return value;
+}
+
+const ArrowSchema& childOf(const ArrowSchema& schema, int64_t index) {
+  if (index >= schema.n_children || schema.children[index] == nullptr) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Arrow format '{}' misses child {}", schema.format, index);
+  }
+  return *schema.children[index];
+}
+
+/// Import a type, appending the names of struct fields to names in depth
+/// first order if it is not null.
+TypePtr importNode(
+    const ArrowSchema& schema,
+    bool nullable,
+    std::vector<std::string>* names) {
+  if (schema.dictionary != nullptr) {
+    return importNode(*schema.dictionary, nullable, names);
+  }
+  const std::string_view format = schema.format;
+  auto& factory = TypeFactory::instance();
+  if (format.size() == 1) {
+    switch (format[0]) {
+      case 'b':
+        return TypeFactory::scalarType(TypeKind::kBool, nullable);
+      case 'c':
+        return TypeFactory::scalarType(TypeKind::kI8, nullable);
+      case 's':
+        return TypeFactory::scalarType(TypeKind::kI16, nullable);
+      case 'i':
+        return TypeFactory::scalarType(TypeKind::kI32, nullable);
+      case 'l':
+        return TypeFactory::scalarType(TypeKind::kI64, nullable);
+      case 'f':
+        return TypeFactory::scalarType(TypeKind::kFp32, nullable);
+      case 'g':
+        return TypeFactory::scalarType(TypeKind::kFp64, nullable);
+      case 'u':
+      case 'U':
+        return TypeFactory::scalarType(TypeKind::kString, nullable);
+      case 'z':
+      case 'Z':
+        return TypeFactory::scalarType(TypeKind::kBinary, nullable);
+      default:
+        break;
+    }
+  } else if (format == "tdD" || format == "tdm") {
+    return TypeFactory::scalarType(TypeKind::kDate, nullable);
+  } else if (format.size() == 3 && format.substr(0, 2) == "tt") {
+    return TypeFactory::scalarType(TypeKind::kTime, nullable);
+  } else if (format == "tiM") {
+    return TypeFactory::scalarType(TypeKind::kIntervalYear, nullable);
+  } else if (format == "tiD") {
+    return TypeFactory::scalarType(TypeKind::kIntervalDay, nullable);
+  } else if (
+      format.size() >= 4 && format.substr(0, 2) == "ts" && format[3] == ':') {
+    return TypeFactory::scalarType(
+        format.size() == 4 ? TypeKind::kTimestamp : TypeKind::kTimestampTz,
+        nullable);
+  } else if (format.substr(0, 2) == "w:") {
+    auto text = format.substr(2);
+    const auto length = parseInt(text, format);
+    if (length == 16 && isUuidExtension(schema.metadata)) {
+      return TypeFactory::scalarType(TypeKind::kUuid, nullable);
+    }
+    return factory.fixedBinary(length, nullable);
+  } else if (format.substr(0, 2) == "d:") {
+    auto text = format.substr(2);
+    const auto precision = parseInt(text, format);
+    if (text.empty() || text[0] != ',') {
+      SUBSTRAIT_IVALID_ARGUMENT("Invalid Arrow format '{}'", format);
+    }
+    text.remove_prefix(1);
+    const auto scale = parseInt(text, format);
+    return factory.decimal(precision, scale, nullable);
+  } else if (format == "+s") {
+    std::vector<TypePtr> children;
+    children.reserve(schema.n_children);
+    for (int64_t i = 0; i < schema.n_children; ++i) {
+      const auto& child = childOf(schema, i);
+      if (names != nullptr) {
+        names->emplace_back(child.name == nullptr ? "" : child.name);
+      }
+      children.emplace_back(importNode(
+          child, (child.flags & ARROW_FLAG_NULLABLE) != 0, names));
+    }
+    return factory.structType(children, nullable);
+  } else if (format == "+l" || format == "+L") {
+    const auto& element = childOf(schema, 0);
+    return factory.list(
+        importNode(
+            element, (element.flags & ARROW_FLAG_NULLABLE) != 0, names),
+        nullable);
+  } else if (format == "+m") {
+    const auto& entries = childOf(schema, 0);
+    const auto& key = childOf(entries, 0);
+    const auto& value = childOf(entries, 1);
+    auto keyType =
+        importNode(key, (key.flags & ARROW_FLAG_NULLABLE) != 0, names);
+    auto valueType =
+        importNode(value, (value.flags & ARROW_FLAG_NULLABLE) != 0, names);
+    return factory.map(keyType, valueType, nullable);
+  }
+  SUBSTRAIT_UNSUPPORTED("Arrow format '{}' is not supported", format);
+}
+
+} // namespace
+
+void ArrowSchemaConverter::exportType(const Type& type, ArrowSchema* out) {
+  Exporter({}).run(type, out);
+}
+
+void ArrowSchemaConverter::exportSchema(
+    const NamedStruct& schema,
+    ArrowSchema* out) {
+  const auto names = schema.names();
+  Exporter(names).run(*schema.type(), out);
+}
+
+TypePtr ArrowSchemaConverter::importType(const ArrowSchema& schema) {
+  return importNode(
+      schema, (schema.flags & ARROW_FLAG_NULLABLE) != 0, nullptr);
+}
+
+NamedStruct ArrowSchemaConverter::importSchema(const ArrowSchema& schema) {
+  if (std::string_view(schema.format) != "+s") {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Arrow schema of format '{}' is not a struct", schema.format);
+  }
+  std::vector<std::string> names;
+  auto type = importNode(
+      schema, (schema.flags & ARROW_FLAG_NULLABLE) != 0, &names);
+  // A dictionary of the root replaces its format.
+  if (!isa<Struct>(*type)) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Arrow schema imports as {}, not a struct", type->signature());
+  }
+  return NamedStruct(names, std::static_pointer_cast<const Struct>(type));
+}
+
+} // namespace io::substrait
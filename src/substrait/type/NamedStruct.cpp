@@ -0,0 +1,250 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/NamedStruct.h"
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/common/HashUtils.h"
+
+namespace io::substrait {
+
+namespace {
+
+char toLowerAscii(char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool equalsIgnoreCase(std::string_view left, std::string_view right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < left.size(); ++i) {
+    if (toLowerAscii(left[i]) != toLowerAscii(right[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// FNV-1a of the name combined with the level.
+uint64_t hashName(uint32_t level, std::string_view name, bool ignoreCase) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char c : name) {
+    hash ^= static_cast<unsigned char>(ignoreCase ? toLowerAscii(c) : c);
+    hash *= 0x100000001b3ULL;
+  }
+  return common::HashUtils::hashCombine(hash, level);
+}
+
+} // namespace
+
+NamedStruct::NamedStruct(
+    const std::vector<std::string>& names,
+    std::shared_ptr<const Struct> type)
+    : type_(std::move(type)) {
+  size_t arenaSize = 0;
+  for (const auto& name : names) {
+    arenaSize += name.size();
+  }
+  arena_.reserve(arenaSize);
+  fields_.reserve(names.size());
+
+  size_t nextName = 0;
+  addLevel(*type_, names, nextName);
+  if (nextName != names.size()) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "{} names given for a struct with {} fields",
+        names.size(),
+        nextName);
+  }
+  buildIndex();
+}
+
+uint32_t NamedStruct::addLevel(
+    const Struct& type,
+    const std::vector<std::string>& names,
+    size_t& nextName) {
+  const auto level = static_cast<uint32_t>(levels_.size());
+  const auto firstField = static_cast<uint32_t>(fields_.size());
+  const auto& children = type.childArray();
+  levels_.push_back({firstField, static_cast<uint32_t>(children.size())});
+  fields_.resize(fields_.size() + children.size());
+
+  for (size_t i = 0; i < children.size(); ++i) {
+    if (nextName >= names.size()) {
+      SUBSTRAIT_IVALID_ARGUMENT(
+          "{} names given for a struct with more fields", names.size());
+    }
+    const auto& name = names[nextName++];
+    fields_[firstField + i] = Field{
+        static_cast<uint32_t>(arena_.size()),
+        static_cast<uint32_t>(name.size()),
+        level,
+        kNoLevel,
+        false};
+    arena_.append(name);
+    // Nested fields are appended behind this level, keeping it contiguous.
+    const auto childLevel = addNested(children[i], names, nextName);
+    if (children[i]->kind() == TypeKind::kStruct) {
+      fields_[firstField + i].childLevel = childLevel;
+    }
+  }
+  return level;
+}
+
+uint32_t NamedStruct::addNested(
+    const TypePtr& type,
+    const std::vector<std::string>& names,
+    size_t& nextName) {
+  switch (type->kind()) {
+    case TypeKind::kStruct:
+      return addLevel(cast<Struct>(*type), names, nextName);
+    case TypeKind::kList:
+      addNested(cast<List>(*type).elementType(), names, nextName);
+      return kNoLevel;
+    case TypeKind::kMap: {
+      const auto& map = cast<Map>(*type);
+      addNested(map.keyType(), names, nextName);
+      addNested(map.valueType(), names, nextName);
+      return kNoLevel;
+    }
+    default:
+      return kNoLevel;
+  }
+}
+
+void NamedStruct::buildIndex() {
+  // At most half full, so probing always ends at an empty slot.
+  size_t capacity = 2;
+  while (capacity < 2 * fields_.size()) {
+    capacity *= 2;
+  }
+  slotMask_ = capacity - 1;
+  exactSlots_.assign(capacity, 0);
+  caselessSlots_.assign(capacity, 0);
+
+  for (uint32_t index = 0; index < fields_.size(); ++index) {
+    auto& field = fields_[index];
+    const auto name = nameOf(field);
+    if (findIndex(field.level, name, false).has_value()) {
+      SUBSTRAIT_IVALID_ARGUMENT("duplicate field name '{}'", name);
+    }
+    auto slot = hashName(field.level, name, false) & slotMask_;
+    while (exactSlots_[slot] != 0) {
+      slot = (slot + 1) & slotMask_;
+    }
+    exactSlots_[slot] = index + 1;
+
+    if (const auto other = findIndex(field.level, name, true)) {
+      fields_[*other].ambiguousIgnoringCase = true;
+      continue;
+    }
+    slot = hashName(field.level, name, true) & slotMask_;
+    while (caselessSlots_[slot] != 0) {
+      slot = (slot + 1) & slotMask_;
+    }
+    caselessSlots_[slot] = index + 1;
+  }
+}
+
+std::optional<uint32_t> NamedStruct::findIndex(
+    uint32_t level,
+    std::string_view name,
+    bool ignoreCase) const {
+  const auto& slots = ignoreCase ? caselessSlots_ : exactSlots_;
+  for (auto slot = hashName(level, name, ignoreCase) & slotMask_;;
+       slot = (slot + 1) & slotMask_) {
+    if (slots[slot] == 0) {
+      return std::nullopt;
+    }
+    const auto index = slots[slot] - 1;
+    const auto& field = fields_[index];
+    if (field.level == level &&
+        (ignoreCase ? equalsIgnoreCase(nameOf(field), name)
+                    : nameOf(field) == name)) {
+      return index;
+    }
+  }
+}
+
+std::optional<size_t> NamedStruct::find(
+    uint32_t level,
+    std::string_view name,
+    bool ignoreCase) const {
+  const auto index = findIndex(level, name, ignoreCase);
+  if (!index.has_value() ||
+      (ignoreCase && fields_[*index].ambiguousIgnoringCase)) {
+    return std::nullopt;
+  }
+  return *index - levels_[level].firstField;
+}
+
+std::string_view NamedStruct::nameAt(size_t index) const {
+  if (index >= size()) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "field {} out of range of {} fields", index, size());
+  }
+  return nameOf(fields_[index]);
+}
+
+std::vector<std::string_view> NamedStruct::names() const {
+  std::vector<std::string_view> names;
+  names.reserve(fields_.size());
+  uint32_t nextLevel = 0;
+  appendNames(type_, nextLevel, names);
+  return names;
+}
+
+void NamedStruct::appendNames(
+    const TypePtr& type,
+    uint32_t& nextLevel,
+    std::vector<std::string_view>& names) const {
+  // Levels were added in depth-first order, walking the type in the same
+  // order visits them one after another.
+  switch (type->kind()) {
+    case TypeKind::kStruct: {
+      const auto& level = levels_[nextLevel++];
+      const auto& children = cast<Struct>(*type).childArray();
+      for (uint32_t i = 0; i < level.numFields; ++i) {
+        names.emplace_back(nameOf(fields_[level.firstField + i]));
+        appendNames(children[i], nextLevel, names);
+      }
+      return;
+    }
+    case TypeKind::kList:
+      appendNames(cast<List>(*type).elementType(), nextLevel, names);
+      return;
+    case TypeKind::kMap: {
+      const auto& map = cast<Map>(*type);
+      appendNames(map.keyType(), nextLevel, names);
+      appendNames(map.valueType(), nextLevel, names);
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+std::optional<std::vector<size_t>> NamedStruct::resolvePath(
+    std::string_view path,
+    bool ignoreCase) const {
+  std::vector<size_t> ordinals;
+  uint32_t level = 0;
+  while (true) {
+    if (level == kNoLevel) {
+      return std::nullopt;
+    }
+    const auto dot = path.find('.');
+    const auto ordinal = find(level, path.substr(0, dot), ignoreCase);
+    if (!ordinal.has_value()) {
+      return std::nullopt;
+    }
+    ordinals.push_back(*ordinal);
+    if (dot == std::string_view::npos) {
+      return ordinals;
+    }
+    level = fields_[levels_[level].firstField + *ordinal].childLevel;
+    path.remove_prefix(dot + 1);
+  }
+}
+
+} // namespace io::substrait
@@ -0,0 +1,284 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/RowLayout.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "substrait/common/Exceptions.h"
+
+namespace io::substrait {
+
+namespace {
+
+/// Variable width fields hold the offset and size of their bytes.
+struct VariableSlot {
+  uint32_t offset;
+  uint32_t size;
+};
+
+size_t alignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+template <size_t kWidth>
+void scatterFixed(
+    const uint8_t* values,
+    uint8_t* rows,
+    const size_t* rowOffsets,
+    size_t offset,
+    size_t numRows,
+    size_t width = kWidth) {
+  for (size_t row = 0; row < numRows; ++row) {
+    std::memcpy(
+        rows + rowOffsets[row] + offset,
+        values + row * width,
+        kWidth == 0 ? width : kWidth);
+  }
+}
+
+template <size_t kWidth>
+void gatherFixed(
+    const uint8_t* const* rows,
+    size_t offset,
+    size_t numRows,
+    uint8_t* values,
+    size_t width = kWidth) {
+  for (size_t row = 0; row < numRows; ++row) {
+    std::memcpy(
+        values + row * width, rows[row] + offset, kWidth == 0 ? width : kWidth);
+  }
+}
+
+/// Copy fixed width values of a column into rows, instantiated for the widths
+/// of the fixed width kinds, 1, 2, 4, 8 and 16 bytes, so the copies compile
+/// to plain moves. Other widths, e.g. of fixedbinary<3>, take a memcpy of
+/// the runtime width.
+void scatterFixed(
+    size_t width,
+    const uint8_t* values,
+    uint8_t* rows,
+    const size_t* rowOffsets,
+    size_t offset,
+    size_t numRows) {
+  switch (width) {
+    case 1:
+      return scatterFixed<1>(values, rows, rowOffsets, offset, numRows);
+    case 2:
+      return scatterFixed<2>(values, rows, rowOffsets, offset, numRows);
+    case 4:
+      return scatterFixed<4>(values, rows, rowOffsets, offset, numRows);
+    case 8:
+      return scatterFixed<8>(values, rows, rowOffsets, offset, numRows);
+    case 16:
+      return scatterFixed<16>(values, rows, rowOffsets, offset, numRows);
+    default:
+      return scatterFixed<0>(values, rows, rowOffsets, offset, numRows, width);
+  }
+}
+
+void gatherFixed(
+    size_t width,
+    const uint8_t* const* rows,
+    size_t offset,
+    size_t numRows,
+    uint8_t* values) {
+  switch (width) {
+    case 1:
+      return gatherFixed<1>(rows, offset, numRows, values);
+    case 2:
+      return gatherFixed<2>(rows, offset, numRows, values);
+    case 4:
+      return gatherFixed<4>(rows, offset, numRows, values);
+    case 8:
+      return gatherFixed<8>(rows, offset, numRows, values);
+    case 16:
+      return gatherFixed<16>(rows, offset, numRows, values);
+    default:
+      return gatherFixed<0>(rows, offset, numRows, values, width);
+  }
+}
+
+} // namespace
+
+RowLayout::RowLayout(const Struct& type)
+    : fields_(type.childArray().size()),
+      nullBitmapSize_((type.childArray().size() + 7) / 8) {
+  const auto& children = type.childArray();
+  std::vector<uint32_t> alignments(children.size());
+  for (uint32_t i = 0; i < children.size(); ++i) {
+    const auto& layout = typeLayout(children[i]->kind());
+    switch (layout.layout) {
+      case PhysicalLayout::kFixedWidth:
+        fields_[i].width = layout.byteWidth;
+        alignments[i] = layout.alignment;
+        fixedFields_.push_back(i);
+        break;
+      case PhysicalLayout::kParameterWidth:
+        fields_[i].width = cast<FixedBinary>(*children[i]).length();
+        alignments[i] = 1;
+        fixedFields_.push_back(i);
+        break;
+      case PhysicalLayout::kVariableWidth:
+        fields_[i].width = sizeof(VariableSlot);
+        alignments[i] = alignof(VariableSlot);
+        variableFields_.push_back(i);
+        break;
+      case PhysicalLayout::kNested:
+        SUBSTRAIT_UNSUPPORTED(
+            "Field {} of nested type {} has no row layout",
+            i,
+            children[i]->signature());
+    }
+  }
+
+  // Placing the most aligned fields first leaves no padding between fields.
+  std::vector<uint32_t> order(children.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return alignments[a] > alignments[b];
+  });
+  size_t offset = nullBitmapSize_;
+  rowAlignment_ = 1;
+  for (const auto field : order) {
+    offset = alignUp(offset, alignments[field]);
+    fields_[field].offset = static_cast<uint32_t>(offset);
+    offset += fields_[field].width;
+    rowAlignment_ = std::max<size_t>(rowAlignment_, alignments[field]);
+  }
+  fixedSize_ = alignUp(offset, rowAlignment_);
+}
+
+void RowLayout::encode(
+    const std::vector<ColumnView>& columns,
+    size_t numRows,
+    std::vector<uint8_t>& rows,
+    std::vector<size_t>& rowOffsets) const {
+  if (columns.size() != fields_.size()) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "{} columns given for {} fields", columns.size(), fields_.size());
+  }
+
+  // Size the rows, the variable width sections are filled behind the fixed
+  // width ones.
+  std::vector<size_t> rowSizes(numRows, fixedSize_);
+  for (const auto field : variableFields_) {
+    const auto* offsets = columns[field].offsets;
+    for (size_t row = 0; row < numRows; ++row) {
+      rowSizes[row] += offsets[row + 1] - offsets[row];
+    }
+  }
+  rowOffsets.resize(numRows + 1);
+  size_t totalSize = 0;
+  for (size_t row = 0; row < numRows; ++row) {
+    rowOffsets[row] = totalSize;
+    totalSize += alignUp(rowSizes[row], rowAlignment_);
+  }
+  rowOffsets[numRows] = totalSize;
+  rows.assign(totalSize, 0);
+  auto* data = rows.data();
+
+  for (size_t field = 0; field < fields_.size(); ++field) {
+    const auto* validity = columns[field].validity;
+    if (validity == nullptr) {
+      continue;
+    }
+    const auto byte = field / 8;
+    const auto bit = field % 8;
+    for (size_t row = 0; row < numRows; ++row) {
+      const auto isNull = ~validity[row / 8] >> (row % 8) & 1;
+      data[rowOffsets[row] + byte] |= static_cast<uint8_t>(isNull << bit);
+    }
+  }
+
+  for (const auto field : fixedFields_) {
+    const auto& layout = fields_[field];
+    scatterFixed(
+        layout.width,
+        columns[field].values,
+        data,
+        rowOffsets.data(),
+        layout.offset,
+        numRows);
+  }
+
+  // Reuse the row sizes as the write positions in the variable sections.
+  std::fill(rowSizes.begin(), rowSizes.end(), fixedSize_);
+  for (const auto field : variableFields_) {
+    const auto& column = columns[field];
+    const auto offset = fields_[field].offset;
+    for (size_t row = 0; row < numRows; ++row) {
+      auto* rowData = data + rowOffsets[row];
+      const VariableSlot slot{
+          static_cast<uint32_t>(rowSizes[row]),
+          static_cast<uint32_t>(column.offsets[row + 1] - column.offsets[row])};
+      std::memcpy(rowData + offset, &slot, sizeof(slot));
+      std::memcpy(
+          rowData + slot.offset,
+          column.values + column.offsets[row],
+          slot.size);
+      rowSizes[row] += slot.size;
+    }
+  }
+}
+
+void RowLayout::decode(
+    const uint8_t* const* rows,
+    size_t numRows,
+    std::vector<ColumnBuffers>& columns) const {
+  columns.resize(fields_.size());
+
+  const auto validityBytes = (numRows + 7) / 8;
+  for (size_t field = 0; field < fields_.size(); ++field) {
+    const auto byte = field / 8;
+    const auto bit = field % 8;
+    uint8_t anyNull = 0;
+    for (size_t row = 0; row < numRows; ++row) {
+      anyNull |= rows[row][byte] >> bit & 1;
+    }
+    auto& validity = columns[field].validity;
+    if (anyNull == 0) {
+      validity.clear();
+      continue;
+    }
+    validity.assign(validityBytes, 0);
+    for (size_t row = 0; row < numRows; ++row) {
+      const auto isValid = ~rows[row][byte] >> bit & 1;
+      validity[row / 8] |= static_cast<uint8_t>(isValid << (row % 8));
+    }
+  }
+
+  for (const auto field : fixedFields_) {
+    const auto& layout = fields_[field];
+    auto& column = columns[field];
+    column.offsets.clear();
+    column.values.resize(numRows * layout.width);
+    gatherFixed(
+        layout.width, rows, layout.offset, numRows, column.values.data());
+  }
+
+  for (const auto field : variableFields_) {
+    const auto offset = fields_[field].offset;
+    auto& column = columns[field];
+    column.offsets.resize(numRows + 1);
+    column.offsets[0] = 0;
+    for (size_t row = 0; row < numRows; ++row) {
+      VariableSlot slot;
+      std::memcpy(&slot, rows[row] + offset, sizeof(slot));
+      column.offsets[row + 1] =
+          column.offsets[row] + static_cast<int32_t>(slot.size);
+    }
+    column.values.resize(column.offsets[numRows]);
+    for (size_t row = 0; row < numRows; ++row) {
+      VariableSlot slot;
+      std::memcpy(&slot, rows[row] + offset, sizeof(slot));
+      std::memcpy(
+          column.values.data() + column.offsets[row],
+          rows[row] + slot.offset,
+          slot.size);
+    }
+  }
+}
+
+} // namespace io::substrait
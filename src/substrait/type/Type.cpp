@@ -1,648 +1,1036 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 
 #include <algorithm>
-#include <sstream>
+#include <charconv>
+#include <fmt/format.h>
 #include <stdexcept>
 
 #include "substrait/common/Exceptions.h"
+#include "substrait/common/HashUtils.h"
 #include "substrait/common/NumberUtils.h"
 #include "substrait/common/StringUtils.h"
 #include "substrait/type/Type.h"
+#include "substrait/type/TypeBindings.h"
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeVisitor.h"
 
 namespace io::substrait {
 
 namespace {
 
-size_t findNextComma(std::string_view str, size_t start) {
-  int cnt = 0;
-  for (auto i = start; i < str.size(); i++) {
-    if (str[i] == '<') {
-      cnt++;
-    } else if (str[i] == '>') {
-      cnt--;
-    } else if (cnt == 0 && str[i] == ',') {
-      return i;
+/// Resolve a base type name, such as "i32" or "DECIMAL", to its kind by
+/// switching on the name length first. Returns KIND_NOT_SET for names which
+/// are not Substrait types, e.g. placeholders like "any1" or "P1".
+TypeKind lookupTypeKind(std::string_view name) {
+#define SUBSTRAIT_MATCH_KIND(KIND)                                          \
+  if (common::StringUtils::equalsIgnoreCase(                                \
+          name, TypeTraits<KIND>::typeString)) {                            \
+    return KIND;                                                            \
+  }
+  switch (name.size()) {
+    case 2:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kI8)
+      break;
+    case 3:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kI16)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kI32)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kI64)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kMap)
+      break;
+    case 4:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kFp32)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kFp64)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kUuid)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kDate)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kTime)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kList)
+      break;
+    case 6:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kString)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kBinary)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kStruct)
+      break;
+    case 7:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kBool)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kDecimal)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kVarchar)
+      break;
+    case 9:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kTimestamp)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kFixedChar)
+      break;
+    case 11:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kFixedBinary)
+      break;
+    case 12:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kIntervalDay)
+      SUBSTRAIT_MATCH_KIND(TypeKind::kTimestampTz)
+      break;
+    case 13:
+      SUBSTRAIT_MATCH_KIND(TypeKind::kIntervalYear)
+      break;
+    default:
+      break;
+  }
+#undef SUBSTRAIT_MATCH_KIND
+  return TypeKind::KIND_NOT_SET;
+}
+
+/// Types nested deeper than this are rejected, which bounds the recursion
+/// of the parser.
+constexpr int kMaxDepth = 128;
+
+/// Single pass recursive descent parser for type strings such as
+/// "i32?", "decimal<P1,S1>" or "STRUCT<list?<any1>,varchar<10>>". Works on
+/// views of the input and only allocates the resulting type nodes.
+class TypeParser {
+ public:
+  TypeParser(std::string_view input, bool isParameterized)
+      : input_(input), isParameterized_(isParameterized) {}
+
+  ParameterizedTypePtr parse() {
+    auto type = parseType(0);
+    skipWhitespace();
+    if (pos_ < input_.size()) {
+      fail("unexpected character '{}'", input_[pos_]);
     }
+    return type;
   }
 
-  return std::string::npos;
-}
+ private:
+  /// Delimiters of a type name, everything else belongs to the name.
+  static bool isDelimiter(char c) {
+    return c == '<' || c == '>' || c == ',' || c == '?';
+  }
 
-template <TypeKind kind>
-ParameterizedTypePtr decodeType(bool nullable) {
-  return std::make_shared<const ScalarType<kind>>(nullable);
-}
+  template <typename... Args>
+  [[noreturn]] void fail(const char* reason, const Args&... args) const {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Fail to decode type '{}' at position {}: {}",
+        input_,
+        pos_,
+        common::errorMessage(reason, args...));
+  }
 
-template <TypeKind kind>
-ParameterizedTypePtr decodeType(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  SUBSTRAIT_UNSUPPORTED(
-      "Unsupported parameter type: " + TypeTraits<kind>::typeString);
-}
+  void skipWhitespace() {
+    while (pos_ < input_.size() &&
+           std::isspace(static_cast<unsigned char>(input_[pos_]))) {
+      ++pos_;
+    }
+  }
 
-template <>
-ParameterizedTypePtr decodeType<TypeKind::kList>(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  if (isParameterized) {
-    return std::make_shared<ParameterizedList>(parameterTypes[0], nullable);
-  } else {
-    return std::make_shared<List>(
-        std::dynamic_pointer_cast<const Type>(parameterTypes[0]), nullable);
+  bool consume(char c) {
+    skipWhitespace();
+    if (pos_ < input_.size() && input_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
   }
-}
 
-template <>
-ParameterizedTypePtr decodeType<TypeKind::kMap>(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  if (isParameterized) {
-    return std::make_shared<ParameterizedMap>(
-        parameterTypes[0], parameterTypes[1], nullable);
-  } else {
-    return std::make_shared<Map>(
-        std::dynamic_pointer_cast<const Type>(parameterTypes[0]),
-        std::dynamic_pointer_cast<const Type>(parameterTypes[1]),
-        nullable);
+  ParameterizedTypePtr parseType(int depth) {
+    if (depth > kMaxDepth) {
+      fail("types nested deeper than {} levels", kMaxDepth);
+    }
+    skipWhitespace();
+    const auto start = pos_;
+    while (pos_ < input_.size() && !isDelimiter(input_[pos_])) {
+      ++pos_;
+    }
+    const auto name =
+        common::StringUtils::rtrim(input_.substr(start, pos_ - start));
+    if (name.empty()) {
+      fail("missing type name");
+    }
+
+    // Nullability may either follow the name or the parameters, i.e. both
+    // "list?<i32>" and "list<i32>?" are accepted.
+    bool nullable = consume('?');
+    const auto raw = nullable ? input_.substr(start, pos_ - start) : name;
+    const auto kind = lookupTypeKind(name);
+    if (!consume('<')) {
+      if (kind == TypeKind::KIND_NOT_SET || !isScalar(kind)) {
+        return makeStringLiteral(name, raw);
+      }
+      return makeScalar(kind, nullable);
+    }
+
+    const auto paramsPos = pos_;
+    std::vector<ParameterizedTypePtr> params;
+    do {
+      params.emplace_back(parseType(depth + 1));
+    } while (consume(','));
+    // Only the closing bracket of the outermost type may be omitted.
+    if (!consume('>') && (depth > 0 || pos_ < input_.size())) {
+      fail("expected '>'");
+    }
+    nullable = consume('?') || nullable;
+
+    switch (kind) {
+      case TypeKind::kList:
+        expectParams(params, 1, paramsPos);
+        if (isParameterized_) {
+          return std::make_shared<const ParameterizedList>(params[0], nullable);
+        }
+        return TypeFactory::instance().list(toType(params[0]), nullable);
+      case TypeKind::kMap:
+        expectParams(params, 2, paramsPos);
+        if (isParameterized_) {
+          return std::make_shared<const ParameterizedMap>(
+              params[0], params[1], nullable);
+        }
+        return TypeFactory::instance().map(
+            toType(params[0]), toType(params[1]), nullable);
+      case TypeKind::kStruct:
+        if (isParameterized_) {
+          return std::make_shared<const ParameterizedStruct>(
+              std::move(params), nullable);
+        } else {
+          std::vector<TypePtr> types;
+          types.reserve(params.size());
+          for (const auto& param : params) {
+            types.emplace_back(toType(param));
+          }
+          return TypeFactory::instance().structType(types, nullable);
+        }
+      case TypeKind::kDecimal: {
+        expectParams(params, 2, paramsPos);
+        if (isParameterized_) {
+          return std::make_shared<const ParameterizedDecimal>(
+              toLiteral(params[0]), toLiteral(params[1]), nullable);
+        }
+        const auto& precision = toLiteral(params[0])->value();
+        const auto& scale = toLiteral(params[1])->value();
+        if (!common::NumberUtils::isNonNegativeInteger(precision) ||
+            !common::NumberUtils::isNonNegativeInteger(scale)) {
+          SUBSTRAIT_FAIL(
+              "Fail decode to Decimal type, precision or scale parameter must be a positive number")
+        }
+        return TypeFactory::instance().decimal(
+            std::stoi(precision), std::stoi(scale), nullable);
+      }
+      case TypeKind::kVarchar:
+        return makeLengthType<ParameterizedVarchar>(
+            kind, params, paramsPos, nullable, [](int length, bool nullable) {
+              return TypeFactory::instance().varchar(length, nullable);
+            });
+      case TypeKind::kFixedChar:
+        return makeLengthType<ParameterizedFixedChar>(
+            kind, params, paramsPos, nullable, [](int length, bool nullable) {
+              return TypeFactory::instance().fixedChar(length, nullable);
+            });
+      case TypeKind::kFixedBinary:
+        return makeLengthType<ParameterizedFixedBinary>(
+            kind, params, paramsPos, nullable, [](int length, bool nullable) {
+              return TypeFactory::instance().fixedBinary(length, nullable);
+            });
+      default:
+        pos_ = start;
+        SUBSTRAIT_UNSUPPORTED(
+            "Unsupported type: {} at position {} of '{}'", name, pos_, input_);
+    }
   }
-}
 
-template <>
-ParameterizedTypePtr decodeType<TypeKind::kStruct>(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  if (isParameterized) {
-    return std::make_shared<const ParameterizedStruct>(
-        parameterTypes, nullable);
-  } else {
-    std::vector<TypePtr> types;
-    types.reserve(parameterTypes.size());
-    for (const auto& parameterType : parameterTypes) {
-      types.emplace_back(std::dynamic_pointer_cast<const Type>(parameterType));
+  static bool isScalar(TypeKind kind) {
+    switch (kind) {
+      case TypeKind::kFixedChar:
+      case TypeKind::kVarchar:
+      case TypeKind::kFixedBinary:
+      case TypeKind::kDecimal:
+      case TypeKind::kStruct:
+      case TypeKind::kList:
+      case TypeKind::kMap:
+        return false;
+      default:
+        return true;
     }
-    return std::make_shared<Struct>(types, nullable);
   }
-}
 
-template <>
-ParameterizedTypePtr decodeType<TypeKind::kDecimal>(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  auto precision =
-      std::dynamic_pointer_cast<const StringLiteral>(parameterTypes[0]);
-  auto scale =
-      std::dynamic_pointer_cast<const StringLiteral>(parameterTypes[1]);
+  static ParameterizedTypePtr makeScalar(TypeKind kind, bool nullable) {
+    switch (kind) {
+      case TypeKind::kBool:
+        return TypeFactory::scalar<TypeKind::kBool>(nullable);
+      case TypeKind::kI8:
+        return TypeFactory::scalar<TypeKind::kI8>(nullable);
+      case TypeKind::kI16:
+        return TypeFactory::scalar<TypeKind::kI16>(nullable);
+      case TypeKind::kI32:
+        return TypeFactory::scalar<TypeKind::kI32>(nullable);
+      case TypeKind::kI64:
+        return TypeFactory::scalar<TypeKind::kI64>(nullable);
+      case TypeKind::kFp32:
+        return TypeFactory::scalar<TypeKind::kFp32>(nullable);
+      case TypeKind::kFp64:
+        return TypeFactory::scalar<TypeKind::kFp64>(nullable);
+      case TypeKind::kString:
+        return TypeFactory::scalar<TypeKind::kString>(nullable);
+      case TypeKind::kBinary:
+        return TypeFactory::scalar<TypeKind::kBinary>(nullable);
+      case TypeKind::kTimestamp:
+        return TypeFactory::scalar<TypeKind::kTimestamp>(nullable);
+      case TypeKind::kDate:
+        return TypeFactory::scalar<TypeKind::kDate>(nullable);
+      case TypeKind::kTime:
+        return TypeFactory::scalar<TypeKind::kTime>(nullable);
+      case TypeKind::kIntervalYear:
+        return TypeFactory::scalar<TypeKind::kIntervalYear>(nullable);
+      case TypeKind::kIntervalDay:
+        return TypeFactory::scalar<TypeKind::kIntervalDay>(nullable);
+      case TypeKind::kTimestampTz:
+        return TypeFactory::scalar<TypeKind::kTimestampTz>(nullable);
+      case TypeKind::kUuid:
+        return TypeFactory::scalar<TypeKind::kUuid>(nullable);
+      default:
+        SUBSTRAIT_UNREACHABLE("Not a scalar type kind");
+    }
+  }
 
-  if (isParameterized) {
-    return std::make_shared<ParameterizedDecimal>(precision, scale, nullable);
-  } else {
-    if (common::NumberUtils::isNonNegativeInteger(precision->value()) &&
-        common::NumberUtils::isNonNegativeInteger(scale->value())) {
-      return std::make_shared<Decimal>(
-          std::stoi(precision->value()), std::stoi(scale->value()), nullable);
-    } else {
-      SUBSTRAIT_FAIL(
-          "Fail decode to Decimal type, precision or scale parameter must be a positive number")
+  /// A name which is not a scalar type is kept as a literal: a wildcard such
+  /// as "any1", a placeholder such as "P1" or an integer parameter.
+  static ParameterizedTypePtr makeStringLiteral(
+      std::string_view name,
+      std::string_view raw) {
+    const bool wildcard = name.size() >= 3 &&
+        common::StringUtils::equalsIgnoreCase(name.substr(0, 3), "any");
+    const bool placeholder = !wildcard && !common::NumberUtils::isInteger(raw);
+    return std::make_shared<const StringLiteral>(
+        std::string(raw), wildcard, placeholder);
+  }
+
+  void expectParams(
+      const std::vector<ParameterizedTypePtr>& params,
+      size_t expected,
+      size_t paramsPos) {
+    if (params.size() != expected) {
+      pos_ = paramsPos;
+      fail("expected {} type parameters but got {}", expected, params.size());
     }
   }
-}
 
-template <class ParameterizedTypeTag, class TypeTag, TypeKind kind>
-ParameterizedTypePtr decodeLengthBaseType(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  auto length =
-      std::dynamic_pointer_cast<const StringLiteral>(parameterTypes[0]);
-  if (isParameterized) {
-    return std::make_shared<ParameterizedTypeTag>(length, nullable);
-  } else {
-    if (common::NumberUtils::isNonNegativeInteger(length->value())) {
-      return std::make_shared<TypeTag>(std::stoi(length->value()), nullable);
-    } else {
+  StringLiteralPtr toLiteral(const ParameterizedTypePtr& param) const {
+    if (!isa<StringLiteral>(*param)) {
+      fail("expected an integer or placeholder parameter");
+    }
+    return std::static_pointer_cast<const StringLiteral>(param);
+  }
+
+  TypePtr toType(const ParameterizedTypePtr& param) const {
+    if (!isa<Type>(*param)) {
+      fail("expected a concrete type parameter but got {}", param->signature());
+    }
+    return std::static_pointer_cast<const Type>(param);
+  }
+
+  template <typename ParameterizedTypeT, typename Creator>
+  ParameterizedTypePtr makeLengthType(
+      TypeKind kind,
+      const std::vector<ParameterizedTypePtr>& params,
+      size_t paramsPos,
+      bool nullable,
+      Creator creator) {
+    expectParams(params, 1, paramsPos);
+    auto length = toLiteral(params[0]);
+    if (isParameterized_) {
+      return std::make_shared<const ParameterizedTypeT>(
+          std::move(length), nullable);
+    }
+    if (!common::NumberUtils::isNonNegativeInteger(length->value())) {
       SUBSTRAIT_FAIL(
           "Fail decode to {} type, length parameter must be a positive integer",
-          TypeTraits<kind>::typeString);
+          typeString(kind));
     }
+    return creator(std::stoi(length->value()), nullable);
   }
-}
 
-template <>
-ParameterizedTypePtr decodeType<TypeKind::kVarchar>(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  return decodeLengthBaseType<
-      ParameterizedVarchar,
-      Varchar,
-      TypeKind::kVarchar>(isParameterized, nullable, parameterTypes);
-}
+  static const char* typeString(TypeKind kind) {
+    switch (kind) {
+      case TypeKind::kVarchar:
+        return TypeTraits<TypeKind::kVarchar>::typeString;
+      case TypeKind::kFixedChar:
+        return TypeTraits<TypeKind::kFixedChar>::typeString;
+      default:
+        return TypeTraits<TypeKind::kFixedBinary>::typeString;
+    }
+  }
 
-template <>
-ParameterizedTypePtr decodeType<TypeKind::kFixedChar>(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  return decodeLengthBaseType<
-      ParameterizedFixedChar,
-      FixedChar,
-      TypeKind::kFixedChar>(isParameterized, nullable, parameterTypes);
+  const std::string_view input_;
+  const bool isParameterized_;
+  size_t pos_ = 0;
+};
+
+} // namespace
+
+ParameterizedTypePtr ParameterizedType::decode(
+    const std::string& rawType,
+    bool isParameterized) {
+  return TypeParser(rawType, isParameterized).parse();
 }
 
-template <>
-ParameterizedTypePtr decodeType<TypeKind::kFixedBinary>(
-    bool isParameterized,
-    bool nullable,
-    const std::vector<ParameterizedTypePtr>& parameterTypes) {
-  return decodeLengthBaseType<
-      ParameterizedFixedBinary,
-      FixedBinary,
-      TypeKind::kBinary>(isParameterized, nullable, parameterTypes);
+namespace {
+
+/// Interned types are immortal, so an array can hold them through a shared
+/// pointer without a control block, copying which touches no counters.
+void unownIfInterned(TypePtr& type) {
+  // Types handed out by the factory have no control block already.
+  if (type.use_count() != 0 && type->isInterned()) {
+    const auto* raw = type.get();
+    type = TypePtr(TypePtr(), raw);
+  }
 }
 
 } // namespace
 
-ParameterizedTypePtr ParameterizedType::decode(
-    const std::string& value,
-    bool isParameterized) {
-  std::string rawType =
-      static_cast<std::string>(common::StringUtils::trim(value));
-  std::string matchingType = rawType;
-  std::transform(
-      matchingType.begin(),
-      matchingType.end(),
-      matchingType.begin(),
-      [](unsigned char c) { return std::tolower(c); });
-
-  const auto& questionMaskPos = matchingType.find_last_of('?');
-
-  bool nullable = questionMaskPos != std::string::npos;
-
-  const auto& leftAngleBracketPos = matchingType.find('<');
-  if (leftAngleBracketPos == std::string::npos) {
-    // deal with type and with a question mask like "i32?".
-    const auto& baseType = nullable
-        ? matchingType = matchingType.substr(0, questionMaskPos)
-        : matchingType;
-
-    if (TypeTraits<TypeKind::kBool>::typeString == baseType) {
-      return decodeType<TypeKind::kBool>(nullable);
-    } else if (TypeTraits<TypeKind::kI8>::typeString == baseType) {
-      return decodeType<TypeKind::kI8>(nullable);
-    } else if (TypeTraits<TypeKind::kI16>::typeString == baseType) {
-      return decodeType<TypeKind::kI16>(nullable);
-    } else if (TypeTraits<TypeKind::kI32>::typeString == baseType) {
-      return decodeType<TypeKind::kI32>(nullable);
-    } else if (TypeTraits<TypeKind::kI64>::typeString == baseType) {
-      return decodeType<TypeKind::kI64>(nullable);
-    } else if (TypeTraits<TypeKind::kFp32>::typeString == baseType) {
-      return decodeType<TypeKind::kFp32>(nullable);
-    } else if (TypeTraits<TypeKind::kFp64>::typeString == baseType) {
-      return decodeType<TypeKind::kFp64>(nullable);
-    } else if (TypeTraits<TypeKind::kString>::typeString == baseType) {
-      return decodeType<TypeKind::kString>(nullable);
-    } else if (TypeTraits<TypeKind::kBinary>::typeString == baseType) {
-      return decodeType<TypeKind::kBinary>(nullable);
-    } else if (TypeTraits<TypeKind::kUuid>::typeString == baseType) {
-      return decodeType<TypeKind::kUuid>(nullable);
-    } else if (TypeTraits<TypeKind::kIntervalYear>::typeString == baseType) {
-      return decodeType<TypeKind::kIntervalYear>(nullable);
-    } else if (TypeTraits<TypeKind::kIntervalDay>::typeString == baseType) {
-      return decodeType<TypeKind::kIntervalDay>(nullable);
-    } else if (TypeTraits<TypeKind::kTimestamp>::typeString == baseType) {
-      return decodeType<TypeKind::kTimestamp>(nullable);
-    } else if (TypeTraits<TypeKind::kTimestampTz>::typeString == baseType) {
-      return decodeType<TypeKind::kTimestampTz>(nullable);
-    } else if (TypeTraits<TypeKind::kDate>::typeString == baseType) {
-      return decodeType<TypeKind::kDate>(nullable);
-    } else if (TypeTraits<TypeKind::kTime>::typeString == baseType) {
-      return decodeType<TypeKind::kTime>(nullable);
-    } else {
-      bool wildcard = matchingType.rfind("any", 0) == 0;
-      bool placeholder = !wildcard && !common::NumberUtils::isInteger(rawType);
-      return std::make_shared<const StringLiteral>(
-          rawType, wildcard, placeholder);
-    }
+TypeArray::TypeArray(std::vector<TypePtr> types) : size_(types.size()) {
+  if (size_ > kInlineCapacity) {
+    heap_ = std::move(types);
+    data_ = heap_.data();
   } else {
-    const auto& rightAngleBracketPos = rawType.rfind('>');
-    const auto& baseTypePos = nullable
-        ? std::min(leftAngleBracketPos, questionMaskPos)
-        : leftAngleBracketPos;
-
-    const auto& baseType = matchingType.substr(0, baseTypePos);
-
-    std::vector<ParameterizedTypePtr> nestedTypes;
-    auto prevPos = leftAngleBracketPos + 1;
-    auto commaPos = findNextComma(rawType, prevPos);
-    while (commaPos != std::string::npos) {
-      auto token = rawType.substr(prevPos, commaPos - prevPos);
-      nestedTypes.emplace_back(decode(token.data(), isParameterized));
-      prevPos = commaPos + 1;
-      commaPos = findNextComma(rawType, prevPos);
-    }
-    auto token = rawType.substr(prevPos, rightAngleBracketPos - prevPos);
-    nestedTypes.emplace_back(decode(token.data(), isParameterized));
-
-    if (TypeTraits<TypeKind::kList>::typeString == baseType) {
-      return decodeType<TypeKind::kList>(
-          isParameterized, nullable, nestedTypes);
-    } else if (TypeTraits<TypeKind::kMap>::typeString == baseType) {
-      return decodeType<TypeKind::kMap>(isParameterized, nullable, nestedTypes);
-    } else if (TypeTraits<TypeKind::kStruct>::typeString == baseType) {
-      return decodeType<TypeKind::kStruct>(
-          isParameterized, nullable, nestedTypes);
-    } else if (TypeTraits<TypeKind::kDecimal>::typeString == baseType) {
-      return decodeType<TypeKind::kDecimal>(
-          isParameterized, nullable, nestedTypes);
-    } else if (TypeTraits<TypeKind::kVarchar>::typeString == baseType) {
-      return decodeType<TypeKind::kVarchar>(
-          isParameterized, nullable, nestedTypes);
-    } else if (TypeTraits<TypeKind::kFixedChar>::typeString == baseType) {
-      return decodeType<TypeKind::kFixedChar>(
-          isParameterized, nullable, nestedTypes);
-    } else if (TypeTraits<TypeKind::kFixedBinary>::typeString == baseType) {
-      return decodeType<TypeKind::kFixedBinary>(
-          isParameterized, nullable, nestedTypes);
-    } else {
-      SUBSTRAIT_UNSUPPORTED("Unsupported type: " + rawType);
-    }
+    std::move(types.begin(), types.end(), inline_);
+  }
+  for (size_t i = 0; i < size_; ++i) {
+    unownIfInterned(data_[i]);
   }
 }
 
-std::string Decimal::signature() const {
-  std::stringstream sign;
-  sign << TypeBase::signature();
-  sign << "<" << precision_ << "," << scale_ << ">";
-  return sign.str();
+TypeArray::TypeArray(const TypeArray& other)
+    : size_(other.size_), heap_(other.heap_) {
+  if (size_ > kInlineCapacity) {
+    data_ = heap_.data();
+  } else {
+    std::copy(other.begin(), other.end(), inline_);
+  }
 }
 
-bool Decimal::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto decimalType = std::dynamic_pointer_cast<const Decimal>(type)) {
-    return TypeBase::isMatch(type) && precision_ == decimalType->precision() &&
-        scale_ == decimalType->scale();
+TypeArray::TypeArray(TypeArray&& other) noexcept
+    : size_(other.size_), heap_(std::move(other.heap_)) {
+  if (size_ > kInlineCapacity) {
+    data_ = heap_.data();
+  } else {
+    std::move(other.begin(), other.end(), inline_);
   }
-
-  return false;
+  other.data_ = other.inline_;
+  other.size_ = 0;
 }
 
-std::string FixedBinary::signature() const {
-  std::stringstream sign;
-  sign << TypeBase::signature();
-  sign << "<" << length() << ">";
-  return sign.str();
-}
-bool FixedBinary::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto fBinaryType = std::dynamic_pointer_cast<const FixedBinary>(type)) {
-    return TypeBase::isMatch(type) && length_ == fBinaryType->length();
+const TypePtr& TypeArray::at(size_t index) const {
+  if (index >= size_) {
+    throw std::out_of_range("TypeArray index out of range");
   }
-
-  return false;
+  return data_[index];
 }
 
-std::string FixedChar::signature() const {
-  std::stringstream sign;
-  sign << TypeBase::signature();
-  sign << "<" << length() << ">";
-  return sign.str();
+Struct::~Struct() {
+  delete childVector_.load(std::memory_order_acquire);
 }
 
-bool FixedChar::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto fBinaryType = std::dynamic_pointer_cast<const FixedChar>(type)) {
-    return TypeBase::isMatch(type) && length_ == fBinaryType->length();
+const std::vector<TypePtr>& Struct::children() const {
+  const auto* children = childVector_.load(std::memory_order_acquire);
+  if (children == nullptr) {
+    auto vector = std::make_unique<const std::vector<TypePtr>>(
+        children_.begin(), children_.end());
+    if (childVector_.compare_exchange_strong(
+            children, vector.get(), std::memory_order_acq_rel)) {
+      children = vector.release();
+    }
   }
-  return false;
+  return *children;
 }
 
-std::string Varchar::signature() const {
-  std::stringstream sign;
-  sign << TypeBase::signature();
-  sign << "<" << length() << ">";
-  return sign.str();
+namespace {
+
+const TypeArray& childrenOf(const Struct& type) {
+  return type.childArray();
 }
 
-bool Varchar::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto varcharType = std::dynamic_pointer_cast<const Varchar>(type)) {
-    return TypeBase::isMatch(type) && length_ == varcharType->length();
-  }
-  return false;
+const std::vector<ParameterizedTypePtr>& childrenOf(
+    const ParameterizedStruct& type) {
+  return type.children();
 }
 
-std::string List::signature() const {
-  std::stringstream sign;
-  sign << TypeBase::signature();
-  sign << "<" << elementType_->signature() << ">";
-  return sign.str();
+constexpr bool isLengthKind(TypeKind kind) {
+  return kind == TypeKind::kVarchar || kind == TypeKind::kFixedChar ||
+      kind == TypeKind::kFixedBinary;
 }
 
-bool List::isMatch(const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto listType = std::dynamic_pointer_cast<const List>(type)) {
-    return TypeBase::isMatch(type) &&
-        elementType()->isMatch(listType->elementType());
+/// Renders the signature of a type into a buffer, a concrete type and its
+/// parameterized counterpart share the shape of their signatures.
+struct SignatureWriter {
+  fmt::memory_buffer& out;
+
+  void append(std::string_view text) const {
+    out.append(text.data(), text.data() + text.size());
   }
-  return false;
-}
 
-std::string Struct::signature() const {
-  std::stringstream sign;
-  sign << TypeBase::signature();
-  sign << "<";
-  for (auto it = children_.begin(); it != children_.end(); ++it) {
-    const auto& typeSign = (*it)->signature();
-    if (it == children_.end() - 1) {
-      sign << typeSign;
-    } else {
-      sign << typeSign << ",";
-    }
+  /// Parameters of concrete types are integers, those of parameterized types
+  /// are literals such as P1 or 10. Both render alike in signatures.
+  void appendParameter(int parameter) const {
+    const fmt::format_int formatted(parameter);
+    out.append(formatted.data(), formatted.data() + formatted.size());
   }
-  sign << ">";
-  return sign.str();
-}
-bool Struct::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto structType = std::dynamic_pointer_cast<const Struct>(type)) {
-    bool sameSize = structType->children_.size() == children_.size();
-    if (sameSize) {
-      for (int i = 0; i < children_.size(); i++) {
-        if (!children_[i]->isMatch(structType->children_[i])) {
-          return false;
+
+  void appendParameter(const StringLiteralPtr& parameter) const {
+    append(parameter->value());
+  }
+
+  void operator()(const StringLiteral& literal) const {
+    append(literal.value());
+  }
+
+  template <typename T>
+  void operator()(const T& type) const {
+    append(TypeTraits<T::kKind>::signature);
+    if constexpr (T::kKind == TypeKind::kDecimal) {
+      out.push_back('<');
+      appendParameter(type.precision());
+      out.push_back(',');
+      appendParameter(type.scale());
+      out.push_back('>');
+    } else if constexpr (isLengthKind(T::kKind)) {
+      out.push_back('<');
+      appendParameter(type.length());
+      out.push_back('>');
+    } else if constexpr (T::kKind == TypeKind::kList) {
+      out.push_back('<');
+      type.elementType()->appendSignature(out);
+      out.push_back('>');
+    } else if constexpr (T::kKind == TypeKind::kMap) {
+      out.push_back('<');
+      type.keyType()->appendSignature(out);
+      out.push_back(',');
+      type.valueType()->appendSignature(out);
+      out.push_back('>');
+    } else if constexpr (T::kKind == TypeKind::kStruct) {
+      out.push_back('<');
+      const auto& children = childrenOf(type);
+      for (size_t i = 0; i < children.size(); ++i) {
+        if (i > 0) {
+          out.push_back(',');
         }
+        children[i]->appendSignature(out);
       }
-      return true;
+      out.push_back('>');
     }
   }
-  return false;
-}
-
-std::string Map::signature() const {
-  std::stringstream sign;
-  sign << TypeBase::signature();
-  sign << "<";
-  sign << keyType()->signature();
-  sign << ",";
-  sign << valueType()->signature();
-  sign << ">";
-  return sign.str();
+};
+
+template <typename T>
+bool isSameLength(const T& pattern, const ParameterizedType& type) {
+  const auto* other = dynCast<T>(type);
+  return other && pattern.nullMatch(type) &&
+      pattern.length() == other->length();
+}
+
+bool isMatch(
+    const ParameterizedType& pattern,
+    const ParameterizedType& type,
+    TypeBindings* bindings);
+
+template <typename Children>
+bool isChildrenMatch(
+    const Children& pattern,
+    const TypeArray& types,
+    TypeBindings* bindings) {
+  if (pattern.size() != types.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    // Children of wide structs are mostly the same interned types.
+    if (static_cast<const void*>(pattern[i].get()) == types[i].get()) {
+      continue;
+    }
+    if (!isMatch(*pattern[i], *types[i], bindings)) {
+      return false;
+    }
+  }
+  return true;
 }
 
-bool Map::isMatch(const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto mapType = std::dynamic_pointer_cast<const Map>(type)) {
-    return TypeBase::isMatch(type) && keyType()->isMatch(mapType->keyType()) &&
-        valueType()->isMatch(mapType->valueType());
+/// Match a concrete type against an actual type.
+bool isConcreteMatch(const Type& pattern, const ParameterizedType& type) {
+  // Interned types are shared, so identical nested types match by pointer.
+  if (&pattern == &type) {
+    return true;
   }
-  return false;
+  return visit(
+      pattern,
+      Overloaded{
+          [&](const Decimal& decimal) {
+            const auto* other = dynCast<Decimal>(type);
+            return other && decimal.nullMatch(type) &&
+                decimal.precision() == other->precision() &&
+                decimal.scale() == other->scale();
+          },
+          [&](const Varchar& varchar) { return isSameLength(varchar, type); },
+          [&](const FixedChar& fixedChar) {
+            return isSameLength(fixedChar, type);
+          },
+          [&](const FixedBinary& fixedBinary) {
+            return isSameLength(fixedBinary, type);
+          },
+          [&](const List& list) {
+            const auto* other = dynCast<List>(type);
+            return other && list.nullMatch(type) &&
+                list.elementType()->isMatch(*other->elementType());
+          },
+          [&](const Map& map) {
+            const auto* other = dynCast<Map>(type);
+            return other && map.nullMatch(type) &&
+                map.keyType()->isMatch(*other->keyType()) &&
+                map.valueType()->isMatch(*other->valueType());
+          },
+          [&](const Struct& structType) {
+            const auto* other = dynCast<Struct>(type);
+            return other &&
+                isChildrenMatch(
+                       structType.childArray(), other->childArray(), nullptr);
+          },
+          [&](const auto& scalar) {
+            // Scalar types only need the same kind.
+            return scalar.kind() == type.kind() && scalar.nullMatch(type);
+          }});
+}
+
+/// Match an integer parameter of a parameterized type, such as P1 of
+/// decimal<P1,S1>, against the parameter of an actual type. Integer literals
+/// must be equal, placeholders are bound if bindings are given.
+bool isParameterMatch(
+    const StringLiteral& pattern,
+    int value,
+    TypeBindings* bindings) {
+  if (pattern.isWildcard()) {
+    return true;
+  }
+  if (!pattern.isPlaceholder()) {
+    const auto& literal = pattern.value();
+    int expected = 0;
+    const auto result = std::from_chars(
+        literal.data(), literal.data() + literal.size(), expected);
+    return result.ec == std::errc() && expected == value;
+  }
+  return bindings == nullptr || bindings->bindValue(pattern.value(), value);
 }
 
-std::string ParameterizedFixedBinary::signature() const {
-  std::stringstream sign;
-  sign << TypeTraits<TypeKind::kFixedBinary>::signature;
-  sign << "<" << length_->value() << ">";
-  return sign.str();
+/// Test whether a wildcard names a placeholder which binds, e.g. any1. A
+/// plain any matches each type independently.
+bool isBindingWildcard(const StringLiteral& wildcard) {
+  auto name = std::string_view(wildcard.value());
+  if (!name.empty() && name.back() == '?') {
+    name.remove_suffix(1);
+  }
+  return name.size() > 3;
+}
+
+/// Match the length parameter of a parameterized varchar, fixedchar or
+/// fixedbinary against an actual type of class T.
+template <typename T, typename Pattern>
+bool isLengthMatch(
+    const Pattern& pattern,
+    const ParameterizedType& type,
+    TypeBindings* bindings) {
+  const auto* other = dynCast<T>(type);
+  return other && pattern.nullMatch(type) &&
+      isParameterMatch(*pattern.length(), other->length(), bindings);
+}
+
+/// Match a parameterized type from a function declaration against an actual
+/// type.
+bool isParameterizedMatch(
+    const ParameterizedType& pattern,
+    const ParameterizedType& type,
+    TypeBindings* bindings) {
+  return visit(
+      pattern,
+      Overloaded{
+          [&](const StringLiteral& literal) {
+            if (literal.isWildcard()) {
+              return bindings == nullptr || !isBindingWildcard(literal) ||
+                  bindings->bindType(literal.value(), type);
+            }
+            const auto* other = dynCast<StringLiteral>(type);
+            return other && literal.value() == other->value();
+          },
+          [&](const ParameterizedDecimal& decimal) {
+            const auto* other = dynCast<Decimal>(type);
+            return other && decimal.nullMatch(type) &&
+                isParameterMatch(
+                       *decimal.precision(), other->precision(), bindings) &&
+                isParameterMatch(*decimal.scale(), other->scale(), bindings);
+          },
+          [&](const ParameterizedVarchar& varchar) {
+            return isLengthMatch<Varchar>(varchar, type, bindings);
+          },
+          [&](const ParameterizedFixedChar& fixedChar) {
+            return isLengthMatch<FixedChar>(fixedChar, type, bindings);
+          },
+          [&](const ParameterizedFixedBinary& fixedBinary) {
+            return isLengthMatch<FixedBinary>(fixedBinary, type, bindings);
+          },
+          [&](const ParameterizedList& list) {
+            const auto* other = dynCast<List>(type);
+            return other &&
+                isMatch(*list.elementType(), *other->elementType(), bindings) &&
+                list.nullMatch(type);
+          },
+          [&](const ParameterizedMap& map) {
+            const auto* other = dynCast<Map>(type);
+            return other &&
+                isMatch(*map.keyType(), *other->keyType(), bindings) &&
+                isMatch(*map.valueType(), *other->valueType(), bindings) &&
+                map.nullMatch(type);
+          },
+          [&](const ParameterizedStruct& structType) {
+            const auto* other = dynCast<Struct>(type);
+            return other &&
+                isChildrenMatch(
+                       structType.children(), other->childArray(), bindings) &&
+                structType.nullMatch(type);
+          },
+          [](const Type&) {
+            SUBSTRAIT_UNREACHABLE("Concrete type matched as parameterized");
+            return false;
+          }});
+}
+
+bool isMatch(
+    const ParameterizedType& pattern,
+    const ParameterizedType& type,
+    TypeBindings* bindings) {
+  if (pattern.isParameterized()) {
+    return isParameterizedMatch(pattern, type, bindings);
+  }
+  return isConcreteMatch(cast<Type>(pattern), type);
 }
 
-bool ParameterizedFixedBinary::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto parameterizedFixedBinary =
-          std::dynamic_pointer_cast<const ParameterizedFixedBinary>(type)) {
-    return length()->isMatch(parameterizedFixedBinary->length()) &&
-        nullMatch(type);
-  }
+} // namespace
 
-  return false;
+bool ParameterizedType::isMatch(const ParameterizedType& type) const {
+  return io::substrait::isMatch(*this, type, nullptr);
 }
 
-std::string ParameterizedDecimal::signature() const {
-  std::stringstream sign;
-  sign << TypeTraits<TypeKind::kDecimal>::signature;
-  sign << "<" << precision_->value() << "," << scale_->value() << ">";
-  return sign.str();
+bool ParameterizedType::isMatch(
+    const ParameterizedType& type,
+    TypeBindings& bindings) const {
+  return io::substrait::isMatch(*this, type, &bindings);
 }
 
-bool ParameterizedDecimal::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto decimal = std::dynamic_pointer_cast<const Decimal>(type)) {
-    return nullMatch(type);
-  }
-
-  return false;
+TypePtr Type::withNullable(bool nullable) const {
+  return TypeFactory::instance().withNullable(*this, nullable);
 }
 
-std::string ParameterizedFixedChar::signature() const {
-  std::stringstream sign;
-  sign << TypeTraits<TypeKind::kFixedChar>::signature;
-  sign << "<" << length_->value() << ">";
-  return sign.str();
+ParameterizedType::~ParameterizedType() {
+  delete signature_.load(std::memory_order_relaxed);
 }
-bool ParameterizedFixedChar::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto fixedChar = std::dynamic_pointer_cast<const FixedChar>(type)) {
-    return nullMatch(type);
-  }
 
-  return false;
+std::string ParameterizedType::makeSignature() const {
+  fmt::memory_buffer out;
+  visit(*this, SignatureWriter{out});
+  return fmt::to_string(out);
 }
 
-std::string ParameterizedVarchar::signature() const {
-  std::stringstream sign;
-  sign << TypeTraits<TypeKind::kVarchar>::signature;
-  sign << "<" << length_->value() << ">";
-  return sign.str();
+void ParameterizedType::appendSignature(fmt::memory_buffer& out) const {
+  if (const auto* signature = signature_.load(std::memory_order_acquire)) {
+    out.append(signature->data(), signature->data() + signature->size());
+  } else {
+    visit(*this, SignatureWriter{out});
+  }
 }
 
-bool ParameterizedVarchar::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto varchar = std::dynamic_pointer_cast<const Varchar>(type)) {
-    return nullMatch(type);
+const std::string& ParameterizedType::signature() const {
+  const auto* signature = signature_.load(std::memory_order_acquire);
+  if (signature == nullptr) {
+    // Concurrent first calls may both build the signature, only one of them
+    // is published.
+    auto built = std::make_unique<const std::string>(makeSignature());
+    if (signature_.compare_exchange_strong(
+            signature, built.get(), std::memory_order_acq_rel)) {
+      signature = built.release();
+    }
   }
-
-  return false;
+  return *signature;
 }
 
-std::string ParameterizedList::signature() const {
-  std::stringstream sign;
-  sign << TypeTraits<TypeKind::kList>::signature;
-  sign << "<" << elementType()->signature() << ">";
-  return sign.str();
+uint64_t ParameterizedType::hash() const {
+  auto hash = hash_.load(std::memory_order_relaxed);
+  if (hash == 0) {
+    // Racing threads compute the same value, 0 is reserved for "not yet".
+    hash = std::max<uint64_t>(makeHash(), 1);
+    hash_.store(hash, std::memory_order_relaxed);
+  }
+  return hash;
 }
 
-bool ParameterizedList::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto list = std::dynamic_pointer_cast<const List>(type)) {
-    return elementType()->isMatch(list->elementType()) && nullMatch(type);
-  }
+namespace {
 
-  return false;
+template <typename Children>
+uint64_t hashChildren(uint64_t seed, const Children& children) {
+  for (const auto& child : children) {
+    seed = common::HashUtils::hashCombine(seed, child->hash());
+  }
+  return seed;
 }
 
-std::string ParameterizedStruct::signature() const {
-  std::stringstream sign;
-  sign << TypeTraits<TypeKind::kStruct>::signature;
-  sign << "<";
-  for (auto it = children_.begin(); it != children_.end(); ++it) {
-    const auto& typeSign = (*it)->signature();
-    if (it == children_.end() - 1) {
-      sign << typeSign;
-    } else {
-      sign << typeSign << ",";
+template <typename Children>
+bool isChildrenEqual(const Children& lhs, const Children& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (!lhs[i]->isEqual(*rhs[i])) {
+      return false;
     }
   }
-  sign << ">";
-  return sign.str();
+  return true;
 }
 
-bool ParameterizedStruct::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto structType = std::dynamic_pointer_cast<const Struct>(type)) {
-    bool sameSize = structType->children().size() == children_.size();
-    if (sameSize) {
-      for (int i = 0; i < children_.size(); i++) {
-        if (!children_[i]->isMatch(structType->children()[i])) {
-          return false;
-        }
+} // namespace
+
+uint64_t ParameterizedType::makeHash() const {
+  using common::HashUtils;
+  uint64_t hash = HashUtils::hashCombine(
+      static_cast<uint64_t>(kind_),
+      (static_cast<uint64_t>(parameterized_) << 1) | nullable_);
+  if (parameterized_) {
+    switch (kind_) {
+      case TypeKind::KIND_NOT_SET:
+        return HashUtils::hashCombine(
+            hash, std::hash<std::string>{}(cast<StringLiteral>(*this).value()));
+      case TypeKind::kDecimal: {
+        const auto& decimal = cast<ParameterizedDecimal>(*this);
+        hash = HashUtils::hashCombine(hash, decimal.precision()->hash());
+        return HashUtils::hashCombine(hash, decimal.scale()->hash());
+      }
+      case TypeKind::kVarchar:
+        return HashUtils::hashCombine(
+            hash, cast<ParameterizedVarchar>(*this).length()->hash());
+      case TypeKind::kFixedChar:
+        return HashUtils::hashCombine(
+            hash, cast<ParameterizedFixedChar>(*this).length()->hash());
+      case TypeKind::kFixedBinary:
+        return HashUtils::hashCombine(
+            hash, cast<ParameterizedFixedBinary>(*this).length()->hash());
+      case TypeKind::kList:
+        return HashUtils::hashCombine(
+            hash, cast<ParameterizedList>(*this).elementType()->hash());
+      case TypeKind::kMap: {
+        const auto& map = cast<ParameterizedMap>(*this);
+        hash = HashUtils::hashCombine(hash, map.keyType()->hash());
+        return HashUtils::hashCombine(hash, map.valueType()->hash());
       }
-      return nullMatch(type);
+      case TypeKind::kStruct:
+        return hashChildren(hash, cast<ParameterizedStruct>(*this).children());
+      default:
+        return hash;
     }
   }
-  return false;
+
+  switch (kind_) {
+    case TypeKind::kDecimal: {
+      const auto& decimal = cast<Decimal>(*this);
+      hash = HashUtils::hashCombine(hash, decimal.precision());
+      return HashUtils::hashCombine(hash, decimal.scale());
+    }
+    case TypeKind::kVarchar:
+      return HashUtils::hashCombine(hash, cast<Varchar>(*this).length());
+    case TypeKind::kFixedChar:
+      return HashUtils::hashCombine(hash, cast<FixedChar>(*this).length());
+    case TypeKind::kFixedBinary:
+      return HashUtils::hashCombine(hash, cast<FixedBinary>(*this).length());
+    case TypeKind::kList:
+      return HashUtils::hashCombine(
+          hash, cast<List>(*this).elementType()->hash());
+    case TypeKind::kMap: {
+      const auto& map = cast<Map>(*this);
+      hash = HashUtils::hashCombine(hash, map.keyType()->hash());
+      return HashUtils::hashCombine(hash, map.valueType()->hash());
+    }
+    case TypeKind::kStruct:
+      return hashChildren(hash, cast<Struct>(*this).childArray());
+    default:
+      return hash;
+  }
 }
 
-std::string ParameterizedMap::signature() const {
-  std::stringstream sign;
-  sign << TypeTraits<TypeKind::kMap>::signature;
-  sign << "<";
-  sign << keyType()->signature();
-  sign << ",";
-  sign << valueType()->signature();
-  sign << ">";
-  return sign.str();
+bool ParameterizedType::isEqual(const ParameterizedType& other) const {
+  if (this == &other) {
+    return true;
+  }
+  if (nullable_ != other.nullable_ || hash() != other.hash()) {
+    return false;
+  }
+  return isEqualIgnoringNullability(other);
 }
 
-bool ParameterizedMap::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (auto mapType = std::dynamic_pointer_cast<const Map>(type)) {
-    return keyType()->isMatch(mapType->keyType()) &&
-        valueType()->isMatch(mapType->valueType()) && nullMatch(type);
+bool ParameterizedType::isEqualIgnoringNullability(
+    const ParameterizedType& other) const {
+  if (this == &other) {
+    return true;
+  }
+  if (kind_ != other.kind_ || parameterized_ != other.parameterized_) {
+    return false;
+  }
+  if (parameterized_) {
+    switch (kind_) {
+      case TypeKind::KIND_NOT_SET:
+        return cast<StringLiteral>(*this).value() ==
+            cast<StringLiteral>(other).value();
+      case TypeKind::kDecimal: {
+        const auto& lhs = cast<ParameterizedDecimal>(*this);
+        const auto& rhs = cast<ParameterizedDecimal>(other);
+        return lhs.precision()->isEqual(*rhs.precision()) &&
+            lhs.scale()->isEqual(*rhs.scale());
+      }
+      case TypeKind::kVarchar:
+        return cast<ParameterizedVarchar>(*this).length()->isEqual(
+            *cast<ParameterizedVarchar>(other).length());
+      case TypeKind::kFixedChar:
+        return cast<ParameterizedFixedChar>(*this).length()->isEqual(
+            *cast<ParameterizedFixedChar>(other).length());
+      case TypeKind::kFixedBinary:
+        return cast<ParameterizedFixedBinary>(*this).length()->isEqual(
+            *cast<ParameterizedFixedBinary>(other).length());
+      case TypeKind::kList:
+        return cast<ParameterizedList>(*this).elementType()->isEqual(
+            *cast<ParameterizedList>(other).elementType());
+      case TypeKind::kMap: {
+        const auto& lhs = cast<ParameterizedMap>(*this);
+        const auto& rhs = cast<ParameterizedMap>(other);
+        return lhs.keyType()->isEqual(*rhs.keyType()) &&
+            lhs.valueType()->isEqual(*rhs.valueType());
+      }
+      case TypeKind::kStruct:
+        return isChildrenEqual(
+            cast<ParameterizedStruct>(*this).children(),
+            cast<ParameterizedStruct>(other).children());
+      default:
+        return false;
+    }
+  }
+
+  switch (kind_) {
+    case TypeKind::kDecimal: {
+      const auto& lhs = cast<Decimal>(*this);
+      const auto& rhs = cast<Decimal>(other);
+      return lhs.precision() == rhs.precision() && lhs.scale() == rhs.scale();
+    }
+    case TypeKind::kVarchar:
+      return cast<Varchar>(*this).length() == cast<Varchar>(other).length();
+    case TypeKind::kFixedChar:
+      return cast<FixedChar>(*this).length() == cast<FixedChar>(other).length();
+    case TypeKind::kFixedBinary:
+      return cast<FixedBinary>(*this).length() ==
+          cast<FixedBinary>(other).length();
+    case TypeKind::kList:
+      return cast<List>(*this).elementType()->isEqual(
+          *cast<List>(other).elementType());
+    case TypeKind::kMap: {
+      const auto& lhs = cast<Map>(*this);
+      const auto& rhs = cast<Map>(other);
+      return lhs.keyType()->isEqual(*rhs.keyType()) &&
+          lhs.valueType()->isEqual(*rhs.valueType());
+    }
+    case TypeKind::kStruct:
+      return isChildrenEqual(
+          cast<Struct>(*this).childArray(), cast<Struct>(other).childArray());
+    default:
+      // Scalar types are equal if kind and nullability are.
+      return true;
   }
-  return false;
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kBool>> BOOL() {
-  return std::make_shared<const ScalarType<TypeKind::kBool>>(false);
+  return TypeFactory::scalar<TypeKind::kBool>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kI8>> TINYINT() {
-  return std::make_shared<const ScalarType<TypeKind::kI8>>(false);
+  return TypeFactory::scalar<TypeKind::kI8>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kI16>> SMALLINT() {
-  return std::make_shared<const ScalarType<TypeKind::kI16>>(false);
+  return TypeFactory::scalar<TypeKind::kI16>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kI32>> INTEGER() {
-  return std::make_shared<const ScalarType<TypeKind::kI32>>(false);
+  return TypeFactory::scalar<TypeKind::kI32>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kI64>> BIGINT() {
-  return std::make_shared<const ScalarType<TypeKind::kI64>>(false);
+  return TypeFactory::scalar<TypeKind::kI64>();
 }
+
 std::shared_ptr<const ScalarType<TypeKind::kFp32>> FLOAT() {
-  return std::make_shared<const ScalarType<TypeKind::kFp32>>(false);
+  return TypeFactory::scalar<TypeKind::kFp32>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kFp64>> DOUBLE() {
-  return std::make_shared<const ScalarType<TypeKind::kFp64>>(false);
+  return TypeFactory::scalar<TypeKind::kFp64>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kString>> STRING() {
-  return std::make_shared<const ScalarType<TypeKind::kString>>(false);
+  return TypeFactory::scalar<TypeKind::kString>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kBinary>> BINARY() {
-  return std::make_shared<const ScalarType<TypeKind::kBinary>>(false);
+  return TypeFactory::scalar<TypeKind::kBinary>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kTimestamp>> TIMESTAMP() {
-  return std::make_shared<const ScalarType<TypeKind::kTimestamp>>(false);
+  return TypeFactory::scalar<TypeKind::kTimestamp>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kDate>> DATE() {
-  return std::make_shared<const ScalarType<TypeKind::kDate>>(false);
+  return TypeFactory::scalar<TypeKind::kDate>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kTime>> TIME() {
-  return std::make_shared<const ScalarType<TypeKind::kTime>>(false);
+  return TypeFactory::scalar<TypeKind::kTime>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kIntervalYear>> INTERVAL_YEAR() {
-  return std::make_shared<const ScalarType<TypeKind::kIntervalYear>>(false);
+  return TypeFactory::scalar<TypeKind::kIntervalYear>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kIntervalDay>> INTERVAL_DAY() {
-  return std::make_shared<const ScalarType<TypeKind::kIntervalDay>>(false);
+  return TypeFactory::scalar<TypeKind::kIntervalDay>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kTimestampTz>> TIMESTAMP_TZ() {
-  return std::make_shared<const ScalarType<TypeKind::kTimestampTz>>(false);
+  return TypeFactory::scalar<TypeKind::kTimestampTz>();
 }
 
 std::shared_ptr<const ScalarType<TypeKind::kUuid>> UUID() {
-  return std::make_shared<const ScalarType<TypeKind::kUuid>>(false);
+  return TypeFactory::scalar<TypeKind::kUuid>();
 }
 
 std::shared_ptr<const Decimal> DECIMAL(int precision, int scale) {
-  return std::make_shared<const Decimal>(precision, scale, false);
+  return TypeFactory::instance().decimal(precision, scale);
 }
 
 std::shared_ptr<const Varchar> VARCHAR(int len) {
-  return std::make_shared<const Varchar>(len, false);
+  return TypeFactory::instance().varchar(len);
 }
-std::shared_ptr<const FixedChar> FCHAR(int len) {
-  return std::make_shared<const FixedChar>(len, false);
+
+std::shared_ptr<const FixedChar> FIXED_CHAR(int len) {
+  return TypeFactory::instance().fixedChar(len);
 }
 
 std::shared_ptr<const FixedBinary> FIXED_BINARY(int len) {
-  return std::make_shared<const FixedBinary>(len, false);
+  return TypeFactory::instance().fixedBinary(len);
 }
 
 std::shared_ptr<const List> LIST(const TypePtr& elementType) {
-  return std::make_shared<const List>(elementType, false);
+  return TypeFactory::instance().list(elementType);
 }
 
 std::shared_ptr<const Map> MAP(
     const TypePtr& keyType,
     const TypePtr& valueType) {
-  return std::make_shared<const Map>(keyType, valueType, false);
+  return TypeFactory::instance().map(keyType, valueType);
 }
 
 std::shared_ptr<const Struct> STRUCT(const std::vector<TypePtr>& children) {
-  return std::make_shared<const Struct>(children, false);
+  return TypeFactory::instance().structType(children);
 }
 
-std::shared_ptr<const FixedChar> FIXED_CHAR(int len) {
-  return std::make_shared<const FixedChar>(len);
-}
-
-bool StringLiteral::isMatch(
-    const std::shared_ptr<const ParameterizedType>& type) const {
-  if (isWildcard()) {
-    return true;
-  } else {
-    if (auto stringLiteral =
-            std::dynamic_pointer_cast<const StringLiteral>(type)) {
-      return value_ == stringLiteral->value_;
-    }
-    return false;
-  }
-}
 bool StringLiteral::isInteger() const {
   return common::NumberUtils::isInteger(value_);
 }
@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeBindings.h"
+
+#include <algorithm>
+
+namespace io::substrait {
+
+namespace {
+
+std::string_view normalizeName(std::string_view name) {
+  if (!name.empty() && name.back() == '?') {
+    name.remove_suffix(1);
+  }
+  return name;
+}
+
+} // namespace
+
+const TypeBindings::Binding* TypeBindings::find(std::string_view name) const {
+  const auto numInline = std::min(size_, kInlineCapacity);
+  for (size_t i = 0; i < numInline; ++i) {
+    if (inline_[i].name == name) {
+      return &inline_[i];
+    }
+  }
+  for (const auto& binding : overflow_) {
+    if (binding.name == name) {
+      return &binding;
+    }
+  }
+  return nullptr;
+}
+
+void TypeBindings::add(const Binding& binding) {
+  if (size_ < kInlineCapacity) {
+    inline_[size_] = binding;
+  } else {
+    overflow_.emplace_back(binding);
+  }
+  ++size_;
+}
+
+bool TypeBindings::bindType(
+    std::string_view name,
+    const ParameterizedType& type) {
+  name = normalizeName(name);
+  if (const auto* binding = find(name)) {
+    return binding->type != nullptr &&
+        binding->type->isEqualIgnoringNullability(type);
+  }
+  add({name, &type, 0});
+  return true;
+}
+
+bool TypeBindings::bindValue(std::string_view name, int64_t value) {
+  name = normalizeName(name);
+  if (const auto* binding = find(name)) {
+    return binding->type == nullptr && binding->value == value;
+  }
+  add({name, nullptr, value});
+  return true;
+}
+
+const ParameterizedType* TypeBindings::findType(std::string_view name) const {
+  const auto* binding = find(normalizeName(name));
+  return binding != nullptr ? binding->type : nullptr;
+}
+
+std::optional<int64_t> TypeBindings::findValue(std::string_view name) const {
+  const auto* binding = find(normalizeName(name));
+  if (binding == nullptr || binding->type != nullptr) {
+    return std::nullopt;
+  }
+  return binding->value;
+}
+
+} // namespace io::substrait
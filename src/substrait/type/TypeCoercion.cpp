@@ -0,0 +1,246 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeCoercion.h"
+
+#include <algorithm>
+
+#include "substrait/type/TypeFactory.h"
+
+namespace io::substrait {
+
+namespace {
+
+/// Largest precision of a decimal.
+constexpr int kMaxDecimalPrecision = 38;
+
+/// Decimal digits needed by all values of an integer kind, 0 for other
+/// kinds.
+int integerDigits(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::kI8:
+      return 3;
+    case TypeKind::kI16:
+      return 5;
+    case TypeKind::kI32:
+      return 10;
+    case TypeKind::kI64:
+      return 19;
+    default:
+      return 0;
+  }
+}
+
+/// Cast a type to the narrowest type of a kind it casts to, nullptr if there
+/// is no implicit cast to the kind.
+TypePtr widenTo(const Type& type, TypeKind kind) {
+  auto& factory = TypeFactory::instance();
+  if (type.kind() == kind) {
+    return factory.intern(type);
+  }
+  if (implicitCastCost(type.kind(), kind) == kNoImplicitCast) {
+    return nullptr;
+  }
+  const auto nullable = type.nullable();
+  switch (kind) {
+    case TypeKind::kDecimal:
+      // Only integers cast to decimals.
+      return factory.decimal(integerDigits(type.kind()), 0, nullable);
+    case TypeKind::kVarchar:
+      // Only fixedchars cast to varchars.
+      return factory.varchar(cast<FixedChar>(type).length(), nullable);
+    default:
+      return TypeFactory::scalarType(kind, nullable);
+  }
+}
+
+int lengthOf(const Type& type) {
+  switch (type.kind()) {
+    case TypeKind::kVarchar:
+      return cast<Varchar>(type).length();
+    case TypeKind::kFixedChar:
+      return cast<FixedChar>(type).length();
+    case TypeKind::kFixedBinary:
+      return cast<FixedBinary>(type).length();
+    default:
+      return 0;
+  }
+}
+
+/// Join two types of the same kind, nullptr if there is no type of that
+/// kind both cast to.
+TypePtr joinSameKind(const Type& left, const Type& right) {
+  auto& factory = TypeFactory::instance();
+  const auto nullable = left.nullable() || right.nullable();
+  switch (left.kind()) {
+    case TypeKind::kDecimal: {
+      const auto& leftDecimal = cast<Decimal>(left);
+      const auto& rightDecimal = cast<Decimal>(right);
+      const auto scale = std::max(leftDecimal.scale(), rightDecimal.scale());
+      const auto integral = std::max(
+          leftDecimal.precision() - leftDecimal.scale(),
+          rightDecimal.precision() - rightDecimal.scale());
+      if (scale + integral > kMaxDecimalPrecision) {
+        return nullptr;
+      }
+      return factory.decimal(scale + integral, scale, nullable);
+    }
+    case TypeKind::kVarchar:
+      return factory.varchar(
+          std::max(lengthOf(left), lengthOf(right)), nullable);
+    case TypeKind::kFixedChar:
+      if (lengthOf(left) != lengthOf(right)) {
+        return nullptr;
+      }
+      return factory.fixedChar(lengthOf(left), nullable);
+    case TypeKind::kFixedBinary:
+      if (lengthOf(left) != lengthOf(right)) {
+        return nullptr;
+      }
+      return factory.fixedBinary(lengthOf(left), nullable);
+    case TypeKind::kList: {
+      const auto element = TypeCoercion::commonSupertype(
+          *cast<List>(left).elementType(), *cast<List>(right).elementType());
+      return element ? factory.list(element, nullable) : nullptr;
+    }
+    case TypeKind::kMap: {
+      const auto& leftMap = cast<Map>(left);
+      const auto& rightMap = cast<Map>(right);
+      const auto key = TypeCoercion::commonSupertype(
+          *leftMap.keyType(), *rightMap.keyType());
+      const auto value = TypeCoercion::commonSupertype(
+          *leftMap.valueType(), *rightMap.valueType());
+      return key && value ? factory.map(key, value, nullable) : nullptr;
+    }
+    case TypeKind::kStruct: {
+      const auto& leftChildren = cast<Struct>(left).childArray();
+      const auto& rightChildren = cast<Struct>(right).childArray();
+      if (leftChildren.size() != rightChildren.size()) {
+        return nullptr;
+      }
+      std::vector<TypePtr> children;
+      children.reserve(leftChildren.size());
+      for (size_t i = 0; i < leftChildren.size(); ++i) {
+        auto child =
+            TypeCoercion::commonSupertype(*leftChildren[i], *rightChildren[i]);
+        if (!child) {
+          return nullptr;
+        }
+        children.emplace_back(std::move(child));
+      }
+      return factory.structType(children, nullable);
+    }
+    default:
+      return TypeFactory::scalarType(left.kind(), nullable);
+  }
+}
+
+} // namespace
+
+std::optional<int> TypeCoercion::cost(const Type& from, const Type& to) {
+  if (from.nullable() && !to.nullable()) {
+    return std::nullopt;
+  }
+  const int kindCost = implicitCastCost(from.kind(), to.kind());
+  if (kindCost == kNoImplicitCast) {
+    return std::nullopt;
+  }
+  switch (to.kind()) {
+    case TypeKind::kDecimal: {
+      const auto& target = cast<Decimal>(to);
+      int precision = integerDigits(from.kind());
+      int scale = 0;
+      if (from.kind() == TypeKind::kDecimal) {
+        precision = cast<Decimal>(from).precision();
+        scale = cast<Decimal>(from).scale();
+      }
+      if (target.scale() < scale ||
+          target.precision() - target.scale() < precision - scale) {
+        return std::nullopt;
+      }
+      const bool widened =
+          target.precision() != precision || target.scale() != scale;
+      return kindCost + (widened ? 1 : 0);
+    }
+    case TypeKind::kVarchar:
+    case TypeKind::kFixedChar:
+    case TypeKind::kFixedBinary: {
+      const auto length = lengthOf(from);
+      const auto targetLength = lengthOf(to);
+      // Only varchars grow, the others keep their length.
+      if (targetLength < length ||
+          (targetLength != length && to.kind() != TypeKind::kVarchar)) {
+        return std::nullopt;
+      }
+      return kindCost + (targetLength != length ? 1 : 0);
+    }
+    case TypeKind::kList:
+      return cost(
+          *cast<List>(from).elementType(), *cast<List>(to).elementType());
+    case TypeKind::kMap: {
+      const auto& fromMap = cast<Map>(from);
+      const auto& toMap = cast<Map>(to);
+      const auto keyCost = cost(*fromMap.keyType(), *toMap.keyType());
+      const auto valueCost = cost(*fromMap.valueType(), *toMap.valueType());
+      if (!keyCost.has_value() || !valueCost.has_value()) {
+        return std::nullopt;
+      }
+      return *keyCost + *valueCost;
+    }
+    case TypeKind::kStruct: {
+      const auto& fromChildren = cast<Struct>(from).childArray();
+      const auto& toChildren = cast<Struct>(to).childArray();
+      if (fromChildren.size() != toChildren.size()) {
+        return std::nullopt;
+      }
+      int total = 0;
+      for (size_t i = 0; i < fromChildren.size(); ++i) {
+        const auto childCost = cost(*fromChildren[i], *toChildren[i]);
+        if (!childCost.has_value()) {
+          return std::nullopt;
+        }
+        total += *childCost;
+      }
+      return total;
+    }
+    default:
+      return kindCost;
+  }
+}
+
+TypePtr TypeCoercion::commonSupertype(const Type& left, const Type& right) {
+  TypePtr best;
+  int bestCost = 0;
+  for (size_t kind = 0; kind < kNumTypeKinds; ++kind) {
+    const int leftCost = implicitCastCost(left.kind(), TypeKind(kind));
+    const int rightCost = implicitCastCost(right.kind(), TypeKind(kind));
+    if (leftCost == kNoImplicitCast || rightCost == kNoImplicitCast ||
+        (best && leftCost + rightCost >= bestCost)) {
+      continue;
+    }
+    const auto joined = joinSameKind(
+        *widenTo(left, TypeKind(kind)), *widenTo(right, TypeKind(kind)));
+    if (joined) {
+      best = joined;
+      bestCost = leftCost + rightCost;
+    }
+  }
+  return best;
+}
+
+std::vector<std::pair<TypePtr, int>> TypeCoercion::supertypes(
+    const Type& type) {
+  std::vector<std::pair<TypePtr, int>> supertypes;
+  for (size_t kind = 0; kind < kNumTypeKinds; ++kind) {
+    const int kindCost = implicitCastCost(type.kind(), TypeKind(kind));
+    if (kindCost != kNoImplicitCast) {
+      supertypes.emplace_back(widenTo(type, TypeKind(kind)), kindCost);
+    }
+  }
+  std::stable_sort(
+      supertypes.begin(), supertypes.end(), [](const auto& a, const auto& b) {
+        return a.second < b.second;
+      });
+  return supertypes;
+}
+
+} // namespace io::substrait
@@ -0,0 +1,114 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeDecodeCache.h"
+
+#include <algorithm>
+
+namespace io::substrait {
+
+namespace {
+
+size_t maxSizePerShard(size_t maxSize, size_t numShards) {
+  if (maxSize == 0) {
+    return 0;
+  }
+  return std::max<size_t>(1, maxSize / numShards);
+}
+
+} // namespace
+
+TypeDecodeCache::TypeDecodeCache(size_t maxSize, size_t numShards)
+    : maxSizePerShard_(
+          maxSizePerShard(maxSize, std::max<size_t>(1, numShards))),
+      shards_(std::max<size_t>(1, numShards)) {
+  if (maxSizePerShard_ > 0) {
+    // An insert may exceed the size by one before evicting.
+    for (auto& shard : shards_) {
+      shard.entries[0].reserve(maxSizePerShard_ + 1);
+      shard.entries[1].reserve(maxSizePerShard_ + 1);
+    }
+  }
+}
+
+TypeDecodeCache::Shard& TypeDecodeCache::shardFor(const std::string& rawType) {
+  return shards_[std::hash<std::string>{}(rawType) % shards_.size()];
+}
+
+ParameterizedTypePtr TypeDecodeCache::decode(
+    const std::string& rawType,
+    bool isParameterized) {
+  auto& shard = shardFor(rawType);
+  auto& entries = shard.entries[isParameterized];
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = entries.find(rawType);
+    if (it != entries.end()) {
+      ++shard.hits;
+      if (maxSizePerShard_ > 0) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruPos);
+      }
+      return it->second.type;
+    }
+    ++shard.misses;
+  }
+
+  // Decode outside of the lock, a concurrent miss on the same string decodes
+  // it twice and the first inserted result wins.
+  auto type = ParameterizedType::decode(rawType, isParameterized);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto [it, inserted] = entries.try_emplace(rawType, Entry{type, {}});
+  if (!inserted) {
+    return it->second.type;
+  }
+  if (maxSizePerShard_ > 0) {
+    shard.lru.push_front(LruEntry{isParameterized, it});
+    it->second.lruPos = shard.lru.begin();
+    if (shard.lru.size() > maxSizePerShard_) {
+      const auto evicted = shard.lru.back();
+      shard.lru.pop_back();
+      shard.entries[evicted.isParameterized].erase(evicted.entry);
+    }
+  }
+  return type;
+}
+
+uint64_t TypeDecodeCache::hits() const {
+  uint64_t hits = 0;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    hits += shard.hits;
+  }
+  return hits;
+}
+
+uint64_t TypeDecodeCache::misses() const {
+  uint64_t misses = 0;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    misses += shard.misses;
+  }
+  return misses;
+}
+
+size_t TypeDecodeCache::size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.entries[0].size() + shard.entries[1].size();
+  }
+  return size;
+}
+
+void TypeDecodeCache::clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries[0].clear();
+    shard.entries[1].clear();
+    shard.lru.clear();
+    shard.hits = 0;
+    shard.misses = 0;
+  }
+}
+
+} // namespace io::substrait
@@ -0,0 +1,619 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeDerivation.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/common/StringUtils.h"
+#include "substrait/type/TypeFactory.h"
+
+namespace io::substrait {
+
+/// Recursive descent compiler of type derivation programs, see
+/// TypeDerivation. Lines are compiled one by one, the operator precedence
+/// from low to high is: ternary, ||, &&, comparison, + -, * /, unary.
+class TypeDerivationCompiler {
+ public:
+  explicit TypeDerivationCompiler(std::string_view expression)
+      : expression_(expression),
+        derivation_(std::shared_ptr<TypeDerivation>(new TypeDerivation())) {}
+
+  std::shared_ptr<const TypeDerivation> compile() {
+    std::vector<std::string_view> lines;
+    size_t start = 0;
+    while (start <= expression_.size()) {
+      auto end = expression_.find('\n', start);
+      if (end == std::string_view::npos) {
+        end = expression_.size();
+      }
+      auto line = expression_.substr(start, end - start);
+      if (!isBlank(line)) {
+        lines.emplace_back(line);
+      }
+      start = end + 1;
+    }
+    if (lines.empty()) {
+      fail("expected a type");
+    }
+
+    for (size_t i = 0; i + 1 < lines.size(); ++i) {
+      begin(lines[i]);
+      compileAssignment();
+    }
+    begin(lines.back());
+    compileResultType();
+    derivation_->numSlots_ = slotNames_.size();
+    derivation_->expression_ = std::string(expression_);
+    return derivation_;
+  }
+
+ private:
+  using OpCode = TypeDerivation::OpCode;
+
+  static bool isBlank(std::string_view line) {
+    return std::all_of(line.begin(), line.end(), [](char c) {
+      return std::isspace(static_cast<unsigned char>(c));
+    });
+  }
+
+  static bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+  }
+
+  template <typename... Args>
+  [[noreturn]] void fail(const char* reason, const Args&... args) const {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Fail to compile type derivation '{}' at position {} of line '{}': {}",
+        expression_,
+        pos_,
+        line_,
+        common::errorMessage(reason, args...));
+  }
+
+  void begin(std::string_view line) {
+    line_ = line;
+    pos_ = 0;
+  }
+
+  void skipWhitespace() {
+    while (pos_ < line_.size() &&
+           std::isspace(static_cast<unsigned char>(line_[pos_]))) {
+      ++pos_;
+    }
+  }
+
+  bool atEnd() {
+    skipWhitespace();
+    return pos_ == line_.size();
+  }
+
+  bool peek(char c) {
+    skipWhitespace();
+    return pos_ < line_.size() && line_[pos_] == c;
+  }
+
+  bool peek(std::string_view token) {
+    skipWhitespace();
+    return line_.substr(pos_, token.size()) == token;
+  }
+
+  bool consume(char c) {
+    if (peek(c)) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  bool consume(std::string_view token) {
+    if (peek(token)) {
+      pos_ += token.size();
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) {
+      fail("expected '{}'", c);
+    }
+  }
+
+  /// Consume a keyword operator such as AND, which must not be followed by
+  /// further identifier characters.
+  bool consumeKeyword(std::string_view keyword) {
+    skipWhitespace();
+    auto candidate = line_.substr(pos_, keyword.size());
+    const auto end = pos_ + keyword.size();
+    if (candidate.size() == keyword.size() &&
+        common::StringUtils::equalsIgnoreCase(candidate, keyword) &&
+        (end == line_.size() || !isIdentifierChar(line_[end]))) {
+      pos_ = end;
+      return true;
+    }
+    return false;
+  }
+
+  std::string_view parseIdentifier() {
+    skipWhitespace();
+    const auto start = pos_;
+    while (pos_ < line_.size() && isIdentifierChar(line_[pos_])) {
+      ++pos_;
+    }
+    if (start == pos_) {
+      fail("expected an identifier");
+    }
+    return line_.substr(start, pos_ - start);
+  }
+
+  void emit(OpCode op, int64_t operand = 0) {
+    derivation_->code_.push_back({op, operand});
+    switch (op) {
+      case OpCode::kConstant:
+      case OpCode::kLoad:
+        push();
+        break;
+      case OpCode::kNot:
+      case OpCode::kNegate:
+      case OpCode::kJump:
+        break;
+      default:
+        // binary operators, stores and conditional jumps pop one value.
+        --depth_;
+        break;
+    }
+  }
+
+  void push() {
+    if (++depth_ > TypeDerivation::kMaxStackDepth) {
+      fail("expression is too deeply nested");
+    }
+  }
+
+  /// Slot of a name, a name which is read before it is assigned is an input.
+  size_t slotOf(std::string_view name, bool assign) {
+    for (size_t i = 0; i < slotNames_.size(); ++i) {
+      if (slotNames_[i] == name) {
+        return i;
+      }
+    }
+    if (slotNames_.size() == TypeDerivation::kMaxSlots) {
+      fail("too many names, at most {} are supported", slotNames_.size());
+    }
+    const auto slot = slotNames_.size();
+    slotNames_.emplace_back(name);
+    if (!assign) {
+      derivation_->inputs_.push_back({std::string(name), slot});
+    }
+    return slot;
+  }
+
+  void compileAssignment() {
+    const auto name = parseIdentifier();
+    expect('=');
+    compileExpression();
+    emit(OpCode::kStore, static_cast<int64_t>(slotOf(name, true)));
+    if (!atEnd()) {
+      fail("unexpected character '{}'", line_[pos_]);
+    }
+  }
+
+  void compileResultType() {
+    skipWhitespace();
+    const auto nameStart = pos_;
+    const auto name = parseIdentifier();
+    if (!consume('<')) {
+      const bool nullable = consume('?');
+      if (!atEnd()) {
+        fail("unexpected character '{}'", line_[pos_]);
+      }
+      compileConstantOrPlaceholder(name, line_.substr(nameStart), nullable);
+      return;
+    }
+
+    auto& derivation = *derivation_;
+    size_t numParams = 1;
+    if (equalsIgnoreCase<TypeKind::kDecimal>(name)) {
+      derivation.resultKind_ = TypeKind::kDecimal;
+      numParams = 2;
+    } else if (equalsIgnoreCase<TypeKind::kVarchar>(name)) {
+      derivation.resultKind_ = TypeKind::kVarchar;
+    } else if (equalsIgnoreCase<TypeKind::kFixedChar>(name)) {
+      derivation.resultKind_ = TypeKind::kFixedChar;
+    } else if (equalsIgnoreCase<TypeKind::kFixedBinary>(name)) {
+      derivation.resultKind_ = TypeKind::kFixedBinary;
+    } else {
+      pos_ = nameStart;
+      fail("unsupported result type '{}'", name);
+    }
+
+    for (size_t i = 0; i < numParams; ++i) {
+      if (i > 0) {
+        expect(',');
+      }
+      // A '>' inside of the type parameters closes the type unless it is
+      // parenthesized.
+      inTypeParams_ = true;
+      compileExpression();
+      inTypeParams_ = false;
+      // Result slots are named so that no identifier can refer to them.
+      const auto slot = slotOf(fmt::format("<result{}>", i), true);
+      emit(OpCode::kStore, static_cast<int64_t>(slot));
+      derivation.resultSlots_.push_back(slot);
+    }
+    expect('>');
+    derivation.resultNullable_ = consume('?');
+    if (!atEnd()) {
+      fail("unexpected character '{}'", line_[pos_]);
+    }
+  }
+
+  template <TypeKind Kind>
+  static bool equalsIgnoreCase(std::string_view name) {
+    return common::StringUtils::equalsIgnoreCase(
+               name, TypeTraits<Kind>::typeString) ||
+        common::StringUtils::equalsIgnoreCase(
+               name, TypeTraits<Kind>::signature);
+  }
+
+  void compileConstantOrPlaceholder(
+      std::string_view name,
+      std::string_view rawType,
+      bool nullable) {
+    auto& derivation = *derivation_;
+    const auto type = ParameterizedType::decode(std::string(rawType));
+    if (type->isWildcard()) {
+      derivation.resultPlaceholder_ = std::string(name);
+      derivation.resultNullable_ = nullable;
+    } else if (isa<Type>(*type)) {
+      derivation.resultType_ = std::static_pointer_cast<const Type>(type);
+    } else {
+      fail("unsupported result type '{}'", rawType);
+    }
+  }
+
+  void compileExpression() {
+    compileOr();
+    if (!consume('?')) {
+      return;
+    }
+    // cond ? a : b
+    const auto jumpToElse = derivation_->code_.size();
+    emit(OpCode::kJumpIfZero);
+    compileExpression();
+    const auto jumpToEnd = derivation_->code_.size();
+    emit(OpCode::kJump);
+    // Only one of the branches is evaluated.
+    --depth_;
+    expect(':');
+    derivation_->code_[jumpToElse].operand =
+        static_cast<int64_t>(derivation_->code_.size());
+    compileExpression();
+    derivation_->code_[jumpToEnd].operand =
+        static_cast<int64_t>(derivation_->code_.size());
+  }
+
+  void compileOr() {
+    compileAnd();
+    while (consume("||") || consumeKeyword("or")) {
+      compileAnd();
+      emit(OpCode::kOr);
+    }
+  }
+
+  void compileAnd() {
+    compileComparison();
+    while (consume("&&") || consumeKeyword("and")) {
+      compileComparison();
+      emit(OpCode::kAnd);
+    }
+  }
+
+  void compileComparison() {
+    compileAdditive();
+    OpCode op;
+    if (consume("<=")) {
+      op = OpCode::kLessEqual;
+    } else if (consume(">=")) {
+      op = OpCode::kGreaterEqual;
+    } else if (consume("==")) {
+      op = OpCode::kEqual;
+    } else if (consume("!=")) {
+      op = OpCode::kNotEqual;
+    } else if (consume('<')) {
+      op = OpCode::kLess;
+    } else if (!inTypeParams_ && consume('>')) {
+      op = OpCode::kGreater;
+    } else {
+      return;
+    }
+    compileAdditive();
+    emit(op);
+  }
+
+  void compileAdditive() {
+    compileMultiplicative();
+    while (true) {
+      if (consume('+')) {
+        compileMultiplicative();
+        emit(OpCode::kAdd);
+      } else if (consume('-')) {
+        compileMultiplicative();
+        emit(OpCode::kSubtract);
+      } else {
+        return;
+      }
+    }
+  }
+
+  void compileMultiplicative() {
+    compileUnary();
+    while (true) {
+      if (consume('*')) {
+        compileUnary();
+        emit(OpCode::kMultiply);
+      } else if (consume('/')) {
+        compileUnary();
+        emit(OpCode::kDivide);
+      } else {
+        return;
+      }
+    }
+  }
+
+  void compileUnary() {
+    if (consume('-')) {
+      compileUnary();
+      emit(OpCode::kNegate);
+    } else if (!peek("!=") && consume('!')) {
+      compileUnary();
+      emit(OpCode::kNot);
+    } else if (consumeKeyword("not")) {
+      compileUnary();
+      emit(OpCode::kNot);
+    } else {
+      compilePrimary();
+    }
+  }
+
+  void compilePrimary() {
+    skipWhitespace();
+    if (consume('(')) {
+      const auto inTypeParams = inTypeParams_;
+      inTypeParams_ = false;
+      compileExpression();
+      inTypeParams_ = inTypeParams;
+      expect(')');
+      return;
+    }
+    if (pos_ < line_.size() &&
+        std::isdigit(static_cast<unsigned char>(line_[pos_]))) {
+      int64_t value = 0;
+      while (pos_ < line_.size() &&
+             std::isdigit(static_cast<unsigned char>(line_[pos_]))) {
+        const int64_t digit = line_[pos_] - '0';
+        if (value > (std::numeric_limits<int64_t>::max() - digit) / 10) {
+          fail("integer literal is out of range");
+        }
+        value = value * 10 + digit;
+        ++pos_;
+      }
+      emit(OpCode::kConstant, value);
+      return;
+    }
+
+    const auto namePos = pos_;
+    const auto name = parseIdentifier();
+    if (!consume('(')) {
+      emit(OpCode::kLoad, static_cast<int64_t>(slotOf(name, false)));
+      return;
+    }
+    OpCode op;
+    if (common::StringUtils::equalsIgnoreCase(name, "min")) {
+      op = OpCode::kMin;
+    } else if (common::StringUtils::equalsIgnoreCase(name, "max")) {
+      op = OpCode::kMax;
+    } else {
+      pos_ = namePos;
+      fail("unknown function '{}'", name);
+    }
+    const auto inTypeParams = inTypeParams_;
+    inTypeParams_ = false;
+    compileExpression();
+    expect(',');
+    compileExpression();
+    inTypeParams_ = inTypeParams;
+    expect(')');
+    emit(op);
+  }
+
+  const std::string_view expression_;
+  std::shared_ptr<TypeDerivation> derivation_;
+  std::vector<std::string> slotNames_;
+  std::string_view line_;
+  size_t pos_{0};
+  size_t depth_{0};
+  bool inTypeParams_{false};
+};
+
+std::shared_ptr<const TypeDerivation> TypeDerivation::compile(
+    std::string_view expression) {
+  return TypeDerivationCompiler(expression).compile();
+}
+
+namespace {
+
+[[noreturn]] void overflow() {
+  SUBSTRAIT_IVALID_ARGUMENT("Integer overflow in type derivation");
+}
+
+} // namespace
+
+void TypeDerivation::run(int64_t* slots) const {
+  int64_t stack[kMaxStackDepth];
+  // Points at the top value of the stack.
+  int64_t* top = stack - 1;
+  const auto* code = code_.data();
+  const auto* end = code + code_.size();
+  for (const auto* instruction = code; instruction != end; ++instruction) {
+    switch (instruction->op) {
+      case OpCode::kConstant:
+        *++top = instruction->operand;
+        break;
+      case OpCode::kLoad:
+        *++top = slots[instruction->operand];
+        break;
+      case OpCode::kStore:
+        slots[instruction->operand] = *top--;
+        break;
+      case OpCode::kAdd:
+        if (__builtin_add_overflow(top[-1], top[0], &top[-1])) {
+          overflow();
+        }
+        --top;
+        break;
+      case OpCode::kSubtract:
+        if (__builtin_sub_overflow(top[-1], top[0], &top[-1])) {
+          overflow();
+        }
+        --top;
+        break;
+      case OpCode::kMultiply:
+        if (__builtin_mul_overflow(top[-1], top[0], &top[-1])) {
+          overflow();
+        }
+        --top;
+        break;
+      case OpCode::kDivide:
+        if (top[0] == 0) {
+          SUBSTRAIT_IVALID_ARGUMENT("Division by zero in type derivation");
+        }
+        if (top[-1] == std::numeric_limits<int64_t>::min() && top[0] == -1) {
+          overflow();
+        }
+        top[-1] /= top[0];
+        --top;
+        break;
+      case OpCode::kMin:
+        top[-1] = std::min(top[-1], top[0]);
+        --top;
+        break;
+      case OpCode::kMax:
+        top[-1] = std::max(top[-1], top[0]);
+        --top;
+        break;
+      case OpCode::kLess:
+        top[-1] = top[-1] < top[0];
+        --top;
+        break;
+      case OpCode::kLessEqual:
+        top[-1] = top[-1] <= top[0];
+        --top;
+        break;
+      case OpCode::kGreater:
+        top[-1] = top[-1] > top[0];
+        --top;
+        break;
+      case OpCode::kGreaterEqual:
+        top[-1] = top[-1] >= top[0];
+        --top;
+        break;
+      case OpCode::kEqual:
+        top[-1] = top[-1] == top[0];
+        --top;
+        break;
+      case OpCode::kNotEqual:
+        top[-1] = top[-1] != top[0];
+        --top;
+        break;
+      case OpCode::kAnd:
+        top[-1] = top[-1] && top[0];
+        --top;
+        break;
+      case OpCode::kOr:
+        top[-1] = top[-1] || top[0];
+        --top;
+        break;
+      case OpCode::kNot:
+        top[0] = !top[0];
+        break;
+      case OpCode::kNegate:
+        if (top[0] == std::numeric_limits<int64_t>::min()) {
+          overflow();
+        }
+        top[0] = -top[0];
+        break;
+      case OpCode::kJumpIfZero:
+        if (*top-- == 0) {
+          instruction = code + instruction->operand - 1;
+        }
+        break;
+      case OpCode::kJump:
+        instruction = code + instruction->operand - 1;
+        break;
+    }
+  }
+}
+
+namespace {
+
+int toParameter(int64_t value, const char* name) {
+  if (value < 0 || value > std::numeric_limits<int>::max()) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Derived {} {} is out of range", name, value);
+  }
+  return static_cast<int>(value);
+}
+
+} // namespace
+
+TypePtr TypeDerivation::evaluate(const TypeBindings& bindings) const {
+  if (resultType_) {
+    return resultType_;
+  }
+  if (!resultPlaceholder_.empty()) {
+    const auto* bound = bindings.findType(resultPlaceholder_);
+    if (bound == nullptr || !isa<Type>(*bound)) {
+      SUBSTRAIT_IVALID_ARGUMENT(
+          "Type placeholder {} is not bound", resultPlaceholder_);
+    }
+    // A nullable result such as any1? is nullable whatever any1 is bound to.
+    return TypeFactory::instance().withNullable(
+        cast<Type>(*bound), resultNullable_ || bound->nullable());
+  }
+
+  int64_t slots[kMaxSlots];
+  for (const auto& input : inputs_) {
+    const auto value = bindings.findValue(input.name);
+    if (!value.has_value()) {
+      SUBSTRAIT_IVALID_ARGUMENT("Placeholder {} is not bound", input.name);
+    }
+    slots[input.slot] = *value;
+  }
+  run(slots);
+
+  auto& factory = TypeFactory::instance();
+  switch (resultKind_) {
+    case TypeKind::kDecimal:
+      return factory.decimal(
+          toParameter(slots[resultSlots_[0]], "precision"),
+          toParameter(slots[resultSlots_[1]], "scale"),
+          resultNullable_);
+    case TypeKind::kVarchar:
+      return factory.varchar(
+          toParameter(slots[resultSlots_[0]], "length"), resultNullable_);
+    case TypeKind::kFixedChar:
+      return factory.fixedChar(
+          toParameter(slots[resultSlots_[0]], "length"), resultNullable_);
+    case TypeKind::kFixedBinary:
+      return factory.fixedBinary(
+          toParameter(slots[resultSlots_[0]], "length"), resultNullable_);
+    default:
+      SUBSTRAIT_UNREACHABLE("Unexpected type derivation result");
+  }
+}
+
+} // namespace io::substrait
@@ -0,0 +1,342 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeFactory.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "substrait/common/HashUtils.h"
+
+namespace io::substrait {
+
+struct TypeFactory::Shape {
+  TypeKind kind;
+  bool nullable;
+  /// Precision or length of the type, 0 if it has none.
+  int first;
+  /// Scale of a decimal type, 0 otherwise.
+  int second;
+  /// Children of a nested type, interned unless the pool is full.
+  const TypePtr* children;
+  size_t numChildren;
+};
+
+namespace {
+
+template <typename Shape>
+size_t hashShape(const Shape& shape) {
+  using common::HashUtils;
+  size_t hash = HashUtils::hashCombine(
+      static_cast<size_t>(shape.kind), static_cast<size_t>(shape.nullable));
+  hash = HashUtils::hashCombine(hash, static_cast<size_t>(shape.first));
+  hash = HashUtils::hashCombine(hash, static_cast<size_t>(shape.second));
+  for (size_t i = 0; i < shape.numChildren; ++i) {
+    hash = HashUtils::hashCombine(
+        hash, reinterpret_cast<size_t>(shape.children[i].get()));
+  }
+  return hash;
+}
+
+template <typename Shape>
+bool sameChildren(const TypeArray& children, const Shape& shape) {
+  if (children.size() != shape.numChildren) {
+    return false;
+  }
+  for (size_t i = 0; i < shape.numChildren; ++i) {
+    if (children[i] != shape.children[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Test whether an interned type has the given shape. Children of interned
+/// types are interned too, so they are compared by pointer.
+template <typename Shape>
+bool sameShape(const Type& type, const Shape& shape) {
+  if (type.kind() != shape.kind || type.nullable() != shape.nullable) {
+    return false;
+  }
+  switch (shape.kind) {
+    case TypeKind::kDecimal: {
+      const auto& decimal = cast<Decimal>(type);
+      return decimal.precision() == shape.first &&
+          decimal.scale() == shape.second;
+    }
+    case TypeKind::kVarchar:
+      return cast<Varchar>(type).length() == shape.first;
+    case TypeKind::kFixedChar:
+      return cast<FixedChar>(type).length() == shape.first;
+    case TypeKind::kFixedBinary:
+      return cast<FixedBinary>(type).length() == shape.first;
+    case TypeKind::kList:
+      return cast<List>(type).elementType() ==
+          shape.children[0];
+    case TypeKind::kMap: {
+      const auto& map = cast<Map>(type);
+      return map.keyType() == shape.children[0] &&
+          map.valueType() == shape.children[1];
+    }
+    case TypeKind::kStruct:
+      return sameChildren(cast<Struct>(type).childArray(), shape);
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+TypeFactory& TypeFactory::instance() {
+  // Never destroyed, interned types must outlive every static holding them.
+  static auto* factory = new TypeFactory();
+  return *factory;
+}
+
+const Type* TypeFactory::find(size_t hash, const Shape& shape) const {
+  auto range = types_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (sameShape(*it->second, shape)) {
+      return it->second.get();
+    }
+  }
+  return nullptr;
+}
+
+template <typename T, typename Creator>
+std::shared_ptr<const T> TypeFactory::getOrCreate(
+    Shape shape,
+    Creator creator) {
+  const auto hash = hashShape(shape);
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (const auto* type = find(hash, shape)) {
+      return unowned(static_cast<const T*>(type));
+    }
+  }
+
+  // Build the type outside of the lock, another thread may win the race in
+  // which case the freshly built type is discarded.
+  std::shared_ptr<T> created = creator();
+  if constexpr (std::is_same_v<T, Struct>) {
+    // The children may have been moved into the new struct.
+    shape.children = created->childArray().data();
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (const auto* type = find(hash, shape)) {
+    return unowned(static_cast<const T*>(type));
+  }
+  // Interned types only hold interned children, which a full pool may not
+  // have interned.
+  const bool internable = types_.size() < capacity_ &&
+      std::all_of(
+          shape.children,
+          shape.children + shape.numChildren,
+          [](const TypePtr& child) { return child->isInterned(); });
+  if (!internable) {
+    return created;
+  }
+  created->interned_ = true;
+  types_.emplace(hash, created);
+  return unowned(created.get());
+}
+
+std::shared_ptr<const Decimal>
+TypeFactory::decimal(int precision, int scale, bool nullable) {
+  const Shape shape{
+      TypeKind::kDecimal, nullable, precision, scale, nullptr, 0};
+  return getOrCreate<Decimal>(shape, [&]() {
+    return std::make_shared<Decimal>(precision, scale, nullable);
+  });
+}
+
+std::shared_ptr<const Varchar> TypeFactory::varchar(int length, bool nullable) {
+  const Shape shape{TypeKind::kVarchar, nullable, length, 0, nullptr, 0};
+  return getOrCreate<Varchar>(shape, [&]() {
+    return std::make_shared<Varchar>(length, nullable);
+  });
+}
+
+std::shared_ptr<const FixedChar> TypeFactory::fixedChar(
+    int length,
+    bool nullable) {
+  const Shape shape{TypeKind::kFixedChar, nullable, length, 0, nullptr, 0};
+  return getOrCreate<FixedChar>(shape, [&]() {
+    return std::make_shared<FixedChar>(length, nullable);
+  });
+}
+
+std::shared_ptr<const FixedBinary> TypeFactory::fixedBinary(
+    int length,
+    bool nullable) {
+  const Shape shape{TypeKind::kFixedBinary, nullable, length, 0, nullptr, 0};
+  return getOrCreate<FixedBinary>(shape, [&]() {
+    return std::make_shared<FixedBinary>(length, nullable);
+  });
+}
+
+std::shared_ptr<const List> TypeFactory::list(
+    const TypePtr& elementType,
+    bool nullable) {
+  const auto element = intern(elementType);
+  const Shape shape{TypeKind::kList, nullable, 0, 0, &element, 1};
+  return getOrCreate<List>(shape, [&]() {
+    return std::make_shared<List>(element, nullable);
+  });
+}
+
+std::shared_ptr<const Map> TypeFactory::map(
+    const TypePtr& keyType,
+    const TypePtr& valueType,
+    bool nullable) {
+  const TypePtr children[] = {intern(keyType), intern(valueType)};
+  const Shape shape{TypeKind::kMap, nullable, 0, 0, children, 2};
+  return getOrCreate<Map>(shape, [&]() {
+    return std::make_shared<Map>(children[0], children[1], nullable);
+  });
+}
+
+std::shared_ptr<const Struct> TypeFactory::structType(
+    const std::vector<TypePtr>& children,
+    bool nullable) {
+  return makeStructType(children, nullable);
+}
+
+std::shared_ptr<const Struct> TypeFactory::structType(
+    const TypeArray& children,
+    bool nullable) {
+  return makeStructType(children, nullable);
+}
+
+template <typename Children>
+std::shared_ptr<const Struct> TypeFactory::makeStructType(
+    const Children& children,
+    bool nullable) {
+  std::vector<TypePtr> internedChildren;
+  internedChildren.reserve(children.size());
+  for (const auto& child : children) {
+    internedChildren.emplace_back(intern(child));
+  }
+  TypeArray internedArray(std::move(internedChildren));
+  const Shape shape{
+      TypeKind::kStruct,
+      nullable,
+      0,
+      0,
+      internedArray.data(),
+      internedArray.size()};
+  return getOrCreate<Struct>(shape, [&]() {
+    return std::make_shared<Struct>(std::move(internedArray), nullable);
+  });
+}
+
+TypePtr TypeFactory::scalarType(TypeKind kind, bool nullable) {
+  switch (kind) {
+    case TypeKind::kBool:
+      return scalar<TypeKind::kBool>(nullable);
+    case TypeKind::kI8:
+      return scalar<TypeKind::kI8>(nullable);
+    case TypeKind::kI16:
+      return scalar<TypeKind::kI16>(nullable);
+    case TypeKind::kI32:
+      return scalar<TypeKind::kI32>(nullable);
+    case TypeKind::kI64:
+      return scalar<TypeKind::kI64>(nullable);
+    case TypeKind::kFp32:
+      return scalar<TypeKind::kFp32>(nullable);
+    case TypeKind::kFp64:
+      return scalar<TypeKind::kFp64>(nullable);
+    case TypeKind::kString:
+      return scalar<TypeKind::kString>(nullable);
+    case TypeKind::kBinary:
+      return scalar<TypeKind::kBinary>(nullable);
+    case TypeKind::kTimestamp:
+      return scalar<TypeKind::kTimestamp>(nullable);
+    case TypeKind::kDate:
+      return scalar<TypeKind::kDate>(nullable);
+    case TypeKind::kTime:
+      return scalar<TypeKind::kTime>(nullable);
+    case TypeKind::kIntervalYear:
+      return scalar<TypeKind::kIntervalYear>(nullable);
+    case TypeKind::kIntervalDay:
+      return scalar<TypeKind::kIntervalDay>(nullable);
+    case TypeKind::kTimestampTz:
+      return scalar<TypeKind::kTimestampTz>(nullable);
+    case TypeKind::kUuid:
+      return scalar<TypeKind::kUuid>(nullable);
+    default:
+      return nullptr;
+  }
+}
+
+TypePtr TypeFactory::intern(const TypePtr& type) {
+  if (!type) {
+    return type;
+  }
+  auto interned = intern(*type);
+  return interned ? interned : type;
+}
+
+TypePtr TypeFactory::intern(const Type& type) {
+  if (type.isInterned()) {
+    return unowned(&type);
+  }
+  return internAs(type, type.nullable());
+}
+
+TypePtr TypeFactory::withNullable(const Type& type, bool nullable) {
+  if (!type.isInterned()) {
+    return internAs(type, nullable);
+  }
+  if (type.nullable() == nullable) {
+    return unowned(&type);
+  }
+  const auto* sibling = type.sibling_.load(std::memory_order_acquire);
+  if (sibling == nullptr) {
+    auto created = internAs(type, nullable);
+    if (!created->isInterned()) {
+      return created; // the pool is full
+    }
+    // Interned types are unique, so racing threads link the same sibling.
+    sibling = created.get();
+    type.sibling_.store(sibling, std::memory_order_release);
+    sibling->sibling_.store(&type, std::memory_order_release);
+  }
+  return unowned(sibling);
+}
+
+TypePtr TypeFactory::internAs(const Type& type, bool nullable) {
+  switch (type.kind()) {
+    case TypeKind::kDecimal: {
+      const auto& decimalType = cast<Decimal>(type);
+      return decimal(decimalType.precision(), decimalType.scale(), nullable);
+    }
+    case TypeKind::kVarchar:
+      return varchar(cast<Varchar>(type).length(), nullable);
+    case TypeKind::kFixedChar:
+      return fixedChar(cast<FixedChar>(type).length(), nullable);
+    case TypeKind::kFixedBinary:
+      return fixedBinary(cast<FixedBinary>(type).length(), nullable);
+    case TypeKind::kList:
+      return list(cast<List>(type).elementType(), nullable);
+    case TypeKind::kMap: {
+      const auto& mapType = cast<Map>(type);
+      return map(mapType.keyType(), mapType.valueType(), nullable);
+    }
+    case TypeKind::kStruct:
+      return structType(cast<Struct>(type).childArray(), nullable);
+    default:
+      return scalarType(type.kind(), nullable);
+  }
+}
+
+size_t TypeFactory::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return types_.size();
+}
+
+void TypeFactory::setCapacity(size_t capacity) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  capacity_ = capacity;
+}
+
+} // namespace io::substrait
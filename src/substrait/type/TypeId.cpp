@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeId.h"
+
+#include <limits>
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeFactory.h"
+
+namespace io::substrait {
+
+namespace {
+
+bool isFirstInRange(int value) {
+  return value >= 0;
+}
+
+bool isSecondInRange(int value) {
+  return value >= 0 && value <= std::numeric_limits<uint16_t>::max();
+}
+
+} // namespace
+
+std::optional<TypeId> TypeId::tryFrom(const ParameterizedType& type) {
+  if (type.isParameterized()) {
+    return std::nullopt;
+  }
+  const auto nullable = type.nullable();
+  switch (type.kind()) {
+    case TypeKind::kDecimal: {
+      const auto& decimal = cast<Decimal>(type);
+      if (!isFirstInRange(decimal.precision()) ||
+          !isSecondInRange(decimal.scale())) {
+        return std::nullopt;
+      }
+      return TypeId::decimal(decimal.precision(), decimal.scale(), nullable);
+    }
+    case TypeKind::kVarchar: {
+      const auto length = cast<Varchar>(type).length();
+      if (!isFirstInRange(length)) {
+        return std::nullopt;
+      }
+      return TypeId::varchar(length, nullable);
+    }
+    case TypeKind::kFixedChar: {
+      const auto length = cast<FixedChar>(type).length();
+      if (!isFirstInRange(length)) {
+        return std::nullopt;
+      }
+      return TypeId::fixedChar(length, nullable);
+    }
+    case TypeKind::kFixedBinary: {
+      const auto length = cast<FixedBinary>(type).length();
+      if (!isFirstInRange(length)) {
+        return std::nullopt;
+      }
+      return TypeId::fixedBinary(length, nullable);
+    }
+    case TypeKind::kList:
+    case TypeKind::kMap:
+    case TypeKind::kStruct:
+    case TypeKind::KIND_NOT_SET:
+      return std::nullopt;
+    default:
+      return TypeId::scalar(type.kind(), nullable);
+  }
+}
+
+TypePtr TypeId::toType() const {
+  auto& factory = TypeFactory::instance();
+  switch (kind()) {
+    case TypeKind::kDecimal:
+      return factory.decimal(
+          static_cast<int>(first()), static_cast<int>(second()), nullable());
+    case TypeKind::kVarchar:
+      return factory.varchar(static_cast<int>(first()), nullable());
+    case TypeKind::kFixedChar:
+      return factory.fixedChar(static_cast<int>(first()), nullable());
+    case TypeKind::kFixedBinary:
+      return factory.fixedBinary(static_cast<int>(first()), nullable());
+    default:
+      if (auto type = TypeFactory::scalarType(kind(), nullable())) {
+        return type;
+      }
+      SUBSTRAIT_UNSUPPORTED(
+          "TypeId {:#x} has no corresponding type", value());
+  }
+}
+
+} // namespace io::substrait
@@ -0,0 +1,250 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeProtoConverter.h"
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/proto/type.pb.h"
+#include "substrait/type/TypeFactory.h"
+
+namespace io::substrait {
+
+namespace {
+
+using ProtoType = ::substrait::proto::Type;
+
+bool isNullable(ProtoType::Nullability nullability) {
+  return nullability == ProtoType::NULLABILITY_NULLABLE;
+}
+
+template <typename Message>
+void setNullability(Message* message, bool nullable) {
+  message->set_nullability(
+      nullable ? ProtoType::NULLABILITY_NULLABLE
+               : ProtoType::NULLABILITY_REQUIRED);
+}
+
+template <TypeKind Kind, typename Message>
+TypePtr fromScalar(const Message& message) {
+  return TypeFactory::scalar<Kind>(isNullable(message.nullability()));
+}
+
+void convert(const Type& type, ProtoType* proto) {
+  const auto nullable = type.nullable();
+  switch (type.kind()) {
+    case TypeKind::kBool:
+      setNullability(proto->mutable_bool_(), nullable);
+      return;
+    case TypeKind::kI8:
+      setNullability(proto->mutable_i8(), nullable);
+      return;
+    case TypeKind::kI16:
+      setNullability(proto->mutable_i16(), nullable);
+      return;
+    case TypeKind::kI32:
+      setNullability(proto->mutable_i32(), nullable);
+      return;
+    case TypeKind::kI64:
+      setNullability(proto->mutable_i64(), nullable);
+      return;
+    case TypeKind::kFp32:
+      setNullability(proto->mutable_fp32(), nullable);
+      return;
+    case TypeKind::kFp64:
+      setNullability(proto->mutable_fp64(), nullable);
+      return;
+    case TypeKind::kString:
+      setNullability(proto->mutable_string(), nullable);
+      return;
+    case TypeKind::kBinary:
+      setNullability(proto->mutable_binary(), nullable);
+      return;
+    case TypeKind::kTimestamp:
+      setNullability(proto->mutable_timestamp(), nullable);
+      return;
+    case TypeKind::kDate:
+      setNullability(proto->mutable_date(), nullable);
+      return;
+    case TypeKind::kTime:
+      setNullability(proto->mutable_time(), nullable);
+      return;
+    case TypeKind::kIntervalYear:
+      setNullability(proto->mutable_interval_year(), nullable);
+      return;
+    case TypeKind::kIntervalDay:
+      setNullability(proto->mutable_interval_day(), nullable);
+      return;
+    case TypeKind::kTimestampTz:
+      setNullability(proto->mutable_timestamp_tz(), nullable);
+      return;
+    case TypeKind::kUuid:
+      setNullability(proto->mutable_uuid(), nullable);
+      return;
+    case TypeKind::kFixedChar: {
+      auto* fixedChar = proto->mutable_fixed_char();
+      fixedChar->set_length(cast<FixedChar>(type).length());
+      setNullability(fixedChar, nullable);
+      return;
+    }
+    case TypeKind::kVarchar: {
+      auto* varchar = proto->mutable_varchar();
+      varchar->set_length(cast<Varchar>(type).length());
+      setNullability(varchar, nullable);
+      return;
+    }
+    case TypeKind::kFixedBinary: {
+      auto* fixedBinary = proto->mutable_fixed_binary();
+      fixedBinary->set_length(cast<FixedBinary>(type).length());
+      setNullability(fixedBinary, nullable);
+      return;
+    }
+    case TypeKind::kDecimal: {
+      const auto& decimalType = cast<Decimal>(type);
+      auto* decimal = proto->mutable_decimal();
+      decimal->set_precision(decimalType.precision());
+      decimal->set_scale(decimalType.scale());
+      setNullability(decimal, nullable);
+      return;
+    }
+    case TypeKind::kStruct: {
+      const auto& children = cast<Struct>(type).childArray();
+      auto* structType = proto->mutable_struct_();
+      auto* types = structType->mutable_types();
+      types->Reserve(static_cast<int>(children.size()));
+      for (const auto& child : children) {
+        // Added elements live on the arena of the message.
+        convert(*child, types->Add());
+      }
+      setNullability(structType, nullable);
+      return;
+    }
+    case TypeKind::kList: {
+      auto* list = proto->mutable_list();
+      convert(*cast<List>(type).elementType(), list->mutable_type());
+      setNullability(list, nullable);
+      return;
+    }
+    case TypeKind::kMap: {
+      const auto& mapType = cast<Map>(type);
+      auto* map = proto->mutable_map();
+      convert(*mapType.keyType(), map->mutable_key());
+      convert(*mapType.valueType(), map->mutable_value());
+      setNullability(map, nullable);
+      return;
+    }
+    default:
+      SUBSTRAIT_UNSUPPORTED(
+          "Type kind {} has no proto type", static_cast<int>(type.kind()));
+  }
+}
+
+} // namespace
+
+TypePtr TypeProtoConverter::fromProto(const ProtoType& proto) {
+  auto& factory = TypeFactory::instance();
+  switch (proto.kind_case()) {
+    case ProtoType::kBool:
+      return fromScalar<TypeKind::kBool>(proto.bool_());
+    case ProtoType::kI8:
+      return fromScalar<TypeKind::kI8>(proto.i8());
+    case ProtoType::kI16:
+      return fromScalar<TypeKind::kI16>(proto.i16());
+    case ProtoType::kI32:
+      return fromScalar<TypeKind::kI32>(proto.i32());
+    case ProtoType::kI64:
+      return fromScalar<TypeKind::kI64>(proto.i64());
+    case ProtoType::kFp32:
+      return fromScalar<TypeKind::kFp32>(proto.fp32());
+    case ProtoType::kFp64:
+      return fromScalar<TypeKind::kFp64>(proto.fp64());
+    case ProtoType::kString:
+      return fromScalar<TypeKind::kString>(proto.string());
+    case ProtoType::kBinary:
+      return fromScalar<TypeKind::kBinary>(proto.binary());
+    case ProtoType::kTimestamp:
+      return fromScalar<TypeKind::kTimestamp>(proto.timestamp());
+    case ProtoType::kDate:
+      return fromScalar<TypeKind::kDate>(proto.date());
+    case ProtoType::kTime:
+      return fromScalar<TypeKind::kTime>(proto.time());
+    case ProtoType::kIntervalYear:
+      return fromScalar<TypeKind::kIntervalYear>(proto.interval_year());
+    case ProtoType::kIntervalDay:
+      return fromScalar<TypeKind::kIntervalDay>(proto.interval_day());
+    case ProtoType::kTimestampTz:
+      return fromScalar<TypeKind::kTimestampTz>(proto.timestamp_tz());
+    case ProtoType::kUuid:
+      return fromScalar<TypeKind::kUuid>(proto.uuid());
+    case ProtoType::kFixedChar: {
+      const auto& fixedChar = proto.fixed_char();
+      return factory.fixedChar(
+          fixedChar.length(), isNullable(fixedChar.nullability()));
+    }
+    case ProtoType::kVarchar: {
+      const auto& varchar = proto.varchar();
+      return factory.varchar(
+          varchar.length(), isNullable(varchar.nullability()));
+    }
+    case ProtoType::kFixedBinary: {
+      const auto& fixedBinary = proto.fixed_binary();
+      return factory.fixedBinary(
+          fixedBinary.length(), isNullable(fixedBinary.nullability()));
+    }
+    case ProtoType::kDecimal: {
+      const auto& decimal = proto.decimal();
+      return factory.decimal(
+          decimal.precision(),
+          decimal.scale(),
+          isNullable(decimal.nullability()));
+    }
+    case ProtoType::kStruct: {
+      const auto& structType = proto.struct_();
+      std::vector<TypePtr> children;
+      children.reserve(structType.types_size());
+      for (const auto& child : structType.types()) {
+        children.emplace_back(fromProto(child));
+      }
+      return factory.structType(
+          TypeArray(std::move(children)),
+          isNullable(structType.nullability()));
+    }
+    case ProtoType::kList: {
+      const auto& list = proto.list();
+      return factory.list(
+          fromProto(list.type()), isNullable(list.nullability()));
+    }
+    case ProtoType::kMap: {
+      const auto& map = proto.map();
+      return factory.map(
+          fromProto(map.key()),
+          fromProto(map.value()),
+          isNullable(map.nullability()));
+    }
+    case ProtoType::kUserDefinedTypeReference:
+      SUBSTRAIT_UNSUPPORTED(
+          "User defined type {} is not supported",
+          proto.user_defined_type_reference());
+    default:
+      SUBSTRAIT_IVALID_ARGUMENT("Proto type kind is not set");
+  }
+}
+
+ProtoType* TypeProtoConverter::toProto(
+    const Type& type,
+    google::protobuf::Arena* arena) {
+  if (arena == nullptr) {
+    auto proto = std::make_unique<ProtoType>();
+    convert(type, proto.get());
+    return proto.release();
+  }
+  // Messages on the arena are freed with it, also if converting fails.
+  auto* proto = google::protobuf::Arena::CreateMessage<ProtoType>(arena);
+  convert(type, proto);
+  return proto;
+}
+
+void TypeProtoConverter::toProto(const Type& type, ProtoType& proto) {
+  proto.Clear();
+  convert(type, &proto);
+}
+
+} // namespace io::substrait
@@ -0,0 +1,419 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "substrait/type/TypeSerializer.h"
+
+#include <limits>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeVisitor.h"
+
+namespace io::substrait {
+
+namespace {
+
+constexpr uint8_t kKindMask = 0x1f;
+constexpr uint8_t kNullableBit = 0x20;
+constexpr uint8_t kWildcardBit = 0x20;
+constexpr uint8_t kParameterizedBit = 0x40;
+constexpr uint8_t kPlaceholderBit = 0x80;
+
+/// Types nested deeper than this only come from corrupt input, rejecting
+/// them bounds the recursion of the reader.
+constexpr int kMaxDepth = 128;
+
+const TypeArray& childrenOf(const Struct& type) {
+  return type.childArray();
+}
+
+const std::vector<ParameterizedTypePtr>& childrenOf(
+    const ParameterizedStruct& type) {
+  return type.children();
+}
+
+constexpr bool isLengthKind(TypeKind kind) {
+  return kind == TypeKind::kVarchar || kind == TypeKind::kFixedChar ||
+      kind == TypeKind::kFixedBinary;
+}
+
+void writeVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+/// Writes the nodes of a type depth first, see TypeSerializer.
+class Writer {
+ public:
+  explicit Writer(std::string& out) : out_(out) {}
+
+  void write(const ParameterizedType& type) {
+    visit(type, *this);
+  }
+
+  void operator()(const StringLiteral& literal) {
+    out_.push_back(static_cast<char>(
+        static_cast<uint8_t>(TypeKind::KIND_NOT_SET) | kParameterizedBit |
+        (literal.isWildcard() ? kWildcardBit : 0) |
+        (literal.isPlaceholder() ? kPlaceholderBit : 0)));
+    writeVarint(literal.value().size(), out_);
+    out_.append(literal.value());
+  }
+
+  template <typename T>
+  void operator()(const T& type) {
+    out_.push_back(static_cast<char>(
+        static_cast<uint8_t>(T::kKind) |
+        (type.nullable() ? kNullableBit : 0) |
+        (type.isParameterized() ? kParameterizedBit : 0)));
+    if constexpr (T::kKind == TypeKind::kDecimal) {
+      writeParameter(type.precision());
+      writeParameter(type.scale());
+    } else if constexpr (isLengthKind(T::kKind)) {
+      writeParameter(type.length());
+    } else if constexpr (T::kKind == TypeKind::kList) {
+      write(*type.elementType());
+    } else if constexpr (T::kKind == TypeKind::kMap) {
+      write(*type.keyType());
+      write(*type.valueType());
+    } else if constexpr (T::kKind == TypeKind::kStruct) {
+      const auto& children = childrenOf(type);
+      writeVarint(children.size(), out_);
+      for (const auto& child : children) {
+        write(*child);
+      }
+    }
+  }
+
+ private:
+  void writeParameter(int value) {
+    writeVarint(static_cast<uint32_t>(value), out_);
+  }
+
+  void writeParameter(const StringLiteralPtr& literal) {
+    (*this)(*literal);
+  }
+
+  std::string& out_;
+};
+
+/// Reads the nodes written by Writer, checking every read against the end
+/// of the buffer.
+class Reader {
+ public:
+  Reader(const uint8_t*& cursor, const uint8_t* end)
+      : cursor_(cursor), end_(end) {}
+
+  ParameterizedTypePtr read(int depth) {
+    if (depth > kMaxDepth) {
+      fail("types nested deeper than {} levels", kMaxDepth);
+    }
+    const auto tag = readByte();
+    const auto kind = static_cast<TypeKind>(tag & kKindMask);
+    if ((tag & kPlaceholderBit) != 0 && kind != TypeKind::KIND_NOT_SET) {
+      fail("invalid tag {:#x}", tag);
+    }
+    if ((tag & kParameterizedBit) != 0) {
+      return readParameterized(tag, kind, depth);
+    }
+    return readConcrete(tag, kind, depth);
+  }
+
+  /// Move the cursor past the type at the cursor without decoding it.
+  void skip(int depth) {
+    if (depth > kMaxDepth) {
+      fail("types nested deeper than {} levels", kMaxDepth);
+    }
+    const auto tag = readByte();
+    switch (static_cast<TypeKind>(tag & kKindMask)) {
+      case TypeKind::KIND_NOT_SET:
+        if ((tag & kParameterizedBit) != 0) {
+          cursor_ += readCount();
+        }
+        return;
+      case TypeKind::kDecimal:
+        skipParameter(tag, depth);
+        skipParameter(tag, depth);
+        return;
+      case TypeKind::kVarchar:
+      case TypeKind::kFixedChar:
+      case TypeKind::kFixedBinary:
+        skipParameter(tag, depth);
+        return;
+      case TypeKind::kList:
+        skip(depth + 1);
+        return;
+      case TypeKind::kMap:
+        skip(depth + 1);
+        skip(depth + 1);
+        return;
+      case TypeKind::kStruct:
+        for (auto count = readCount(); count > 0; --count) {
+          skip(depth + 1);
+        }
+        return;
+      default:
+        return;
+    }
+  }
+
+ private:
+  template <typename... Args>
+  [[noreturn]] void fail(const char* reason, const Args&... args) const {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Fail to deserialize type: {}",
+        common::errorMessage(reason, args...));
+  }
+
+  uint8_t readByte() {
+    if (cursor_ == end_) {
+      fail("unexpected end of input");
+    }
+    return *cursor_++;
+  }
+
+  uint64_t readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const auto byte = readByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    fail("varint longer than 10 bytes");
+  }
+
+  void skipParameter(uint8_t tag, int depth) {
+    if ((tag & kParameterizedBit) != 0) {
+      skip(depth + 1);
+    } else {
+      readVarint();
+    }
+  }
+
+  int readInt() {
+    const auto value = readVarint();
+    if (value > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+      fail("parameter {} out of range", value);
+    }
+    return static_cast<int>(value);
+  }
+
+  /// Read a count of items, which cannot exceed the remaining bytes.
+  size_t readCount() {
+    const auto count = readVarint();
+    if (count > static_cast<uint64_t>(end_ - cursor_)) {
+      fail("count {} exceeds the remaining input", count);
+    }
+    return static_cast<size_t>(count);
+  }
+
+  TypePtr readConcreteChild(int depth) {
+    auto child = read(depth + 1);
+    if (child->isParameterized()) {
+      fail("parameterized child {} of a concrete type", child->signature());
+    }
+    return std::static_pointer_cast<const Type>(child);
+  }
+
+  StringLiteralPtr readLiteral(int depth) {
+    auto literal = read(depth + 1);
+    if (!isa<StringLiteral>(*literal)) {
+      fail("expected a literal parameter but got {}", literal->signature());
+    }
+    return std::static_pointer_cast<const StringLiteral>(literal);
+  }
+
+  TypePtr readConcrete(uint8_t tag, TypeKind kind, int depth) {
+    const bool nullable = (tag & kNullableBit) != 0;
+    auto& factory = TypeFactory::instance();
+    switch (kind) {
+      case TypeKind::kDecimal: {
+        const auto precision = readInt();
+        const auto scale = readInt();
+        return factory.decimal(precision, scale, nullable);
+      }
+      case TypeKind::kVarchar:
+        return factory.varchar(readInt(), nullable);
+      case TypeKind::kFixedChar:
+        return factory.fixedChar(readInt(), nullable);
+      case TypeKind::kFixedBinary:
+        return factory.fixedBinary(readInt(), nullable);
+      case TypeKind::kList:
+        return factory.list(readConcreteChild(depth), nullable);
+      case TypeKind::kMap: {
+        auto keyType = readConcreteChild(depth);
+        auto valueType = readConcreteChild(depth);
+        return factory.map(keyType, valueType, nullable);
+      }
+      case TypeKind::kStruct: {
+        const auto count = readCount();
+        std::vector<TypePtr> children;
+        children.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+          children.emplace_back(readConcreteChild(depth));
+        }
+        return factory.structType(children, nullable);
+      }
+      default: {
+        auto scalar = TypeFactory::scalarType(kind, nullable);
+        if (!scalar) {
+          fail("invalid kind {}", static_cast<int>(kind));
+        }
+        return scalar;
+      }
+    }
+  }
+
+  ParameterizedTypePtr
+  readParameterized(uint8_t tag, TypeKind kind, int depth) {
+    const bool nullable = (tag & kNullableBit) != 0;
+    switch (kind) {
+      case TypeKind::KIND_NOT_SET: {
+        const auto size = readCount();
+        std::string value(reinterpret_cast<const char*>(cursor_), size);
+        cursor_ += size;
+        return std::make_shared<const StringLiteral>(
+            value,
+            (tag & kWildcardBit) != 0,
+            (tag & kPlaceholderBit) != 0);
+      }
+      case TypeKind::kDecimal: {
+        auto precision = readLiteral(depth);
+        auto scale = readLiteral(depth);
+        return std::make_shared<const ParameterizedDecimal>(
+            std::move(precision), std::move(scale), nullable);
+      }
+      case TypeKind::kVarchar:
+        return std::make_shared<const ParameterizedVarchar>(
+            readLiteral(depth), nullable);
+      case TypeKind::kFixedChar:
+        return std::make_shared<const ParameterizedFixedChar>(
+            readLiteral(depth), nullable);
+      case TypeKind::kFixedBinary:
+        return std::make_shared<const ParameterizedFixedBinary>(
+            readLiteral(depth), nullable);
+      case TypeKind::kList:
+        return std::make_shared<const ParameterizedList>(
+            read(depth + 1), nullable);
+      case TypeKind::kMap: {
+        auto keyType = read(depth + 1);
+        auto valueType = read(depth + 1);
+        return std::make_shared<const ParameterizedMap>(
+            std::move(keyType), std::move(valueType), nullable);
+      }
+      case TypeKind::kStruct: {
+        const auto count = readCount();
+        std::vector<ParameterizedTypePtr> children;
+        children.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+          children.emplace_back(read(depth + 1));
+        }
+        return std::make_shared<const ParameterizedStruct>(
+            std::move(children), nullable);
+      }
+      default:
+        fail("invalid parameterized kind {}", static_cast<int>(kind));
+    }
+  }
+
+  const uint8_t*& cursor_;
+  const uint8_t* const end_;
+};
+
+/// Interned types by their encoding, the most recently used ones only. The
+/// encoding of a concrete type is canonical, so a type seen before is found
+/// by a single lookup instead of interning it node by node. Bounded like
+/// TypeDecodeCache, so the encodings of types seen once are not kept.
+class InternedTypes {
+ public:
+  static constexpr size_t kCapacity = 4096;
+
+  static InternedTypes& instance() {
+    // Never destroyed, like the TypeFactory holding the types.
+    static auto* types = new InternedTypes();
+    return *types;
+  }
+
+  TypePtr find(std::string_view bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(bytes);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  void insert(std::string_view bytes, TypePtr type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.count(bytes) != 0) {
+      return;
+    }
+    lru_.emplace_front(std::string(bytes), std::move(type));
+    index_.emplace(lru_.front().first, lru_.begin());
+    if (lru_.size() > kCapacity) {
+      index_.erase(index_.find(lru_.back().first));
+      lru_.pop_back();
+    }
+  }
+
+ private:
+  using Entry = std::pair<std::string, TypePtr>;
+
+  InternedTypes() = default;
+
+  std::mutex mutex_;
+  /// Most recently used entries first.
+  std::list<Entry> lru_;
+  /// Entries of lru_ by their encoding, which the keys view.
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+};
+
+} // namespace
+
+void TypeSerializer::serialize(
+    const ParameterizedType& type,
+    std::string& out) {
+  Writer(out).write(type);
+}
+
+ParameterizedTypePtr TypeSerializer::deserialize(
+    const uint8_t*& cursor,
+    const uint8_t* end) {
+  if (cursor == end || (*cursor & kParameterizedBit) != 0) {
+    return Reader(cursor, end).read(0);
+  }
+  const auto* start = cursor;
+  auto scan = cursor;
+  Reader(scan, end).skip(0);
+  const std::string_view bytes(
+      reinterpret_cast<const char*>(start), scan - start);
+  auto& internedTypes = InternedTypes::instance();
+  if (auto type = internedTypes.find(bytes)) {
+    cursor = scan;
+    return type;
+  }
+  auto type = std::static_pointer_cast<const Type>(Reader(cursor, end).read(0));
+  internedTypes.insert(bytes, type);
+  return type;
+}
+
+ParameterizedTypePtr TypeSerializer::deserialize(std::string_view bytes) {
+  const auto* cursor = reinterpret_cast<const uint8_t*>(bytes.data());
+  const auto* end = cursor + bytes.size();
+  auto type = deserialize(cursor, end);
+  if (cursor != end) {
+    SUBSTRAIT_IVALID_ARGUMENT(
+        "Fail to deserialize type: {} trailing bytes", end - cursor);
+  }
+  return type;
+}
+
+} // namespace io::substrait
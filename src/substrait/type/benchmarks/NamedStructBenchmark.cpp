@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+
+#include "substrait/type/NamedStruct.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+namespace {
+
+std::vector<std::string> makeNames(int64_t width) {
+  std::vector<std::string> names;
+  names.reserve(width);
+  for (int64_t i = 0; i < width; ++i) {
+    names.emplace_back("column_" + std::to_string(i));
+  }
+  return names;
+}
+
+NamedStruct makeSchema(const std::vector<std::string>& names) {
+  const std::vector<TypePtr> types(names.size(), INTEGER());
+  return NamedStruct(names, STRUCT(types));
+}
+
+} // namespace
+
+/// Baseline: a linear scan through a side vector of names.
+static void BM_ScanFieldName(benchmark::State& state) {
+  const auto names = makeNames(state.range(0));
+  size_t next = 0;
+  for (auto _ : state) {
+    const auto& name = names[next];
+    next = (next + 7919) % names.size();
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (names[i] == name) {
+        benchmark::DoNotOptimize(i);
+        break;
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_ScanFieldName)->Arg(16)->Arg(1000);
+
+static void BM_FindField(benchmark::State& state) {
+  const auto names = makeNames(state.range(0));
+  const auto schema = makeSchema(names);
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(schema.findField(names[next]));
+    next = (next + 7919) % names.size();
+  }
+}
+
+BENCHMARK(BM_FindField)->Arg(16)->Arg(1000);
+
+static void BM_FindFieldIgnoreCase(benchmark::State& state) {
+  auto names = makeNames(state.range(0));
+  const auto schema = makeSchema(names);
+  for (auto& name : names) {
+    name[0] = 'C';
+  }
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(schema.findFieldIgnoreCase(names[next]));
+    next = (next + 7919) % names.size();
+  }
+}
+
+BENCHMARK(BM_FindFieldIgnoreCase)->Arg(16)->Arg(1000);
+
+static void BM_BuildSchema(benchmark::State& state) {
+  const auto names = makeNames(state.range(0));
+  const auto type = STRUCT(std::vector<TypePtr>(names.size(), INTEGER()));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(NamedStruct(names, type));
+  }
+}
+
+BENCHMARK(BM_BuildSchema)->Arg(1000);
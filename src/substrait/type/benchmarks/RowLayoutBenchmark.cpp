@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+
+#include "substrait/type/RowLayout.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+namespace {
+
+constexpr size_t kNumRows = 4096;
+
+/// Columns of an i64, i32, decimal, date and string field.
+class Batch {
+ public:
+  Batch() : layout_(*STRUCT(
+                {BIGINT(), INTEGER(), DECIMAL(20, 2), DATE(), STRING()})) {
+    const size_t widths[] = {8, 4, 16, 4};
+    for (size_t field = 0; field < 4; ++field) {
+      auto& column = columns_[field];
+      column.values.resize(kNumRows * widths[field]);
+      for (size_t i = 0; i < column.values.size(); ++i) {
+        column.values[i] = static_cast<uint8_t>(i * 31 + field);
+      }
+    }
+    auto& strings = columns_[4];
+    strings.offsets.push_back(0);
+    for (size_t row = 0; row < kNumRows; ++row) {
+      strings.values.insert(strings.values.end(), row % 24, 'x');
+      strings.offsets.push_back(static_cast<int32_t>(strings.values.size()));
+    }
+    // every seventh i32 is null.
+    columns_[1].validity.assign(kNumRows / 8, 0xff);
+    for (size_t row = 0; row < kNumRows; row += 7) {
+      columns_[1].validity[row / 8] &= ~(1 << (row % 8));
+    }
+    for (const auto& column : columns_) {
+      views_.push_back(column.view());
+    }
+  }
+
+  const RowLayout& layout() const {
+    return layout_;
+  }
+
+  const std::vector<ColumnView>& views() const {
+    return views_;
+  }
+
+ private:
+  RowLayout layout_;
+  ColumnBuffers columns_[5];
+  std::vector<ColumnView> views_;
+};
+
+} // namespace
+
+static void BM_EncodeRows(benchmark::State& state) {
+  const Batch batch;
+  std::vector<uint8_t> rows;
+  std::vector<size_t> rowOffsets;
+  for (auto _ : state) {
+    batch.layout().encode(batch.views(), kNumRows, rows, rowOffsets);
+    benchmark::DoNotOptimize(rows.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+
+BENCHMARK(BM_EncodeRows);
+
+static void BM_DecodeRows(benchmark::State& state) {
+  const Batch batch;
+  std::vector<uint8_t> rows;
+  std::vector<size_t> rowOffsets;
+  batch.layout().encode(batch.views(), kNumRows, rows, rowOffsets);
+  std::vector<const uint8_t*> rowPointers;
+  for (size_t row = 0; row < kNumRows; ++row) {
+    rowPointers.push_back(rows.data() + rowOffsets[row]);
+  }
+  std::vector<ColumnBuffers> columns;
+  for (auto _ : state) {
+    batch.layout().decode(rowPointers.data(), kNumRows, columns);
+    benchmark::DoNotOptimize(columns.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+
+BENCHMARK(BM_DecodeRows);
@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+namespace {
+
+std::vector<TypePtr> makeColumns(int width) {
+  std::vector<TypePtr> columns;
+  columns.reserve(width);
+  for (int i = 0; i < width; ++i) {
+    switch (i % 4) {
+      case 0:
+        columns.emplace_back(BIGINT());
+        break;
+      case 1:
+        columns.emplace_back(DECIMAL(18, 2));
+        break;
+      case 2:
+        columns.emplace_back(VARCHAR(32));
+        break;
+      default:
+        columns.emplace_back(TypeFactory::scalar<TypeKind::kString>(true));
+        break;
+    }
+  }
+  return columns;
+}
+
+void BM_ConstructStruct(benchmark::State& state) {
+  const auto columns = makeColumns(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::make_shared<const Struct>(columns));
+  }
+}
+BENCHMARK(BM_ConstructStruct)->Arg(3)->Arg(10000);
+
+void BM_InternStruct(benchmark::State& state) {
+  const auto columns = makeColumns(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(STRUCT(columns));
+  }
+}
+BENCHMARK(BM_InternStruct)->Arg(3)->Arg(10000);
+
+void BM_MatchStruct(benchmark::State& state) {
+  const auto columns = makeColumns(static_cast<int>(state.range(0)));
+  const auto pattern = std::make_shared<const Struct>(columns);
+  const auto type = std::make_shared<const Struct>(columns);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pattern->isMatch(*type));
+  }
+}
+BENCHMARK(BM_MatchStruct)->Arg(3)->Arg(10000);
+
+void BM_DestroyStruct(benchmark::State& state) {
+  const auto columns = makeColumns(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto type = std::make_shared<const Struct>(columns);
+    state.ResumeTiming();
+    type.reset();
+  }
+}
+BENCHMARK(BM_DestroyStruct)->Arg(10000);
+
+} // namespace
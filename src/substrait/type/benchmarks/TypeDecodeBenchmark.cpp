@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include "substrait/type/TypeDecodeCache.h"
+
+using namespace io::substrait;
+
+namespace {
+
+/// Type strings as they appear in the default extension files.
+const std::vector<std::string> kExtensionTypes = {
+    "i64?",
+    "boolean",
+    "any1",
+    "decimal<P1,S1>",
+    "DECIMAL?<38,S>",
+    "varchar<L1>",
+    "fixedchar<l1>",
+    "timestamp_tz",
+    "interval_year",
+    "list<any1>",
+    "STRUCT<fp64,i64>",
+};
+
+} // namespace
+
+static void BM_DecodeExtensionTypes(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& rawType : kExtensionTypes) {
+      benchmark::DoNotOptimize(ParameterizedType::decode(rawType));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kExtensionTypes.size());
+}
+BENCHMARK(BM_DecodeExtensionTypes);
+
+static void BM_CachedDecodeExtensionTypes(benchmark::State& state) {
+  TypeDecodeCache cache;
+  for (auto _ : state) {
+    for (const auto& rawType : kExtensionTypes) {
+      benchmark::DoNotOptimize(cache.decode(rawType));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kExtensionTypes.size());
+}
+BENCHMARK(BM_CachedDecodeExtensionTypes);
+
+static void BM_DecodeNestedType(benchmark::State& state) {
+  const std::string rawType =
+      "struct<i32,list<decimal<18,2>>,map<string,varchar<10>>,"
+      "struct<i64?,list<struct<fp32,date>>>>";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ParameterizedType::decode(rawType, false));
+  }
+}
+BENCHMARK(BM_DecodeNestedType);
@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include "substrait/type/TypeDerivation.h"
+
+using namespace io::substrait;
+
+namespace {
+
+constexpr const char* kDecimalAdd = R"(
+init_scale = max(S1,S2)
+init_prec = init_scale + max(P1 - S1, P2 - S2) + 1
+min_scale = min(init_scale, 6)
+delta = init_prec - 38
+prec = min(init_prec, 38)
+scale_after_borrow = max(init_scale - delta, min_scale)
+scale = init_prec > 38 ? scale_after_borrow : init_scale
+DECIMAL<prec, scale>)";
+
+void BM_CompileDecimalAdd(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TypeDerivation::compile(kDecimalAdd));
+  }
+}
+BENCHMARK(BM_CompileDecimalAdd);
+
+void BM_EvaluateDecimalAdd(benchmark::State& state) {
+  const auto derivation = TypeDerivation::compile(kDecimalAdd);
+  TypeBindings bindings;
+  bindings.bindValue("P1", 10);
+  bindings.bindValue("S1", 2);
+  bindings.bindValue("P2", 12);
+  bindings.bindValue("S2", 4);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(derivation->evaluate(bindings));
+  }
+}
+BENCHMARK(BM_EvaluateDecimalAdd);
+
+} // namespace
@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+namespace {
+
+std::atomic<int64_t> allocations{0};
+
+/// Report the number of heap allocations per iteration.
+class AllocationCounter {
+ public:
+  explicit AllocationCounter(benchmark::State& state)
+      : state_(state), start_(allocations.load()) {}
+
+  ~AllocationCounter() {
+    state_.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - start_),
+        benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  benchmark::State& state_;
+  const int64_t start_;
+};
+
+std::vector<TypePtr> makeSharedColumns(int width) {
+  std::vector<TypePtr> children;
+  children.reserve(width);
+  for (int i = 0; i < width; ++i) {
+    switch (i % 4) {
+      case 0:
+        children.emplace_back(
+            std::make_shared<const ScalarType<TypeKind::kI64>>(false));
+        break;
+      case 1:
+        children.emplace_back(std::make_shared<const Decimal>(18, 2));
+        break;
+      case 2:
+        children.emplace_back(std::make_shared<const List>(
+            std::make_shared<const ScalarType<TypeKind::kString>>(false)));
+        break;
+      default:
+        children.emplace_back(std::make_shared<const Varchar>(32));
+        break;
+    }
+  }
+  return children;
+}
+
+std::vector<TypePtr> makeInternedColumns(int width) {
+  std::vector<TypePtr> children;
+  children.reserve(width);
+  for (int i = 0; i < width; ++i) {
+    switch (i % 4) {
+      case 0:
+        children.emplace_back(BIGINT());
+        break;
+      case 1:
+        children.emplace_back(DECIMAL(18, 2));
+        break;
+      case 2:
+        children.emplace_back(LIST(STRING()));
+        break;
+      default:
+        children.emplace_back(VARCHAR(32));
+        break;
+    }
+  }
+  return children;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+static void BM_MakeSharedDecimal(benchmark::State& state) {
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::make_shared<const Decimal>(18, 2));
+  }
+}
+BENCHMARK(BM_MakeSharedDecimal);
+
+static void BM_InternedDecimal(benchmark::State& state) {
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DECIMAL(18, 2));
+  }
+}
+BENCHMARK(BM_InternedDecimal);
+
+static void BM_MakeSharedStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::make_shared<const Struct>(makeSharedColumns(width)));
+  }
+}
+BENCHMARK(BM_MakeSharedStruct)->Arg(16)->Arg(1024);
+
+static void BM_InternedStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(STRUCT(makeInternedColumns(width)));
+  }
+}
+BENCHMARK(BM_InternedStruct)->Arg(16)->Arg(1024);
+
+static void BM_MatchMakeSharedStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  const TypePtr left = std::make_shared<const Struct>(makeSharedColumns(width));
+  const TypePtr right =
+      std::make_shared<const Struct>(makeSharedColumns(width));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(left->isMatch(right));
+  }
+}
+BENCHMARK(BM_MatchMakeSharedStruct)->Arg(16)->Arg(1024);
+
+static void BM_MatchInternedStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  const TypePtr left = STRUCT(makeInternedColumns(width));
+  const TypePtr right = STRUCT(makeInternedColumns(width));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(left->isMatch(right));
+  }
+}
+BENCHMARK(BM_MatchInternedStruct)->Arg(16)->Arg(1024);
+
+static void BM_RebuildNullableStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  const auto type = STRUCT(makeInternedColumns(width));
+  auto& factory = TypeFactory::instance();
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(factory.structType(type->childArray(), true));
+  }
+}
+BENCHMARK(BM_RebuildNullableStruct)->Arg(16)->Arg(1024);
+
+static void BM_WithNullableStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  const auto type = STRUCT(makeInternedColumns(width));
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(type->withNullable(true));
+  }
+}
+BENCHMARK(BM_WithNullableStruct)->Arg(16)->Arg(1024);
@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include "substrait/type/Type.h"
+
+using namespace io::substrait;
+
+namespace {
+
+/// Build a nested type without the type factory so that matching cannot
+/// short-circuit on interned pointers.
+TypePtr makeNestedType(int width, int depth) {
+  std::vector<TypePtr> children;
+  children.reserve(width);
+  for (int i = 0; i < width; ++i) {
+    if (depth > 0 && i % 4 == 0) {
+      children.emplace_back(
+          std::make_shared<const List>(makeNestedType(width, depth - 1)));
+    } else if (i % 4 == 1) {
+      children.emplace_back(std::make_shared<const Decimal>(18, 2));
+    } else if (i % 4 == 2) {
+      children.emplace_back(std::make_shared<const Varchar>(32));
+    } else {
+      children.emplace_back(
+          std::make_shared<const ScalarType<TypeKind::kI64>>(false));
+    }
+  }
+  return std::make_shared<const Struct>(std::move(children));
+}
+
+ParameterizedTypePtr makeParameterizedType(int width) {
+  std::vector<ParameterizedTypePtr> children;
+  children.reserve(width);
+  for (int i = 0; i < width; ++i) {
+    if (i % 4 == 0) {
+      children.emplace_back(ParameterizedType::decode("list<any1>"));
+    } else if (i % 4 == 1) {
+      children.emplace_back(ParameterizedType::decode("decimal<P1,S1>"));
+    } else if (i % 4 == 2) {
+      children.emplace_back(ParameterizedType::decode("varchar<L1>"));
+    } else {
+      children.emplace_back(ParameterizedType::decode("i64"));
+    }
+  }
+  return std::make_shared<const ParameterizedStruct>(std::move(children));
+}
+
+} // namespace
+
+static void BM_MatchNestedStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  const auto depth = static_cast<int>(state.range(1));
+  const auto left = makeNestedType(width, depth);
+  const auto right = makeNestedType(width, depth);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(left->isMatch(right));
+  }
+}
+BENCHMARK(BM_MatchNestedStruct)->Args({8, 2})->Args({64, 1})->Args({1024, 0});
+
+static void BM_MatchParameterizedStruct(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  const auto pattern = makeParameterizedType(width);
+  const auto actual = makeNestedType(width, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pattern->isMatch(actual));
+  }
+}
+BENCHMARK(BM_MatchParameterizedStruct)->Arg(8)->Arg(64)->Arg(1024);
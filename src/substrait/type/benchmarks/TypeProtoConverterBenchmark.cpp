@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/arena.h>
+
+#include "substrait/proto/type.pb.h"
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeProtoConverter.h"
+
+using namespace io::substrait;
+
+namespace {
+
+/// list<struct<i64, list<struct<...>>>> nested depth times.
+TypePtr makeDeepType(int64_t depth) {
+  TypePtr type = DECIMAL(20, 4);
+  for (int64_t i = 0; i < depth; ++i) {
+    type = LIST(STRUCT({BIGINT(), type}));
+  }
+  return type;
+}
+
+TypePtr makeWideType(int64_t width) {
+  std::vector<TypePtr> children;
+  children.reserve(width);
+  for (int64_t i = 0; i < width; ++i) {
+    children.emplace_back(i % 2 == 0 ? TypePtr(BIGINT()) : VARCHAR(i % 13));
+  }
+  return STRUCT(children);
+}
+
+void toProto(benchmark::State& state, const TypePtr& type) {
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    benchmark::DoNotOptimize(TypeProtoConverter::toProto(*type, &arena));
+  }
+}
+
+void fromProto(benchmark::State& state, const TypePtr& type) {
+  google::protobuf::Arena arena;
+  const auto* proto = TypeProtoConverter::toProto(*type, &arena);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TypeProtoConverter::fromProto(*proto));
+  }
+}
+
+} // namespace
+
+static void BM_DeepToProto(benchmark::State& state) {
+  toProto(state, makeDeepType(state.range(0)));
+}
+
+BENCHMARK(BM_DeepToProto)->Arg(64);
+
+static void BM_DeepFromProto(benchmark::State& state) {
+  fromProto(state, makeDeepType(state.range(0)));
+}
+
+BENCHMARK(BM_DeepFromProto)->Arg(64);
+
+static void BM_WideToProto(benchmark::State& state) {
+  toProto(state, makeWideType(state.range(0)));
+}
+
+BENCHMARK(BM_WideToProto)->Arg(10000);
+
+static void BM_WideFromProto(benchmark::State& state) {
+  fromProto(state, makeWideType(state.range(0)));
+}
+
+BENCHMARK(BM_WideFromProto)->Arg(10000);
@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include "substrait/type/TypeSerializer.h"
+
+using namespace io::substrait;
+
+namespace {
+
+/// Concrete types as persisted for schemas and resolved function bindings.
+const std::vector<std::string> kConcreteTypes = {
+    "struct<i64,string?,decimal<18,2>,list<varchar<32>>,"
+    "map<string,struct<i32,date,timestamp?>>,fixedbinary<16>>",
+    "decimal<38,10>",
+    "varchar<255>",
+    "list<i64?>",
+};
+
+/// Parameterized types of function declarations.
+const std::vector<std::string> kParameterizedTypes = {
+    "decimal<P1,S1>",
+    "list<any1>",
+    "varchar<L1>",
+    "struct<any1,varchar<L1>,map<any2,decimal?<38,S>>>",
+};
+
+const std::vector<std::string>& typesOf(const benchmark::State& state) {
+  return state.range(0) != 0 ? kParameterizedTypes : kConcreteTypes;
+}
+
+} // namespace
+
+static void BM_DecodeTypeText(benchmark::State& state) {
+  const auto& rawTypes = typesOf(state);
+  const bool parameterized = state.range(0) != 0;
+  for (auto _ : state) {
+    for (const auto& rawType : rawTypes) {
+      benchmark::DoNotOptimize(
+          ParameterizedType::decode(rawType, parameterized));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * rawTypes.size());
+}
+BENCHMARK(BM_DecodeTypeText)->ArgName("parameterized")->Arg(0)->Arg(1);
+
+static void BM_DeserializeType(benchmark::State& state) {
+  const auto& rawTypes = typesOf(state);
+  const bool parameterized = state.range(0) != 0;
+  std::string bytes;
+  for (const auto& rawType : rawTypes) {
+    TypeSerializer::serialize(
+        *ParameterizedType::decode(rawType, parameterized), bytes);
+  }
+  const auto* begin = reinterpret_cast<const uint8_t*>(bytes.data());
+  const auto* end = begin + bytes.size();
+  for (auto _ : state) {
+    // Read the types back to back as from a memory mapped file.
+    for (const auto* cursor = begin; cursor != end;) {
+      benchmark::DoNotOptimize(TypeSerializer::deserialize(cursor, end));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * rawTypes.size());
+}
+BENCHMARK(BM_DeserializeType)->ArgName("parameterized")->Arg(0)->Arg(1);
+
+static void BM_SerializeType(benchmark::State& state) {
+  const auto& rawTypes = typesOf(state);
+  std::vector<ParameterizedTypePtr> types;
+  for (const auto& rawType : rawTypes) {
+    types.push_back(ParameterizedType::decode(rawType, state.range(0) != 0));
+  }
+  std::string bytes;
+  for (auto _ : state) {
+    bytes.clear();
+    for (const auto& type : types) {
+      TypeSerializer::serialize(*type, bytes);
+    }
+    benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * types.size());
+}
+BENCHMARK(BM_SerializeType)->ArgName("parameterized")->Arg(0)->Arg(1);
@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <benchmark/benchmark.h>
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeVisitor.h"
+
+using namespace io::substrait;
+
+namespace {
+
+/// A mix of scalar, parameterized and nested types, nested types last as in
+/// a typical schema.
+std::vector<TypePtr> makeTypes(size_t count) {
+  const std::vector<TypePtr> mix = {
+      INTEGER(),
+      BIGINT(),
+      DOUBLE(),
+      STRING(),
+      DATE(),
+      DECIMAL(18, 2),
+      VARCHAR(32),
+      FIXED_BINARY(16),
+      LIST(BIGINT()),
+      MAP(STRING(), INTEGER()),
+      STRUCT({INTEGER(), STRING()})};
+  std::vector<TypePtr> types;
+  types.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    types.push_back(mix[i % mix.size()]);
+  }
+  return types;
+}
+
+/// Width of a type's parameters or number of children, something which needs
+/// the class of a type.
+int64_t visitWeight(const Type& type) {
+  return visit(
+      type,
+      Overloaded{
+          [](const Decimal& decimal) -> int64_t {
+            return decimal.precision();
+          },
+          [](const Varchar& varchar) -> int64_t { return varchar.length(); },
+          [](const FixedBinary& fixedBinary) -> int64_t {
+            return fixedBinary.length();
+          },
+          [](const List&) -> int64_t { return 1; },
+          [](const Map&) -> int64_t { return 2; },
+          [](const Struct& structType) -> int64_t {
+            return structType.childArray().size();
+          },
+          [](const auto&) -> int64_t { return 0; }});
+}
+
+/// The same as visitWeight as written without a visitor.
+int64_t castChainWeight(const TypePtr& type) {
+  if (auto decimal = std::dynamic_pointer_cast<const Decimal>(type)) {
+    return decimal->precision();
+  }
+  if (auto varchar = std::dynamic_pointer_cast<const Varchar>(type)) {
+    return varchar->length();
+  }
+  if (auto fixedBinary = std::dynamic_pointer_cast<const FixedBinary>(type)) {
+    return fixedBinary->length();
+  }
+  if (std::dynamic_pointer_cast<const List>(type)) {
+    return 1;
+  }
+  if (std::dynamic_pointer_cast<const Map>(type)) {
+    return 2;
+  }
+  if (auto structType = std::dynamic_pointer_cast<const Struct>(type)) {
+    return structType->childArray().size();
+  }
+  return 0;
+}
+
+} // namespace
+
+static void BM_VisitType(benchmark::State& state) {
+  const auto types = makeTypes(state.range(0));
+  for (auto _ : state) {
+    int64_t weight = 0;
+    for (const auto& type : types) {
+      weight += visitWeight(*type);
+    }
+    benchmark::DoNotOptimize(weight);
+  }
+  state.SetItemsProcessed(state.iterations() * types.size());
+}
+BENCHMARK(BM_VisitType)->Arg(1024);
+
+static void BM_CastChainType(benchmark::State& state) {
+  const auto types = makeTypes(state.range(0));
+  for (auto _ : state) {
+    int64_t weight = 0;
+    for (const auto& type : types) {
+      weight += castChainWeight(type);
+    }
+    benchmark::DoNotOptimize(weight);
+  }
+  state.SetItemsProcessed(state.iterations() * types.size());
+}
+BENCHMARK(BM_CastChainType)->Arg(1024);
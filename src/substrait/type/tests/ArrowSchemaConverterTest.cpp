@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/ArrowSchemaConverter.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+using io::substrait::common::SubstraitException;
+
+class ArrowSchemaConverterTest : public ::testing::Test {
+ protected:
+  static TypePtr roundTrip(const TypePtr& type) {
+    ArrowSchema schema;
+    ArrowSchemaConverter::exportType(*type, &schema);
+    auto imported = ArrowSchemaConverter::importType(schema);
+    schema.release(&schema);
+    EXPECT_EQ(schema.release, nullptr);
+    return imported;
+  }
+};
+
+TEST_F(ArrowSchemaConverterTest, roundTrip) {
+  auto& factory = TypeFactory::instance();
+  const std::vector<TypePtr> types = {
+      BOOL(),
+      TypeFactory::scalar<TypeKind::kI8>(true),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      FLOAT(),
+      DOUBLE(),
+      STRING(),
+      BINARY(),
+      TIMESTAMP(),
+      TIMESTAMP_TZ(),
+      DATE(),
+      TIME(),
+      INTERVAL_YEAR(),
+      INTERVAL_DAY(),
+      UUID(),
+      FIXED_BINARY(16),
+      factory.decimal(38, 10, true),
+      DECIMAL(60, 4),
+      LIST(STRUCT({INTEGER(), MAP(STRING(), DECIMAL(10, 2))})),
+      factory.structType(std::vector<TypePtr>{}, true),
+  };
+  for (const auto& type : types) {
+    ASSERT_EQ(roundTrip(type), type) << type->signature();
+  }
+  // Arrow has no character types of a given length.
+  ASSERT_EQ(roundTrip(VARCHAR(10)), STRING());
+  ASSERT_EQ(roundTrip(FIXED_CHAR(3)), STRING());
+}
+
+TEST_F(ArrowSchemaConverterTest, exportType) {
+  ArrowSchema schema;
+  ArrowSchemaConverter::exportType(
+      *TypeFactory::instance().map(STRING(), DECIMAL(12, 2), true), &schema);
+  ASSERT_STREQ(schema.format, "+m");
+  ASSERT_EQ(schema.flags, ARROW_FLAG_NULLABLE);
+  ASSERT_EQ(schema.n_children, 1);
+  const auto* entries = schema.children[0];
+  ASSERT_STREQ(entries->format, "+s");
+  ASSERT_STREQ(entries->name, "entries");
+  ASSERT_EQ(entries->flags, 0);
+  ASSERT_EQ(entries->n_children, 2);
+  ASSERT_STREQ(entries->children[0]->name, "key");
+  ASSERT_STREQ(entries->children[0]->format, "u");
+  ASSERT_STREQ(entries->children[1]->name, "value");
+  ASSERT_STREQ(entries->children[1]->format, "d:12,2");
+  ASSERT_EQ(entries->children[1]->n_children, 0);
+  schema.release(&schema);
+}
+
+TEST_F(ArrowSchemaConverterTest, schema) {
+  const NamedStruct named(
+      {"id", "address", "city", "zip"},
+      STRUCT({BIGINT(), STRUCT({STRING(), INTEGER()})}));
+  ArrowSchema schema;
+  ArrowSchemaConverter::exportSchema(named, &schema);
+  ASSERT_STREQ(schema.format, "+s");
+  ASSERT_EQ(schema.n_children, 2);
+  ASSERT_STREQ(schema.children[0]->name, "id");
+  ASSERT_STREQ(schema.children[1]->name, "address");
+  ASSERT_STREQ(schema.children[1]->children[1]->name, "zip");
+
+  const auto imported = ArrowSchemaConverter::importSchema(schema);
+  ASSERT_EQ(imported.type(), named.type());
+  ASSERT_EQ(imported.names(), named.names());
+  schema.release(&schema);
+
+  ArrowSchemaConverter::exportType(*BIGINT(), &schema);
+  ASSERT_THROW(
+      ArrowSchemaConverter::importSchema(schema), SubstraitException);
+  schema.release(&schema);
+}
+
+TEST_F(ArrowSchemaConverterTest, moveChild) {
+  ArrowSchema schema;
+  ArrowSchemaConverter::exportType(
+      *STRUCT({INTEGER(), LIST(STRING())}), &schema);
+  // Move a child out of the tree and release the tree before the child.
+  ArrowSchema moved = *schema.children[1];
+  schema.children[1]->release = nullptr;
+  schema.release(&schema);
+  ASSERT_STREQ(moved.format, "+l");
+  ASSERT_STREQ(moved.children[0]->format, "u");
+  ASSERT_EQ(ArrowSchemaConverter::importType(moved), LIST(STRING()));
+  moved.release(&moved);
+  ASSERT_EQ(moved.release, nullptr);
+}
+
+TEST_F(ArrowSchemaConverterTest, importUnsupported) {
+  ArrowSchema schema{};
+  schema.format = "+w:4";
+  ASSERT_THROW(ArrowSchemaConverter::importType(schema), SubstraitException);
+  schema.format = "d:12";
+  ASSERT_THROW(ArrowSchemaConverter::importType(schema), SubstraitException);
+  schema.format = "+l";
+  ASSERT_THROW(ArrowSchemaConverter::importType(schema), SubstraitException);
+
+  // the dictionary of a struct schema is no struct.
+  ArrowSchema dictionary{};
+  dictionary.format = "i";
+  schema.format = "+s";
+  schema.dictionary = &dictionary;
+  ASSERT_THROW(ArrowSchemaConverter::importSchema(schema), SubstraitException);
+}
@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/NamedStruct.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+using io::substrait::common::SubstraitException;
+
+class NamedStructTest : public ::testing::Test {
+ protected:
+  // id, address{city, zip}, tags: list<struct{key}>, Id
+  const NamedStruct schema_{
+      {"id", "address", "city", "zip", "tags", "key", "Id"},
+      STRUCT(
+          {BIGINT(),
+           STRUCT({STRING(), INTEGER()}),
+           LIST(STRUCT({STRING()})),
+           STRING()})};
+};
+
+TEST_F(NamedStructTest, findField) {
+  ASSERT_EQ(schema_.size(), 4);
+  ASSERT_EQ(schema_.nameAt(0), "id");
+  ASSERT_EQ(schema_.nameAt(1), "address");
+  ASSERT_EQ(schema_.nameAt(3), "Id");
+  ASSERT_EQ(schema_.findField("id"), 0);
+  ASSERT_EQ(schema_.findField("Id"), 3);
+  ASSERT_EQ(schema_.findField("tags"), 2);
+  ASSERT_EQ(schema_.findField("city"), std::nullopt);
+  ASSERT_EQ(schema_.findField("missing"), std::nullopt);
+  ASSERT_THROW((void)schema_.nameAt(4), SubstraitException);
+}
+
+TEST_F(NamedStructTest, names) {
+  const std::vector<std::string_view> expected = {
+      "id", "address", "city", "zip", "tags", "key", "Id"};
+  ASSERT_EQ(schema_.names(), expected);
+}
+
+TEST_F(NamedStructTest, findFieldIgnoreCase) {
+  ASSERT_EQ(schema_.findFieldIgnoreCase("ADDRESS"), 1);
+  ASSERT_EQ(schema_.findFieldIgnoreCase("Tags"), 2);
+  // "id" and "Id" are ambiguous ignoring case.
+  ASSERT_EQ(schema_.findFieldIgnoreCase("ID"), std::nullopt);
+  ASSERT_EQ(schema_.findFieldIgnoreCase("id"), std::nullopt);
+}
+
+TEST_F(NamedStructTest, resolvePath) {
+  using Path = std::vector<size_t>;
+  ASSERT_EQ(schema_.resolvePath("id"), Path{0});
+  ASSERT_EQ(schema_.resolvePath("address.zip"), (Path{1, 1}));
+  ASSERT_EQ(schema_.resolvePath("Address.City", true), (Path{1, 0}));
+  ASSERT_EQ(schema_.resolvePath("Address.City"), std::nullopt);
+  ASSERT_EQ(schema_.resolvePath("address.country"), std::nullopt);
+  // only direct struct fields are addressable.
+  ASSERT_EQ(schema_.resolvePath("tags.key"), std::nullopt);
+  ASSERT_EQ(schema_.resolvePath("id.x"), std::nullopt);
+  ASSERT_EQ(schema_.resolvePath("address."), std::nullopt);
+}
+
+TEST_F(NamedStructTest, invalidNames) {
+  const auto type = STRUCT({BIGINT(), STRUCT({STRING()})});
+  ASSERT_THROW(NamedStruct({"a", "b"}, type), SubstraitException);
+  ASSERT_THROW(NamedStruct({"a", "b", "c", "d"}, type), SubstraitException);
+  ASSERT_THROW(NamedStruct({"a", "a", "c"}, type), SubstraitException);
+  // the same name in different structs is fine.
+  ASSERT_NO_THROW(NamedStruct({"a", "b", "a"}, type));
+}
+
+TEST_F(NamedStructTest, wide) {
+  constexpr int kWidth = 10000;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (int i = 0; i < kWidth; ++i) {
+    names.emplace_back("column_" + std::to_string(i));
+    types.emplace_back(BIGINT());
+  }
+  const NamedStruct schema(names, STRUCT(types));
+  for (int i = 0; i < kWidth; ++i) {
+    ASSERT_EQ(schema.findField(names[i]), i);
+    ASSERT_EQ(schema.findFieldIgnoreCase("COLUMN_" + std::to_string(i)), i);
+  }
+}
@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/RowLayout.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+using io::substrait::common::SubstraitException;
+
+class RowLayoutTest : public ::testing::Test {
+ protected:
+  template <typename T>
+  static std::vector<uint8_t> bytesOf(const std::vector<T>& values) {
+    std::vector<uint8_t> bytes(values.size() * sizeof(T));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+  }
+
+  template <typename T>
+  static T valueAt(const ColumnBuffers& column, size_t row) {
+    T value;
+    std::memcpy(&value, column.values.data() + row * sizeof(T), sizeof(T));
+    return value;
+  }
+
+  static std::string_view stringAt(const ColumnBuffers& column, size_t row) {
+    return {
+        reinterpret_cast<const char*>(column.values.data()) +
+            column.offsets[row],
+        static_cast<size_t>(column.offsets[row + 1] - column.offsets[row])};
+  }
+};
+
+TEST_F(RowLayoutTest, offsets) {
+  // i8, decimal, string, i32, bool, fixedbinary<3>, i64
+  const RowLayout layout(*STRUCT(
+      {TINYINT(),
+       DECIMAL(20, 2),
+       STRING(),
+       INTEGER(),
+       BOOL(),
+       FIXED_BINARY(3),
+       BIGINT()}));
+  ASSERT_EQ(layout.numFields(), 7);
+  ASSERT_EQ(layout.nullBitmapSize(), 1);
+  ASSERT_EQ(layout.rowAlignment(), 16);
+  // Fields are placed by decreasing alignment behind the bitmap.
+  ASSERT_EQ(layout.fieldOffset(1), 16);
+  ASSERT_EQ(layout.fieldOffset(6), 32);
+  ASSERT_EQ(layout.fieldOffset(2), 40);
+  ASSERT_EQ(layout.fieldOffset(3), 48);
+  ASSERT_EQ(layout.fieldOffset(0), 52);
+  ASSERT_EQ(layout.fieldOffset(4), 53);
+  ASSERT_EQ(layout.fieldOffset(5), 54);
+  ASSERT_EQ(layout.fixedSize(), 64);
+  ASSERT_FALSE(layout.isFixedSize());
+
+  ASSERT_TRUE(RowLayout(*STRUCT({INTEGER(), DATE()})).isFixedSize());
+  ASSERT_THROW(
+      RowLayout(*STRUCT({INTEGER(), LIST(INTEGER())})), SubstraitException);
+}
+
+TEST_F(RowLayoutTest, roundTrip) {
+  const RowLayout layout(*STRUCT({BIGINT(), VARCHAR(10), SMALLINT()}));
+  const std::vector<int64_t> ids = {1, -2, 3};
+  const std::string names = "ab" "" "cdef";
+  const std::vector<int32_t> nameOffsets = {0, 2, 2, 6};
+  const std::vector<int16_t> counts = {7, 8, 9};
+  // the second id and the third count are null.
+  const std::vector<uint8_t> idValidity = {0b101};
+  const std::vector<uint8_t> countValidity = {0b011};
+  const auto idBytes = bytesOf(ids);
+  const auto countBytes = bytesOf(counts);
+  const std::vector<ColumnView> columns = {
+      {idValidity.data(), idBytes.data(), nullptr},
+      {nullptr,
+       reinterpret_cast<const uint8_t*>(names.data()),
+       nameOffsets.data()},
+      {countValidity.data(), countBytes.data(), nullptr}};
+
+  std::vector<uint8_t> rows;
+  std::vector<size_t> rowOffsets;
+  layout.encode(columns, 3, rows, rowOffsets);
+  ASSERT_EQ(rowOffsets.size(), 4);
+  ASSERT_EQ(rowOffsets[1] - rowOffsets[0], layout.fixedSize() + 8);
+  ASSERT_EQ(rowOffsets[2] - rowOffsets[1], layout.fixedSize());
+  ASSERT_EQ(rowOffsets.back(), rows.size());
+  ASSERT_EQ(rows[rowOffsets[1]], 0b001);
+  ASSERT_EQ(rows[rowOffsets[2]], 0b100);
+
+  std::vector<const uint8_t*> rowPointers;
+  for (size_t row = 0; row < 3; ++row) {
+    rowPointers.push_back(rows.data() + rowOffsets[row]);
+  }
+  std::vector<ColumnBuffers> decoded;
+  layout.decode(rowPointers.data(), 3, decoded);
+  ASSERT_EQ(decoded.size(), 3);
+  ASSERT_EQ(decoded[0].validity, idValidity);
+  ASSERT_EQ(valueAt<int64_t>(decoded[0], 0), 1);
+  ASSERT_EQ(valueAt<int64_t>(decoded[0], 2), 3);
+  ASSERT_TRUE(decoded[1].validity.empty());
+  ASSERT_EQ(stringAt(decoded[1], 0), "ab");
+  ASSERT_EQ(stringAt(decoded[1], 1), "");
+  ASSERT_EQ(stringAt(decoded[1], 2), "cdef");
+  ASSERT_EQ(decoded[2].validity, countValidity);
+  ASSERT_EQ(valueAt<int16_t>(decoded[2], 1), 8);
+
+  // Encoding the decoded columns gives the same rows.
+  std::vector<ColumnView> views;
+  for (const auto& column : decoded) {
+    views.push_back(column.view());
+  }
+  std::vector<uint8_t> reencoded;
+  layout.encode(views, 3, reencoded, rowOffsets);
+  ASSERT_EQ(reencoded, rows);
+}
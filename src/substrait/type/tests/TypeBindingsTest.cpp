@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include "substrait/type/TypeBindings.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+class TypeBindingsTest : public ::testing::Test {};
+
+TEST_F(TypeBindingsTest, bind) {
+  TypeBindings bindings;
+  ASSERT_TRUE(bindings.empty());
+  ASSERT_TRUE(bindings.bindType("any1", *INTEGER()));
+  ASSERT_TRUE(bindings.bindType("any1", *INTEGER()));
+  // nullability is not part of a type binding.
+  ASSERT_TRUE(
+      bindings.bindType("any1?", *TypeFactory::scalar<TypeKind::kI32>(true)));
+  ASSERT_FALSE(bindings.bindType("any1", *BIGINT()));
+  ASSERT_TRUE(bindings.bindValue("P1", 10));
+  ASSERT_TRUE(bindings.bindValue("P1", 10));
+  ASSERT_FALSE(bindings.bindValue("P1", 11));
+  // a name is either a type or an integer placeholder.
+  ASSERT_FALSE(bindings.bindValue("any1", 1));
+  ASSERT_FALSE(bindings.bindType("P1", *INTEGER()));
+
+  ASSERT_EQ(bindings.size(), 2);
+  ASSERT_EQ(bindings.findType("any1"), INTEGER().get());
+  ASSERT_EQ(bindings.findValue("P1"), 10);
+  ASSERT_EQ(bindings.findType("P1"), nullptr);
+  ASSERT_FALSE(bindings.findValue("any1").has_value());
+  ASSERT_FALSE(bindings.findValue("S1").has_value());
+
+  bindings.clear();
+  ASSERT_TRUE(bindings.empty());
+  ASSERT_TRUE(bindings.bindValue("P1", 11));
+}
+
+TEST_F(TypeBindingsTest, overflow) {
+  const std::vector<std::string> names = {
+      "L1", "L2", "L3", "L4", "L5", "L6", "L7", "L8", "L9", "L10", "L11"};
+  TypeBindings bindings;
+  for (size_t i = 0; i < names.size(); ++i) {
+    ASSERT_TRUE(bindings.bindValue(names[i], static_cast<int64_t>(i)));
+  }
+  ASSERT_EQ(bindings.size(), names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    ASSERT_EQ(bindings.findValue(names[i]), static_cast<int64_t>(i));
+    ASSERT_FALSE(bindings.bindValue(names[i], -1));
+  }
+}
+
+TEST_F(TypeBindingsTest, isMatch) {
+  TypeBindings bindings;
+  const auto decimal = ParameterizedType::decode("decimal<P1,S1>");
+  ASSERT_TRUE(decimal->isMatch(*DECIMAL(10, 2), bindings));
+  ASSERT_EQ(bindings.findValue("P1"), 10);
+  ASSERT_EQ(bindings.findValue("S1"), 2);
+  ASSERT_TRUE(decimal->isMatch(*DECIMAL(10, 2), bindings));
+  ASSERT_FALSE(decimal->isMatch(*DECIMAL(10, 3), bindings));
+
+  bindings.clear();
+  const auto pair = ParameterizedType::decode("struct<any1,list<any1>>");
+  ASSERT_TRUE(pair->isMatch(*STRUCT({STRING(), LIST(STRING())}), bindings));
+  ASSERT_EQ(bindings.findType("any1"), STRING().get());
+  bindings.clear();
+  ASSERT_FALSE(pair->isMatch(*STRUCT({STRING(), LIST(INTEGER())}), bindings));
+  // without bindings every wildcard matches independently.
+  ASSERT_TRUE(pair->isMatch(*STRUCT({STRING(), LIST(INTEGER())})));
+
+  // plain any does not bind.
+  bindings.clear();
+  const auto anyPair = ParameterizedType::decode("struct<any,any>");
+  ASSERT_TRUE(anyPair->isMatch(*STRUCT({STRING(), INTEGER()}), bindings));
+  ASSERT_TRUE(bindings.empty());
+
+  // bindings borrow the placeholder names of the declaration.
+  bindings.clear();
+  const auto varchar = ParameterizedType::decode("varchar<L1>");
+  ASSERT_TRUE(varchar->isMatch(*VARCHAR(5), bindings));
+  ASSERT_EQ(bindings.findValue("L1"), 5);
+
+  // integer literals must be equal.
+  ASSERT_TRUE(ParameterizedType::decode("decimal<38,S1>")
+                  ->isMatch(*DECIMAL(38, 2)));
+  ASSERT_FALSE(ParameterizedType::decode("decimal<38,S1>")
+                   ->isMatch(*DECIMAL(18, 2)));
+}
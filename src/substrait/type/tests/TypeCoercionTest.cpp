@@ -0,0 +1,103 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include "substrait/type/TypeCoercion.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+// the matrix is closed transitively at compile time.
+static_assert(implicitCastCost(TypeKind::kI8, TypeKind::kI8) == 0);
+static_assert(implicitCastCost(TypeKind::kI8, TypeKind::kI64) == 3);
+static_assert(implicitCastCost(TypeKind::kI32, TypeKind::kFp64) == 4);
+static_assert(implicitCastCost(TypeKind::kFixedChar, TypeKind::kString) == 2);
+static_assert(
+    implicitCastCost(TypeKind::kI64, TypeKind::kI32) == kNoImplicitCast);
+static_assert(
+    implicitCastCost(TypeKind::kFp64, TypeKind::kDecimal) == kNoImplicitCast);
+
+class TypeCoercionTest : public ::testing::Test {
+ protected:
+  static std::string join(const TypePtr& left, const TypePtr& right) {
+    const auto joined = TypeCoercion::commonSupertype(*left, *right);
+    return joined ? joined->signature() : "";
+  }
+};
+
+TEST_F(TypeCoercionTest, cost) {
+  ASSERT_EQ(TypeCoercion::cost(*INTEGER(), *INTEGER()), 0);
+  ASSERT_EQ(TypeCoercion::cost(*INTEGER(), *BIGINT()), 1);
+  ASSERT_EQ(TypeCoercion::cost(*TINYINT(), *DOUBLE()), 5);
+  ASSERT_FALSE(TypeCoercion::cost(*BIGINT(), *INTEGER()).has_value());
+  ASSERT_FALSE(TypeCoercion::cost(*STRING(), *VARCHAR(10)).has_value());
+
+  // integers need room for all of their digits.
+  ASSERT_EQ(TypeCoercion::cost(*INTEGER(), *DECIMAL(10, 0)), 3);
+  ASSERT_EQ(TypeCoercion::cost(*INTEGER(), *DECIMAL(12, 2)), 4);
+  ASSERT_FALSE(TypeCoercion::cost(*INTEGER(), *DECIMAL(9, 0)).has_value());
+
+  // decimals widen without losing integral or fractional digits.
+  ASSERT_EQ(TypeCoercion::cost(*DECIMAL(10, 2), *DECIMAL(10, 2)), 0);
+  ASSERT_EQ(TypeCoercion::cost(*DECIMAL(10, 2), *DECIMAL(12, 4)), 1);
+  ASSERT_FALSE(TypeCoercion::cost(*DECIMAL(10, 2), *DECIMAL(10, 3)));
+
+  ASSERT_EQ(TypeCoercion::cost(*VARCHAR(10), *VARCHAR(20)), 1);
+  ASSERT_FALSE(TypeCoercion::cost(*VARCHAR(20), *VARCHAR(10)).has_value());
+  ASSERT_EQ(TypeCoercion::cost(*FIXED_CHAR(10), *VARCHAR(10)), 1);
+  ASSERT_FALSE(TypeCoercion::cost(*FIXED_CHAR(10), *FIXED_CHAR(20)));
+
+  ASSERT_EQ(TypeCoercion::cost(*LIST(INTEGER()), *LIST(BIGINT())), 1);
+  ASSERT_EQ(
+      TypeCoercion::cost(
+          *STRUCT({INTEGER(), DATE()}), *STRUCT({BIGINT(), TIMESTAMP()})),
+      2);
+  ASSERT_FALSE(TypeCoercion::cost(*LIST(BIGINT()), *LIST(INTEGER())));
+}
+
+TEST_F(TypeCoercionTest, nullability) {
+  const auto nullableInteger = TypeFactory::scalar<TypeKind::kI32>(true);
+  const auto nullableBigint = TypeFactory::scalar<TypeKind::kI64>(true);
+  ASSERT_EQ(TypeCoercion::cost(*INTEGER(), *nullableBigint), 1);
+  ASSERT_FALSE(TypeCoercion::cost(*nullableInteger, *BIGINT()).has_value());
+  const auto joined =
+      TypeCoercion::commonSupertype(*nullableInteger, *BIGINT());
+  ASSERT_EQ(joined.get(), nullableBigint.get());
+}
+
+TEST_F(TypeCoercionTest, commonSupertype) {
+  ASSERT_EQ(join(INTEGER(), INTEGER()), INTEGER()->signature());
+  ASSERT_EQ(join(INTEGER(), BIGINT()), BIGINT()->signature());
+  ASSERT_EQ(join(TINYINT(), SMALLINT()), SMALLINT()->signature());
+  ASSERT_EQ(join(FLOAT(), BIGINT()), DOUBLE()->signature());
+  ASSERT_EQ(join(DATE(), TIMESTAMP()), TIMESTAMP()->signature());
+  ASSERT_EQ(join(DECIMAL(10, 2), DECIMAL(6, 4)), DECIMAL(12, 4)->signature());
+  ASSERT_EQ(join(INTEGER(), DECIMAL(5, 2)), DECIMAL(12, 2)->signature());
+  ASSERT_EQ(join(FIXED_CHAR(5), VARCHAR(3)), VARCHAR(5)->signature());
+  ASSERT_EQ(join(VARCHAR(5), STRING()), STRING()->signature());
+  ASSERT_EQ(
+      join(LIST(TINYINT()), LIST(INTEGER())), LIST(INTEGER())->signature());
+  ASSERT_EQ(join(FIXED_CHAR(5), FIXED_CHAR(6)), VARCHAR(6)->signature());
+  ASSERT_EQ(join(FIXED_BINARY(5), FIXED_BINARY(6)), BINARY()->signature());
+
+  ASSERT_EQ(join(BOOL(), INTEGER()), "");
+  ASSERT_EQ(join(DECIMAL(38, 0), DECIMAL(38, 38)), "");
+}
+
+TEST_F(TypeCoercionTest, supertypes) {
+  std::vector<std::string> signatures;
+  std::vector<int> costs;
+  for (const auto& [type, cost] : TypeCoercion::supertypes(*SMALLINT())) {
+    signatures.push_back(type->signature());
+    costs.push_back(cost);
+  }
+  ASSERT_EQ(
+      signatures,
+      std::vector<std::string>(
+          {SMALLINT()->signature(),
+           INTEGER()->signature(),
+           BIGINT()->signature(),
+           FLOAT()->signature(),
+           DOUBLE()->signature(),
+           DECIMAL(5, 0)->signature()}));
+  ASSERT_EQ(costs, std::vector<int>({0, 1, 2, 3, 4, 4}));
+}
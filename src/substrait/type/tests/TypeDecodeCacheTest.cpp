@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include "substrait/type/TypeDecodeCache.h"
+
+using namespace io::substrait;
+
+class TypeDecodeCacheTest : public ::testing::Test {};
+
+TEST_F(TypeDecodeCacheTest, memoize) {
+  TypeDecodeCache cache;
+  const auto& first = cache.decode("decimal<P1,S1>");
+  ASSERT_EQ(first->signature(), "dec<P1,S1>");
+  ASSERT_EQ(cache.decode("decimal<P1,S1>"), first);
+  ASSERT_EQ(cache.hits(), 1);
+  ASSERT_EQ(cache.misses(), 1);
+  ASSERT_EQ(cache.size(), 1);
+
+  // The isParameterized flag is part of the key.
+  const auto& concrete = cache.decode("list<i32>", false);
+  ASSERT_TRUE(isa<List>(*concrete));
+  ASSERT_TRUE(isa<ParameterizedList>(*cache.decode("list<i32>", true)));
+  ASSERT_EQ(cache.size(), 3);
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_EQ(cache.hits(), 0);
+  ASSERT_EQ(cache.misses(), 0);
+}
+
+TEST_F(TypeDecodeCacheTest, decodeError) {
+  TypeDecodeCache cache;
+  ASSERT_ANY_THROW(cache.decode("decimal<P1,S1>", false));
+  ASSERT_EQ(cache.size(), 0);
+}
+
+TEST_F(TypeDecodeCacheTest, bounded) {
+  TypeDecodeCache cache(2, 1);
+  const auto& i32 = cache.decode("i32");
+  cache.decode("i64");
+  // Touch i32 so that i64 is the least recently used entry.
+  ASSERT_EQ(cache.decode("i32"), i32);
+  cache.decode("fp32");
+  ASSERT_EQ(cache.size(), 2);
+
+  cache.decode("i32");
+  ASSERT_EQ(cache.hits(), 2);
+  cache.decode("i64");
+  ASSERT_EQ(cache.misses(), 4);
+  ASSERT_EQ(cache.size(), 2);
+}
+
+TEST_F(TypeDecodeCacheTest, concurrent) {
+  TypeDecodeCache cache(64);
+  const std::vector<std::string> rawTypes = {
+      "i64?", "decimal<P1,S1>", "any1", "varchar<L1>", "list<any1>"};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 1000; ++j) {
+        const auto& rawType = rawTypes[j % rawTypes.size()];
+        ASSERT_NE(cache.decode(rawType), nullptr);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(cache.hits() + cache.misses(), 8000);
+  ASSERT_EQ(cache.size(), rawTypes.size());
+}
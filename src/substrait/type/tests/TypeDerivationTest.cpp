@@ -0,0 +1,150 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include <limits>
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeDerivation.h"
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+class TypeDerivationTest : public ::testing::Test {
+ protected:
+  static constexpr const char* kDecimalAdd = R"(
+    init_scale = max(S1,S2)
+    init_prec = init_scale + max(P1 - S1, P2 - S2) + 1
+    min_scale = min(init_scale, 6)
+    delta = init_prec - 38
+    prec = min(init_prec, 38)
+    scale_after_borrow = max(init_scale - delta, min_scale)
+    scale = init_prec > 38 ? scale_after_borrow : init_scale
+    DECIMAL<prec, scale>)";
+
+  static TypeBindings bindDecimals(int p1, int s1, int p2, int s2) {
+    TypeBindings bindings;
+    bindings.bindValue("P1", p1);
+    bindings.bindValue("S1", s1);
+    bindings.bindValue("P2", p2);
+    bindings.bindValue("S2", s2);
+    return bindings;
+  }
+
+  static TypePtr evaluate(
+      const std::string& expression,
+      const TypeBindings& bindings) {
+    return TypeDerivation::compile(expression)->evaluate(bindings);
+  }
+};
+
+TEST_F(TypeDerivationTest, decimalArithmetic) {
+  const auto add = TypeDerivation::compile(kDecimalAdd);
+  ASSERT_EQ(add->evaluate(bindDecimals(10, 2, 12, 4)), DECIMAL(13, 4));
+  ASSERT_EQ(add->evaluate(bindDecimals(38, 10, 38, 10)), DECIMAL(38, 9));
+  ASSERT_EQ(add->evaluate(bindDecimals(38, 2, 38, 2)), DECIMAL(38, 2));
+}
+
+TEST_F(TypeDerivationTest, singleType) {
+  TypeBindings bindings;
+  bindings.bindValue("S1", 3);
+  ASSERT_EQ(
+      evaluate("DECIMAL<38,S1>?", bindings),
+      TypeFactory::instance().decimal(38, 3, true));
+  ASSERT_EQ(evaluate("i64", bindings), BIGINT());
+  ASSERT_EQ(
+      evaluate("boolean?", bindings),
+      TypeFactory::scalar<TypeKind::kBool>(true));
+  ASSERT_EQ(evaluate("varchar<S1 * 2>", bindings), VARCHAR(6));
+
+  const auto list = LIST(STRING());
+  bindings.bindType("any1", *list);
+  ASSERT_EQ(evaluate("any1", bindings), list);
+}
+
+TEST_F(TypeDerivationTest, nullablePlaceholder) {
+  TypeBindings bindings;
+  bindings.bindType("any1", *INTEGER());
+  ASSERT_EQ(
+      evaluate("any1?", bindings), TypeFactory::scalar<TypeKind::kI32>(true));
+  ASSERT_EQ(evaluate("any1", bindings), INTEGER());
+
+  // a nullable binding stays nullable.
+  const auto nullableList = TypeFactory::instance().list(STRING(), true);
+  bindings.bindType("any2", *nullableList);
+  ASSERT_EQ(evaluate("any2", bindings), nullableList);
+  ASSERT_EQ(evaluate("any2?", bindings), nullableList);
+}
+
+TEST_F(TypeDerivationTest, operators) {
+  TypeBindings bindings;
+  bindings.bindValue("L1", 10);
+  bindings.bindValue("L2", 4);
+  const auto length = [&](const std::string& expression) {
+    return cast<Varchar>(*evaluate(
+                             "result = " + expression + "\nvarchar<result>",
+                             bindings))
+        .length();
+  };
+  ASSERT_EQ(length("L1 + L2 * 2"), 18);
+  ASSERT_EQ(length("(L1 + L2) * 2"), 28);
+  ASSERT_EQ(length("L1 / L2 - 1"), 1);
+  ASSERT_EQ(length("-L2 + L1"), 6);
+  ASSERT_EQ(length("L1 > L2 && L2 >= 4 ? 1 : 2"), 1);
+  ASSERT_EQ(length("L1 < L2 || L2 != 4 ? 1 : 2"), 2);
+  ASSERT_EQ(length("!(L1 == L2) ? L1 <= L2 : 7"), 0);
+  ASSERT_EQ(length("L1 > 5 ? L2 > 5 ? 1 : 2 : 3"), 2);
+  ASSERT_EQ(length("NOT (L1 > 5 AND L2 > 5) ? 8 : 9"), 8);
+  ASSERT_EQ(length("MAX(L1, min(L2, 3))"), 10);
+  // a parenthesized '>' compares inside of type parameters.
+  ASSERT_EQ(evaluate("varchar<(L1 > L2) + 1>", bindings), VARCHAR(2));
+}
+
+TEST_F(TypeDerivationTest, compileError) {
+  ASSERT_THROW(
+      TypeDerivation::compile(""), io::substrait::common::SubstraitException);
+  ASSERT_THROW(
+      TypeDerivation::compile("x = 1 +\ni32"),
+      io::substrait::common::SubstraitException);
+  ASSERT_THROW(
+      TypeDerivation::compile("x = pow(1, 2)\ni32"),
+      io::substrait::common::SubstraitException);
+  ASSERT_THROW(
+      TypeDerivation::compile("list<any1>"),
+      io::substrait::common::SubstraitException);
+  ASSERT_THROW(
+      TypeDerivation::compile("decimal<P1, S1"),
+      io::substrait::common::SubstraitException);
+}
+
+TEST_F(TypeDerivationTest, evaluateError) {
+  TypeBindings bindings;
+  bindings.bindValue("P1", 10);
+  ASSERT_THROW(
+      evaluate("decimal<P1, S1>", bindings),
+      io::substrait::common::SubstraitException);
+  ASSERT_THROW(
+      evaluate("decimal<P1 - 20, 0>", bindings),
+      io::substrait::common::SubstraitException);
+  ASSERT_THROW(
+      evaluate("decimal<P1 / 0, 0>", bindings),
+      io::substrait::common::SubstraitException);
+  ASSERT_THROW(
+      evaluate("any1", bindings), io::substrait::common::SubstraitException);
+
+  // integer overflow is an error.
+  bindings.bindValue("L3", 5);
+  ASSERT_EQ(evaluate("varchar<L3 / -1 + 10>", bindings), VARCHAR(5));
+  ASSERT_EQ(evaluate("varchar<-L3 + 10>", bindings), VARCHAR(5));
+  bindings.bindValue("L1", std::numeric_limits<int64_t>::max());
+  bindings.bindValue("L2", std::numeric_limits<int64_t>::min());
+  for (const auto* expression :
+       {"varchar<L1 + 1>",
+        "varchar<L2 - 1>",
+        "varchar<L1 * 2>",
+        "varchar<L2 / -1>",
+        "varchar<-L2>"}) {
+    ASSERT_THROW(
+        evaluate(expression, bindings),
+        io::substrait::common::SubstraitException)
+        << expression;
+  }
+}
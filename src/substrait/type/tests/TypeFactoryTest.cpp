@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include "substrait/type/TypeFactory.h"
+
+using namespace io::substrait;
+
+class TypeFactoryTest : public ::testing::Test {};
+
+TEST_F(TypeFactoryTest, scalarSingleton) {
+  ASSERT_EQ(BOOL(), BOOL());
+  ASSERT_EQ(BIGINT(), TypeFactory::scalar<TypeKind::kI64>());
+  ASSERT_NE(
+      TypeFactory::scalar<TypeKind::kI64>(true),
+      TypeFactory::scalar<TypeKind::kI64>(false));
+  ASSERT_TRUE(TypeFactory::scalar<TypeKind::kI64>(true)->nullable());
+}
+
+TEST_F(TypeFactoryTest, parameterizedSingleton) {
+  auto& factory = TypeFactory::instance();
+  ASSERT_EQ(DECIMAL(12, 2), DECIMAL(12, 2));
+  ASSERT_NE(DECIMAL(12, 2), DECIMAL(12, 3));
+  ASSERT_NE(factory.decimal(12, 2, true), DECIMAL(12, 2));
+  ASSERT_EQ(VARCHAR(10), factory.varchar(10));
+  ASSERT_NE(VARCHAR(10), VARCHAR(11));
+  ASSERT_EQ(FIXED_CHAR(4), FIXED_CHAR(4));
+  ASSERT_EQ(FIXED_BINARY(4), FIXED_BINARY(4));
+  ASSERT_NE(
+      std::static_pointer_cast<const ParameterizedType>(FIXED_CHAR(4)),
+      std::static_pointer_cast<const ParameterizedType>(FIXED_BINARY(4)));
+}
+
+TEST_F(TypeFactoryTest, nestedSingleton) {
+  auto& factory = TypeFactory::instance();
+  ASSERT_EQ(LIST(INTEGER()), LIST(INTEGER()));
+  ASSERT_NE(LIST(INTEGER()), factory.list(INTEGER(), true));
+  ASSERT_EQ(MAP(STRING(), LIST(DOUBLE())), MAP(STRING(), LIST(DOUBLE())));
+  ASSERT_EQ(
+      STRUCT({BIGINT(), DECIMAL(38, 10), LIST(STRING())}),
+      STRUCT({BIGINT(), DECIMAL(38, 10), LIST(STRING())}));
+  ASSERT_NE(STRUCT({BIGINT(), STRING()}), STRUCT({STRING(), BIGINT()}));
+  ASSERT_NE(STRUCT({BIGINT()}), STRUCT({BIGINT(), BIGINT()}));
+}
+
+TEST_F(TypeFactoryTest, internExternalType) {
+  auto& factory = TypeFactory::instance();
+  // Types built without the factory are canonicalized, children included.
+  TypePtr external = std::make_shared<const Struct>(std::vector<TypePtr>{
+      std::make_shared<const ScalarType<TypeKind::kI32>>(true),
+      std::make_shared<const List>(
+          std::make_shared<const Decimal>(10, 2, false))});
+  auto interned = factory.intern(external);
+  ASSERT_NE(interned, external);
+  ASSERT_EQ(interned, factory.intern(external));
+  ASSERT_EQ(interned->signature(), external->signature());
+
+  const auto& children =
+      std::static_pointer_cast<const Struct>(interned)->children();
+  ASSERT_EQ(children[0], TypeFactory::scalar<TypeKind::kI32>(true));
+  ASSERT_EQ(children[1], LIST(DECIMAL(10, 2)));
+}
+
+TEST_F(TypeFactoryTest, decodeInterned) {
+  ASSERT_EQ(
+      ParameterizedType::decode("i32?"),
+      TypeFactory::scalar<TypeKind::kI32>(true));
+  ASSERT_EQ(
+      ParameterizedType::decode("decimal<10,2>", false), DECIMAL(10, 2));
+  ASSERT_EQ(
+      ParameterizedType::decode("struct<i64,list<varchar<4>>>", false),
+      STRUCT({BIGINT(), LIST(VARCHAR(4))}));
+}
+
+TEST_F(TypeFactoryTest, concurrentIntern) {
+  constexpr int kThreads = 8;
+  std::vector<std::thread> threads;
+  std::vector<TypePtr> results(kThreads);
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&results, i]() {
+      for (int j = 0; j < 100; ++j) {
+        results[i] = STRUCT({DECIMAL(20, j % 5), LIST(VARCHAR(j % 3))});
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& result : results) {
+    ASSERT_EQ(result, results[0]);
+  }
+}
+
+TEST_F(TypeFactoryTest, wideStruct) {
+  std::vector<TypePtr> columns;
+  for (int i = 0; i < 1000; ++i) {
+    columns.emplace_back(i % 2 == 0 ? TypePtr(BIGINT()) : VARCHAR(i % 7));
+  }
+  const auto owned = std::make_shared<Struct>(columns);
+  ASSERT_EQ(owned->childArray().size(), columns.size());
+  ASSERT_FALSE(owned->isInterned());
+  // Interned children are held without a control block.
+  ASSERT_EQ(owned->childArray()[0].use_count(), 0);
+  ASSERT_EQ(owned->childArray().at(999), VARCHAR(999 % 7));
+  ASSERT_THROW((void)owned->childArray().at(1000), std::out_of_range);
+  // the vector of children is built once and matches the array.
+  const std::vector<TypePtr>& children = owned->children();
+  ASSERT_EQ(&children, &owned->children());
+  ASSERT_TRUE(std::equal(
+      children.begin(),
+      children.end(),
+      owned->childArray().begin(),
+      owned->childArray().end()));
+
+  const auto interned = STRUCT(columns);
+  ASSERT_TRUE(interned->isInterned());
+  ASSERT_EQ(interned, TypeFactory::instance().intern(owned));
+  ASSERT_TRUE(interned->isMatch(*owned));
+}
+
+TEST_F(TypeFactoryTest, withNullable) {
+  const auto type = STRUCT({BIGINT(), LIST(VARCHAR(8)), MAP(STRING(), DATE())});
+  ASSERT_EQ(type->withNullable(false), type);
+  ASSERT_EQ(type->asNonNull(), type);
+
+  const auto nullable = type->asNullable();
+  ASSERT_TRUE(nullable->nullable());
+  ASSERT_TRUE(nullable->isEqualIgnoringNullability(*type));
+  ASSERT_EQ(
+      nullable,
+      TypeFactory::instance().structType(
+          {BIGINT(), LIST(VARCHAR(8)), MAP(STRING(), DATE())}, true));
+  // the children are shared with the original.
+  ASSERT_EQ(
+      cast<Struct>(*nullable).children()[1],
+      cast<Struct>(*type).children()[1]);
+  // both variants are linked to each other.
+  ASSERT_EQ(nullable->asNonNull(), type);
+  ASSERT_EQ(type->asNullable(), nullable);
+
+  ASSERT_EQ(INTEGER()->asNullable(), TypeFactory::scalar<TypeKind::kI32>(true));
+  ASSERT_EQ(DECIMAL(18, 2)->asNullable()->asNonNull(), DECIMAL(18, 2));
+
+  // types which are not interned are interned with the given nullability.
+  const auto owned = std::make_shared<const List>(LIST(INTEGER()));
+  ASSERT_EQ(
+      owned->asNullable(), TypeFactory::instance().list(LIST(INTEGER()), true));
+  ASSERT_EQ(owned->asNonNull(), LIST(LIST(INTEGER())));
+}
+
+TEST_F(TypeFactoryTest, capacity) {
+  auto& factory = TypeFactory::instance();
+  const auto interned = STRUCT({DECIMAL(31, 7), LIST(VARCHAR(77))});
+  // Interned types have no control block.
+  ASSERT_EQ(interned.use_count(), 0);
+  ASSERT_TRUE(std::weak_ptr<const Struct>(interned).expired());
+
+  factory.setCapacity(factory.size());
+  const auto owned = STRUCT({DECIMAL(31, 8), LIST(VARCHAR(78))});
+  const auto again = STRUCT({DECIMAL(31, 8), LIST(VARCHAR(78))});
+  const auto nullable = interned->asNullable();
+  factory.setCapacity(std::numeric_limits<size_t>::max());
+
+  // Types beyond the capacity are owned and compared structurally.
+  ASSERT_FALSE(owned->isInterned());
+  ASSERT_GT(owned.use_count(), 0);
+  ASSERT_NE(owned, again);
+  ASSERT_TRUE(owned->isEqual(*again));
+  ASSERT_FALSE(nullable->isInterned());
+  ASSERT_TRUE(nullable->isEqualIgnoringNullability(*interned));
+  // Types interned before stay interned.
+  ASSERT_EQ(interned, STRUCT({DECIMAL(31, 7), LIST(VARCHAR(77))}));
+}
@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include <unordered_set>
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeId.h"
+
+using namespace io::substrait;
+
+class TypeIdTest : public ::testing::Test {
+ protected:
+  static void testRoundTrip(const TypePtr& type) {
+    const auto typeId = TypeId::tryFrom(*type);
+    ASSERT_TRUE(typeId.has_value()) << type->signature();
+    ASSERT_EQ(typeId->kind(), type->kind());
+    ASSERT_EQ(typeId->nullable(), type->nullable());
+    ASSERT_EQ(typeId->toType(), TypeFactory::instance().intern(type));
+    ASSERT_EQ(TypeId::fromValue(typeId->value()), *typeId);
+  }
+};
+
+TEST_F(TypeIdTest, roundTrip) {
+  auto& factory = TypeFactory::instance();
+  testRoundTrip(BOOL());
+  testRoundTrip(TypeFactory::scalar<TypeKind::kI64>(true));
+  testRoundTrip(UUID());
+  testRoundTrip(DECIMAL(38, 10));
+  testRoundTrip(factory.decimal(18, 2, true));
+  testRoundTrip(VARCHAR(std::numeric_limits<int>::max()));
+  testRoundTrip(FIXED_CHAR(4));
+  testRoundTrip(factory.fixedBinary(16, true));
+}
+
+TEST_F(TypeIdTest, unsupported) {
+  ASSERT_FALSE(TypeId::tryFrom(*LIST(INTEGER())).has_value());
+  ASSERT_FALSE(TypeId::tryFrom(*STRUCT({INTEGER()})).has_value());
+  ASSERT_FALSE(TypeId::tryFrom(*MAP(STRING(), INTEGER())).has_value());
+  ASSERT_FALSE(
+      TypeId::tryFrom(*ParameterizedType::decode("decimal<P1,S1>"))
+          .has_value());
+  ASSERT_FALSE(
+      TypeId::tryFrom(*ParameterizedType::decode("any1")).has_value());
+  ASSERT_THROW(TypeId().toType(), io::substrait::common::SubstraitException);
+}
+
+TEST_F(TypeIdTest, packed) {
+  constexpr auto decimal = TypeId::decimal(38, 10, true);
+  static_assert(decimal.kind() == TypeKind::kDecimal);
+  static_assert(decimal.nullable());
+  static_assert(decimal.first() == 38);
+  static_assert(decimal.second() == 10);
+  static_assert(TypeId::varchar(1U << 31).first() == 1U << 31);
+  static_assert(TypeId().kind() == TypeKind::KIND_NOT_SET);
+}
+
+TEST_F(TypeIdTest, isMatch) {
+  const auto i32 = TypeId::scalar(TypeKind::kI32);
+  const auto nullableI32 = TypeId::scalar(TypeKind::kI32, true);
+  ASSERT_TRUE(i32.isMatch(i32));
+  ASSERT_TRUE(nullableI32.isMatch(i32));
+  ASSERT_FALSE(i32.isMatch(nullableI32));
+  ASSERT_FALSE(i32.isMatch(TypeId::scalar(TypeKind::kI64)));
+  ASSERT_TRUE(TypeId::decimal(18, 2).isMatch(TypeId::decimal(18, 2)));
+  ASSERT_FALSE(TypeId::decimal(18, 2).isMatch(TypeId::decimal(18, 3)));
+  ASSERT_FALSE(TypeId::varchar(3).isMatch(TypeId::fixedChar(3)));
+
+  // agrees with the Type hierarchy.
+  const std::vector<TypePtr> types = {
+      INTEGER(),
+      TypeFactory::scalar<TypeKind::kI32>(true),
+      DECIMAL(18, 2),
+      TypeFactory::instance().decimal(18, 2, true),
+      DECIMAL(18, 3),
+      VARCHAR(3),
+      FIXED_CHAR(3)};
+  for (const auto& pattern : types) {
+    for (const auto& type : types) {
+      ASSERT_EQ(
+          TypeId::tryFrom(*pattern)->isMatch(*TypeId::tryFrom(*type)),
+          pattern->isMatch(*type))
+          << pattern->signature() << " " << type->signature();
+    }
+  }
+}
+
+TEST_F(TypeIdTest, hash) {
+  std::unordered_set<TypeId> typeIds;
+  typeIds.insert(TypeId::decimal(18, 2));
+  typeIds.insert(*TypeId::tryFrom(*DECIMAL(18, 2)));
+  typeIds.insert(TypeId::decimal(18, 2, true));
+  typeIds.insert(TypeId::varchar(18));
+  ASSERT_EQ(typeIds.size(), 3);
+  ASSERT_NE(TypeId::varchar(18).hash(), TypeId::fixedChar(18).hash());
+}
@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <google/protobuf/arena.h>
+#include <gtest/gtest.h>
+#include "substrait/common/Exceptions.h"
+#include "substrait/proto/type.pb.h"
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeProtoConverter.h"
+
+using namespace io::substrait;
+using io::substrait::common::SubstraitException;
+
+class TypeProtoConverterTest : public ::testing::Test {
+ protected:
+  static TypePtr roundTrip(const TypePtr& type) {
+    google::protobuf::Arena arena;
+    const auto* proto = TypeProtoConverter::toProto(*type, &arena);
+    EXPECT_EQ(proto->GetArena(), &arena);
+    return TypeProtoConverter::fromProto(*proto);
+  }
+};
+
+TEST_F(TypeProtoConverterTest, roundTrip) {
+  const std::vector<TypePtr> types = {
+      BOOL(),
+      TypeFactory::scalar<TypeKind::kI8>(true),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      FLOAT(),
+      DOUBLE(),
+      STRING(),
+      BINARY(),
+      TIMESTAMP(),
+      TIMESTAMP_TZ(),
+      DATE(),
+      TIME(),
+      INTERVAL_YEAR(),
+      INTERVAL_DAY(),
+      UUID(),
+      FIXED_CHAR(3),
+      VARCHAR(10),
+      FIXED_BINARY(16),
+      TypeFactory::instance().decimal(38, 10, true),
+      LIST(STRUCT({INTEGER(), MAP(STRING(), DECIMAL(10, 2))})),
+      TypeFactory::instance().structType(std::vector<TypePtr>{}, true),
+  };
+  for (const auto& type : types) {
+    // Converted types are interned, so they are compared by pointer.
+    ASSERT_EQ(roundTrip(type), type) << type->signature();
+  }
+}
+
+TEST_F(TypeProtoConverterTest, fromProto) {
+  ::substrait::proto::Type proto;
+  auto* decimal = proto.mutable_decimal();
+  decimal->set_precision(12);
+  decimal->set_scale(4);
+  decimal->set_nullability(::substrait::proto::Type::NULLABILITY_NULLABLE);
+  ASSERT_EQ(
+      TypeProtoConverter::fromProto(proto),
+      TypeFactory::instance().decimal(12, 4, true));
+
+  proto.mutable_i32();
+  ASSERT_EQ(TypeProtoConverter::fromProto(proto), INTEGER());
+
+  proto.set_user_defined_type_reference(1);
+  ASSERT_THROW(TypeProtoConverter::fromProto(proto), SubstraitException);
+  proto.Clear();
+  ASSERT_THROW(TypeProtoConverter::fromProto(proto), SubstraitException);
+}
+
+TEST_F(TypeProtoConverterTest, toProto) {
+  ::substrait::proto::Type proto;
+  proto.mutable_i64();
+  TypeProtoConverter::toProto(
+      *TypeFactory::instance().varchar(20, true), proto);
+  ASSERT_TRUE(proto.has_varchar());
+  ASSERT_EQ(proto.varchar().length(), 20);
+  ASSERT_EQ(
+      proto.varchar().nullability(),
+      ::substrait::proto::Type::NULLABILITY_NULLABLE);
+
+  std::unique_ptr<::substrait::proto::Type> owned(
+      TypeProtoConverter::toProto(*MAP(INTEGER(), BOOL()), nullptr));
+  ASSERT_TRUE(owned->has_map());
+  ASSERT_TRUE(owned->map().key().has_i32());
+  ASSERT_EQ(
+      owned->map().value().bool_().nullability(),
+      ::substrait::proto::Type::NULLABILITY_REQUIRED);
+}
@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include "substrait/common/Exceptions.h"
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeSerializer.h"
+
+using namespace io::substrait;
+using io::substrait::common::SubstraitException;
+
+class TypeSerializerTest : public ::testing::Test {
+ protected:
+  static void testRoundTrip(const ParameterizedTypePtr& type) {
+    const auto bytes = TypeSerializer::serialize(*type);
+    const auto decoded = TypeSerializer::deserialize(bytes);
+    ASSERT_TRUE(decoded->isEqual(*type)) << type->signature();
+    ASSERT_EQ(decoded->signature(), type->signature());
+  }
+
+  static void testMalformed(const std::string& bytes) {
+    ASSERT_THROW(TypeSerializer::deserialize(bytes), SubstraitException);
+  }
+};
+
+TEST_F(TypeSerializerTest, concreteTypes) {
+  auto& factory = TypeFactory::instance();
+  for (const auto& type : std::vector<TypePtr>{
+           BOOL(),
+           TINYINT(),
+           TypeFactory::scalar<TypeKind::kI64>(true),
+           TIMESTAMP_TZ(),
+           UUID(),
+           DECIMAL(38, 10),
+           factory.varchar(100000, true),
+           FIXED_CHAR(1),
+           FIXED_BINARY(16),
+           LIST(factory.decimal(10, 2, true)),
+           factory.map(STRING(), LIST(DATE()), true),
+           STRUCT({}),
+           STRUCT({INTEGER(), STRUCT({STRING(), MAP(BIGINT(), BINARY())})})}) {
+    testRoundTrip(type);
+  }
+
+  // concrete types are decoded to the interned ones.
+  const auto type = STRUCT({INTEGER(), LIST(VARCHAR(10))});
+  ASSERT_EQ(
+      TypeSerializer::deserialize(TypeSerializer::serialize(*type)).get(),
+      type.get());
+}
+
+TEST_F(TypeSerializerTest, parameterizedTypes) {
+  for (const auto* rawType :
+       {"any",
+        "any1?",
+        "P1",
+        "10",
+        "decimal<P1,S1>",
+        "decimal?<38,S>",
+        "varchar<L1>",
+        "fixedchar<L1>",
+        "fixedbinary<L1>",
+        "list<any1>",
+        "map<string,list<any2>>",
+        "struct<i32,decimal<P1,S1>,any1>"}) {
+    testRoundTrip(ParameterizedType::decode(rawType));
+  }
+
+  const auto literal = TypeSerializer::deserialize(
+      TypeSerializer::serialize(*ParameterizedType::decode("P1")));
+  ASSERT_TRUE(literal->isPlaceholder());
+  ASSERT_FALSE(literal->isWildcard());
+}
+
+TEST_F(TypeSerializerTest, compact) {
+  ASSERT_EQ(TypeSerializer::serialize(*INTEGER()).size(), 1);
+  ASSERT_EQ(TypeSerializer::serialize(*DECIMAL(18, 2)).size(), 3);
+  ASSERT_EQ(
+      TypeSerializer::serialize(*STRUCT({INTEGER(), LIST(BIGINT())})).size(),
+      5);
+}
+
+TEST_F(TypeSerializerTest, consecutiveTypes) {
+  std::string bytes;
+  TypeSerializer::serialize(*INTEGER(), bytes);
+  TypeSerializer::serialize(*ParameterizedType::decode("list<any1>"), bytes);
+  TypeSerializer::serialize(*VARCHAR(300), bytes);
+
+  const auto* cursor = reinterpret_cast<const uint8_t*>(bytes.data());
+  const auto* end = cursor + bytes.size();
+  ASSERT_EQ(TypeSerializer::deserialize(cursor, end).get(), INTEGER().get());
+  ASSERT_EQ(
+      TypeSerializer::deserialize(cursor, end)->signature(), "list<any1>");
+  ASSERT_EQ(TypeSerializer::deserialize(cursor, end).get(), VARCHAR(300).get());
+  ASSERT_EQ(cursor, end);
+}
+
+TEST_F(TypeSerializerTest, malformed) {
+  const auto bytes = TypeSerializer::serialize(
+      *STRUCT({INTEGER(), VARCHAR(300), LIST(STRING())}));
+  for (size_t size = 0; size < bytes.size(); ++size) {
+    testMalformed(bytes.substr(0, size));
+  }
+  // trailing bytes.
+  testMalformed(bytes + bytes);
+  // kinds beyond TypeKind.
+  testMalformed(std::string(1, '\x1f'));
+  // a parameterized scalar.
+  testMalformed(std::string(1, '\x44'));
+  // a concrete list of a placeholder.
+  testMalformed("\x16\x40\x02P1");
+  // a struct claiming more children than there are bytes.
+  testMalformed("\x15\xff\x01\x04");
+  // a varint of more than 10 bytes.
+  testMalformed("\x12" + std::string(11, '\xff'));
+  // deep nesting.
+  testMalformed(std::string(1000, '\x16') + '\x04');
+}
+
+TEST_F(TypeSerializerTest, manyConcreteTypes) {
+  // More distinct types than the decoder remembers encodings of.
+  const auto first = LIST(VARCHAR(1));
+  for (int i = 1; i <= 5000; ++i) {
+    const auto type = LIST(VARCHAR(i));
+    ASSERT_EQ(
+        TypeSerializer::deserialize(TypeSerializer::serialize(*type)).get(),
+        type.get());
+  }
+  ASSERT_EQ(
+      TypeSerializer::deserialize(TypeSerializer::serialize(*first)).get(),
+      first.get());
+}
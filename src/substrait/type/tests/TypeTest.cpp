@@ -262,3 +262,182 @@ TEST_F(TypeTest, decodeTest) {
   ASSERT_ANY_THROW(ParameterizedType::decode("varchar<P>", false));
   ASSERT_ANY_THROW(ParameterizedType::decode("fixedchar<P>", false));
 }
+
+TEST_F(TypeTest, kindDispatch) {
+  const auto decimal = DECIMAL(18, 2);
+  ASSERT_TRUE(isa<Decimal>(*decimal));
+  ASSERT_TRUE(isa<Type>(*decimal));
+  ASSERT_FALSE(isa<ParameterizedDecimal>(*decimal));
+  ASSERT_EQ(dynCast<Decimal>(*decimal), decimal.get());
+  ASSERT_EQ(dynCast<Varchar>(*decimal), nullptr);
+
+  const auto parameterized = ParameterizedType::decode("decimal<P1,S1>");
+  ASSERT_TRUE(parameterized->isParameterized());
+  ASSERT_TRUE(isa<ParameterizedDecimal>(*parameterized));
+  ASSERT_FALSE(isa<Decimal>(*parameterized));
+  ASSERT_TRUE(isa<StringLiteral>(*ParameterizedType::decode("any1")));
+}
+
+TEST_F(TypeTest, isMatch) {
+  ASSERT_TRUE(INTEGER()->isMatch(INTEGER()));
+  ASSERT_FALSE(INTEGER()->isMatch(BIGINT()));
+  ASSERT_TRUE(DECIMAL(18, 2)->isMatch(DECIMAL(18, 2)));
+  ASSERT_FALSE(DECIMAL(18, 2)->isMatch(DECIMAL(18, 3)));
+  ASSERT_FALSE(VARCHAR(3)->isMatch(FIXED_CHAR(3)));
+  ASSERT_TRUE(LIST(VARCHAR(3))->isMatch(*LIST(VARCHAR(3))));
+  ASSERT_FALSE(LIST(VARCHAR(3))->isMatch(LIST(VARCHAR(4))));
+  ASSERT_TRUE(MAP(STRING(), DOUBLE())->isMatch(MAP(STRING(), DOUBLE())));
+  ASSERT_FALSE(MAP(STRING(), DOUBLE())->isMatch(MAP(STRING(), FLOAT())));
+
+  // Matching does not rely on interned types.
+  TypePtr nested = std::make_shared<const Struct>(std::vector<TypePtr>{
+      std::make_shared<const List>(std::make_shared<const Decimal>(10, 2)),
+      std::make_shared<const ScalarType<TypeKind::kString>>(false)});
+  ASSERT_TRUE(STRUCT({LIST(DECIMAL(10, 2)), STRING()})->isMatch(nested));
+  ASSERT_FALSE(STRUCT({LIST(DECIMAL(10, 3)), STRING()})->isMatch(nested));
+  ASSERT_FALSE(STRUCT({LIST(DECIMAL(10, 2))})->isMatch(nested));
+
+  const auto& nullableI32 = ParameterizedType::decode("i32?");
+  ASSERT_TRUE(nullableI32->isMatch(INTEGER()));
+  ASSERT_FALSE(INTEGER()->isMatch(nullableI32));
+
+  ASSERT_TRUE(ParameterizedType::decode("any1")->isMatch(nested));
+  ASSERT_TRUE(ParameterizedType::decode("decimal<P1,S1>")
+                  ->isMatch(DECIMAL(38, 10)));
+  ASSERT_FALSE(ParameterizedType::decode("decimal<P1,S1>")->isMatch(DOUBLE()));
+  ASSERT_TRUE(ParameterizedType::decode("varchar<L1>")->isMatch(VARCHAR(3)));
+  ASSERT_TRUE(
+      ParameterizedType::decode("fixedbinary<L1>")->isMatch(FIXED_BINARY(3)));
+  ASSERT_TRUE(ParameterizedType::decode("list<any1>")->isMatch(
+      LIST(STRUCT({BIGINT()}))));
+  ASSERT_TRUE(
+      ParameterizedType::decode("struct<decimal<P,S>,i64>")->isMatch(
+          STRUCT({DECIMAL(38, 0), BIGINT()})));
+  ASSERT_FALSE(
+      ParameterizedType::decode("struct<decimal<P,S>,i64>")->isMatch(
+          STRUCT({DECIMAL(38, 0), INTEGER()})));
+  ASSERT_TRUE(ParameterizedType::decode("map<string,any>")->isMatch(
+      MAP(STRING(), LIST(INTEGER()))));
+}
+
+TEST_F(TypeTest, decodeNullability) {
+  ASSERT_TRUE(ParameterizedType::decode("list<i32>?")->nullable());
+  ASSERT_TRUE(ParameterizedType::decode("LIST?<i32>")->nullable());
+  ASSERT_TRUE(ParameterizedType::decode("DECIMAL?<38,S>")->nullable());
+
+  // Nullability of a nested type does not leak into its parent.
+  auto list = std::dynamic_pointer_cast<const List>(
+      ParameterizedType::decode("list<i32?>", false));
+  ASSERT_NE(list, nullptr);
+  ASSERT_FALSE(list->nullable());
+  ASSERT_TRUE(list->elementType()->nullable());
+
+  ASSERT_EQ(ParameterizedType::decode("any1?")->signature(), "any1?");
+  ASSERT_TRUE(ParameterizedType::decode(" any1? ")->isWildcard());
+}
+
+TEST_F(TypeTest, decodeError) {
+  const auto expectError = [](const std::string& rawType,
+                              const std::string& message) {
+    try {
+      ParameterizedType::decode(rawType);
+      FAIL() << "Expected decode error for " << rawType;
+    } catch (const std::exception& e) {
+      ASSERT_NE(std::string(e.what()).find(message), std::string::npos)
+          << e.what();
+    }
+  };
+  expectError("list<i32>>", "at position 9: unexpected character '>'");
+  expectError("map<i32>", "at position 4: expected 2 type parameters");
+  expectError("struct<i32,>", "at position 11: missing type name");
+  expectError("i32<10>", "Unsupported type: i32 at position 0");
+  expectError("list<foo<i32>>", "Unsupported type: foo at position 5");
+  expectError("decimal<list<i32>,2>", "expected an integer or placeholder");
+  expectError("struct<list<i32", "at position 15: expected '>'");
+  expectError("list<decimal<1,2", "at position 16: expected '>'");
+  std::string deep;
+  for (int i = 0; i < 200000; ++i) {
+    deep += "list<";
+  }
+  expectError(deep + "i32", "types nested deeper than 128 levels");
+  ASSERT_ANY_THROW(ParameterizedType::decode("list<any1>", false));
+}
+
+TEST_F(TypeTest, cachedSignature) {
+  const auto type = ParameterizedType::decode("struct<i32,list<varchar<L1>>>");
+  const auto& signature = type->signature();
+  ASSERT_EQ(signature, "struct<i32,list<vchar<L1>>>");
+  ASSERT_EQ(&type->signature(), &signature);
+}
+
+TEST_F(TypeTest, appendSignature) {
+  fmt::memory_buffer out;
+  const auto type = ParameterizedType::decode(
+      "struct<decimal<P1,10>,map<string,list<fixedchar<L1>>>,any1>");
+  type->appendSignature(out);
+  out.push_back(';');
+  STRUCT({DECIMAL(38, 10), VARCHAR(100000), LIST(FIXED_BINARY(16))})
+      ->appendSignature(out);
+  ASSERT_EQ(
+      fmt::to_string(out),
+      "struct<dec<P1,10>,map<str,list<fchar<L1>>>,any1>;"
+      "struct<dec<38,10>,vchar<100000>,list<fbin<16>>>");
+
+  // a cached signature is appended as is.
+  out.clear();
+  type->appendSignature(out);
+  ASSERT_EQ(fmt::to_string(out), type->signature());
+}
+
+TEST_F(TypeTest, structuralHash) {
+  const auto& decode = [](const std::string& rawType) {
+    return ParameterizedType::decode(rawType);
+  };
+  ASSERT_EQ(decode("decimal<P1,S1>")->hash(), decode("decimal<P1,S1>")->hash());
+  ASSERT_TRUE(decode("decimal<P1,S1>")->isEqual(*decode("DECIMAL<P1,S1>")));
+  ASSERT_FALSE(decode("decimal<P1,S1>")->isEqual(*decode("decimal<P1,S2>")));
+  ASSERT_TRUE(decode("list<any1>")->isEqual(*decode("list<any1>")));
+  ASSERT_FALSE(decode("list<any1>")->isEqual(*decode("list<any2>")));
+
+  // Signatures do not contain nullability, hash and equality do.
+  ASSERT_EQ(
+      decode("list<i32?>")->signature(), decode("list<i32>")->signature());
+  ASSERT_FALSE(decode("list<i32?>")->isEqual(*decode("list<i32>")));
+  ASSERT_NE(decode("list<i32?>")->hash(), decode("list<i32>")->hash());
+
+  // Concrete and parameterized types of the same kind are not equal.
+  ASSERT_FALSE(decode("list<i32>")->isEqual(*LIST(INTEGER())));
+
+  TypePtr external = std::make_shared<const Struct>(std::vector<TypePtr>{
+      std::make_shared<const Decimal>(10, 2),
+      std::make_shared<const ScalarType<TypeKind::kString>>(false)});
+  ASSERT_EQ(external->hash(), STRUCT({DECIMAL(10, 2), STRING()})->hash());
+  ASSERT_TRUE(external->isEqual(*STRUCT({DECIMAL(10, 2), STRING()})));
+
+  std::unordered_map<ParameterizedTypePtr, int, TypeHasher, TypeEqual> types;
+  types.emplace(decode("decimal<P1,S1>"), 1);
+  types.emplace(external, 2);
+  ASSERT_EQ(types.at(decode("decimal<P1,S1>")), 1);
+  ASSERT_EQ(types.at(STRUCT({DECIMAL(10, 2), STRING()})), 2);
+  ASSERT_EQ(types.count(STRUCT({DECIMAL(10, 3), STRING()})), 0);
+}
+
+TEST_F(TypeTest, physicalLayout) {
+  using DecimalTraits = TypeTraits<TypeKind::kDecimal>;
+  static_assert(std::is_same_v<DecimalTraits::NativeType, Int128>);
+  static_assert(DecimalTraits::byteWidth == 16);
+  static_assert(TypeTraits<TypeKind::kDate>::byteWidth == 4);
+  static_assert(typeLayout(TypeKind::kI64).isFixedWidth());
+  static_assert(typeLayout(TypeKind::kFp32).alignment == alignof(float));
+
+  ASSERT_EQ(typeLayout(TypeKind::kBool).byteWidth, 1);
+  ASSERT_EQ(typeLayout(TypeKind::kTimestampTz).byteWidth, 8);
+  ASSERT_EQ(typeLayout(TypeKind::kUuid).byteWidth, 16);
+  ASSERT_EQ(
+      typeLayout(TypeKind::kVarchar).layout, PhysicalLayout::kVariableWidth);
+  ASSERT_EQ(
+      typeLayout(TypeKind::kFixedBinary).layout,
+      PhysicalLayout::kParameterWidth);
+  ASSERT_EQ(typeLayout(TypeKind::kMap).layout, PhysicalLayout::kNested);
+  ASSERT_FALSE(typeLayout(TypeKind::KIND_NOT_SET).isFixedWidth());
+}
@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+#include "substrait/type/TypeFactory.h"
+#include "substrait/type/TypeVisitor.h"
+
+using namespace io::substrait;
+
+class TypeVisitorTest : public ::testing::Test {
+ protected:
+  /// Kind of the class a type is visited as.
+  static TypeKind visitedKind(const ParameterizedType& type) {
+    return visit(
+        type,
+        Overloaded{
+            [](const StringLiteral&) { return TypeKind::KIND_NOT_SET; },
+            [](const auto& visited) {
+              using T = std::decay_t<decltype(visited)>;
+              return T::kKind;
+            }});
+  }
+};
+
+TEST_F(TypeVisitorTest, concreteTypes) {
+  const std::vector<TypePtr> types = {
+      BOOL(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      FLOAT(),
+      DOUBLE(),
+      STRING(),
+      BINARY(),
+      TIMESTAMP(),
+      DATE(),
+      TIME(),
+      INTERVAL_DAY(),
+      INTERVAL_YEAR(),
+      TIMESTAMP_TZ(),
+      UUID(),
+      FIXED_CHAR(3),
+      VARCHAR(3),
+      FIXED_BINARY(3),
+      DECIMAL(10, 2),
+      LIST(BOOL()),
+      MAP(STRING(), BOOL()),
+      STRUCT({BOOL()})};
+  for (const auto& type : types) {
+    ASSERT_EQ(visitedKind(*type), type->kind()) << type->signature();
+  }
+
+  const auto precision = [](const Type& type) {
+    return visit(
+        type,
+        Overloaded{
+            [](const Decimal& decimal) { return decimal.precision(); },
+            [](const auto&) { return 0; }});
+  };
+  ASSERT_EQ(precision(*DECIMAL(10, 2)), 10);
+  ASSERT_EQ(precision(*INTEGER()), 0);
+}
+
+TEST_F(TypeVisitorTest, parameterizedTypes) {
+  for (const auto* rawType :
+       {"any1",
+        "P1",
+        "fixedchar<L1>",
+        "varchar<L1>",
+        "fixedbinary<L1>",
+        "decimal<P1,S1>",
+        "list<any1>",
+        "map<any1,any2>",
+        "struct<any1>"}) {
+    const auto type = ParameterizedType::decode(rawType);
+    ASSERT_TRUE(type->isParameterized()) << rawType;
+    ASSERT_EQ(visitedKind(*type), type->kind()) << rawType;
+  }
+
+  // a concrete type is passed as its concrete class, decimal<10,2> of a
+  // declaration is parameterized though.
+  const auto isConcrete = [](const ParameterizedType& type) {
+    return visit(
+        type,
+        Overloaded{
+            [](const Type&) { return true; },
+            [](const ParameterizedType&) { return false; }});
+  };
+  ASSERT_TRUE(isConcrete(*ParameterizedType::decode("decimal<10,2>", false)));
+  ASSERT_FALSE(isConcrete(*ParameterizedType::decode("decimal<10,2>")));
+}